@@ -0,0 +1,133 @@
+/***********************************************************************
+ * Program:
+ *    Bench Queue
+ * Summary:
+ *    Throughput of handing items from many producer threads to one
+ *    consumer thread: a custom::list guarded by a mutex against the
+ *    lock-free custom::mpsc_queue and custom::bounded_mpsc_queue.
+ *
+ *    This is a stand-alone program and is not part of the unit test
+ *    project. Build it with optimization, for example:
+ *       g++ -std=c++14 -O2 -pthread benchQueue.cpp -o benchQueue
+ * Author
+ *    M Scott O'Connor & Gabe Lytle
+ ************************************************************************/
+
+#include "mpscQueue.h"                 // for MPSC_QUEUE
+#include "../232.05.Lab.100/list.h"    // for LIST
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*************************************************
+ * LOCKED LIST
+ * What we had before: a custom::list behind a mutex
+ *************************************************/
+class LockedList
+{
+public:
+   bool push(int value)
+   {
+      std::lock_guard <std::mutex> guard(mutex);
+      items.push_back(value);
+      return true;
+   }
+   bool pop(int & value)
+   {
+      std::lock_guard <std::mutex> guard(mutex);
+      if (items.empty())
+         return false;
+      value = items.front();
+      items.erase(items.begin());
+      return true;
+   }
+private:
+   std::mutex mutex;
+   custom::list <int> items;
+};
+
+/*************************************************
+ * RUN
+ * Start the producers, drain everything from the
+ * consumer (this thread), and return millions of
+ * items per second.
+ *************************************************/
+template <class Queue>
+double run(Queue & q, int numProducers, int numItems)
+{
+   auto start = std::chrono::steady_clock::now();
+
+   std::vector <std::thread> producers;
+   for (int p = 0; p < numProducers; p++)
+      producers.emplace_back([&q, numItems]()
+      {
+         for (int i = 0; i < numItems; i++)
+            while (!q.push(i))
+               std::this_thread::yield();
+      });
+
+   long long sum = 0;
+   int numPopped = 0;
+   int value;
+   while (numPopped < numProducers * numItems)
+      if (q.pop(value))
+      {
+         sum += value;
+         numPopped++;
+      }
+
+   for (auto & t : producers)
+      t.join();
+
+   std::chrono::duration <double> elapsed = std::chrono::steady_clock::now() - start;
+   if (sum != (long long)numProducers * numItems * (numItems - 1) / 2)
+      std::cerr << "ERROR: lost items\n";
+   return numPopped / elapsed.count() / 1.0e6;
+}
+
+/*************************************************
+ * UNBOUNDED
+ * The unbounded queue's push() never fails; give it
+ * the bool interface the runner expects
+ *************************************************/
+class Unbounded
+{
+public:
+   bool push(int value) { q.push(value); return true; }
+   bool pop(int & value) { return q.pop(value); }
+private:
+   custom::mpsc_queue <int> q;
+};
+
+/**********************************************************************
+ * MAIN
+ * One row per producer count, millions of items per second per queue
+ ***********************************************************************/
+int main()
+{
+   const int numItems = 1000000;
+   int maxProducers = (int)std::thread::hardware_concurrency() - 1;
+   if (maxProducers < 1)
+      maxProducers = 1;
+
+   std::cout << "producers    locked list    mpsc_queue    bounded_mpsc_queue\n";
+   for (int numProducers = 1; numProducers <= maxProducers; numProducers *= 2)
+   {
+      LockedList locked;
+      Unbounded unbounded;
+      custom::bounded_mpsc_queue <int> bounded(1 << 16);
+
+      std::cout << std::setw(9)  << numProducers
+                << std::fixed << std::setprecision(2)
+                << std::setw(15) << run(locked,    numProducers, numItems)
+                << std::setw(14) << run(unbounded, numProducers, numItems)
+                << std::setw(22) << run(bounded,   numProducers, numItems)
+                << "   Mitems/s\n";
+   }
+
+   return 0;
+}
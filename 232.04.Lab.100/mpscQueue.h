@@ -0,0 +1,327 @@
+/***********************************************************************
+ * Header:
+ *    MPSC QUEUE
+ * Summary:
+ *    Lock-free queues with many producer threads and one consumer
+ *    thread. The unbounded queue links nodes just like node.h does,
+ *    but only forward and through an atomic pNext.
+ *
+ *    This will contain the class definition of:
+ *        mpsc_queue         : unbounded, linked (Vyukov intrusive style)
+ *        bounded_mpsc_queue : fixed capacity ring of sequenced cells
+ * Author
+ *    M Scott O'Connor & Gabe Lytle
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>     // for ASSERT
+#include <atomic>      // for std::atomic
+#include <cstddef>     // for size_t
+#include <new>         // for placement new
+#include <utility>     // for std::move and std::forward
+
+class TestMpscQueue;   // forward declaration for unit tests
+
+namespace custom
+{
+
+/**************************************************
+ * MPSC QUEUE
+ * An unbounded multi-producer single-consumer queue.
+ * Producers link a new node onto pHead with one atomic
+ * exchange; the consumer is the only one to touch pTail.
+ * pTail always points to a "stub" node whose data has
+ * already been consumed (or was never set), so the stub
+ * holds no T and T need not be default-constructible.
+ **************************************************/
+template <typename T>
+class mpsc_queue
+{
+   friend class ::TestMpscQueue; // give unit tests access to the privates
+public:
+   //
+   // Construct
+   //
+   mpsc_queue()
+   {
+      pTail = new Node(stub_t());
+      pHead.store(pTail, std::memory_order_relaxed);
+   }
+   mpsc_queue(const mpsc_queue & rhs) = delete;
+   mpsc_queue & operator = (const mpsc_queue & rhs) = delete;
+   ~mpsc_queue()
+   {
+      // the stub is empty; every node after it holds an item
+      Node * pNext = pTail->pNext.load(std::memory_order_relaxed);
+      delete pTail;
+      while (pNext != nullptr)
+      {
+         Node * pDelete = pNext;
+         pNext = pNext->pNext.load(std::memory_order_relaxed);
+         pDelete->value().~T();
+         delete pDelete;
+      }
+   }
+
+   //
+   // Insert: safe to call from any number of threads
+   //
+   void push(const T & t)   { emplace(t);            }
+   void push(      T && t)  { emplace(std::move(t)); }
+   template <class ... Args>
+   void emplace(Args && ... args)
+   {
+      link(new Node(std::forward<Args>(args)...));
+   }
+
+   //
+   // Remove: only the single consumer thread may call these
+   //
+   bool pop(T & t);
+
+   //
+   // Status: only meaningful from the consumer thread
+   //
+   bool empty() const
+   {
+      return pTail->pNext.load(std::memory_order_acquire) == nullptr;
+   }
+
+private:
+   class Node;
+
+   // picks the constructor of the stub, which builds no T
+   struct stub_t {};
+
+   // hook a node onto the producer end of the queue
+   void link(Node * pNew)
+   {
+      Node * pPrev = pHead.exchange(pNew, std::memory_order_acq_rel);
+      pPrev->pNext.store(pNew, std::memory_order_release);
+   }
+
+   std::atomic <Node *> pHead;   // most recently pushed node (producers)
+   Node * pTail;                 // consumed stub node (consumer)
+};
+
+/*************************************************
+ * MPSC QUEUE :: NODE
+ * Just like Node in node.h but with only a forward
+ * link, and that link is atomic so producers can
+ * publish it to the consumer. The data is raw
+ * storage: the stub leaves it empty and every other
+ * node builds its item there in place.
+ *************************************************/
+template <typename T>
+class mpsc_queue <T> ::Node
+{
+public:
+   //
+   // Construct: the stub is tagged so that emplace() with no
+   // arguments still builds a default T in place
+   //
+   Node(stub_t) : pNext(nullptr) {}
+
+   // build the data in place from the constructor arguments of T
+   template <class ... Args>
+   Node(Args && ... args) : pNext(nullptr)
+   {
+      new (data) T(std::forward<Args>(args)...);
+   }
+
+   // the item, once one has been built
+   T & value() { return *reinterpret_cast<T *>(data); }
+
+   //
+   // Data
+   //
+   alignas(T) unsigned char data[sizeof(T)];   // user data
+   std::atomic <Node *> pNext;                  // pointer to next node
+};
+
+/*********************************************
+ * MPSC QUEUE :: POP
+ * Remove the oldest item from the queue. The node
+ * holding it gives up its item and becomes the new
+ * stub, and the old stub is freed.
+ *    INPUT  : where to put the item
+ *    OUTPUT : false if the queue was empty or a producer
+ *             has not yet finished linking its node
+ *    COST   : O(1)
+ *********************************************/
+template <typename T>
+bool mpsc_queue <T> ::pop(T & t)
+{
+   Node * pNext = pTail->pNext.load(std::memory_order_acquire);
+   if (pNext == nullptr)
+      return false;
+
+   t = std::move(pNext->value());
+   pNext->value().~T();
+   delete pTail;
+   pTail = pNext;
+   return true;
+}
+
+/**************************************************
+ * BOUNDED MPSC QUEUE
+ * A fixed capacity multi-producer single-consumer queue.
+ * Each cell carries a sequence number saying whether it
+ * is ready to be written (seq == pos) or read
+ * (seq == pos + 1), so producers only contend on the
+ * enqueue position and never allocate.
+ **************************************************/
+template <typename T>
+class bounded_mpsc_queue
+{
+   friend class ::TestMpscQueue; // give unit tests access to the privates
+public:
+   //
+   // Construct: the capacity is rounded up to a power of two
+   //
+   bounded_mpsc_queue(size_t capacity)
+   {
+      size_t num = 2;
+      while (num < capacity)
+         num <<= 1;
+      mask = num - 1;
+
+      cells = new Cell[num];
+      for (size_t i = 0; i < num; i++)
+         cells[i].seq.store(i, std::memory_order_relaxed);
+
+      posEnqueue.store(0, std::memory_order_relaxed);
+      posDequeue = 0;
+   }
+   bounded_mpsc_queue(const bounded_mpsc_queue & rhs) = delete;
+   bounded_mpsc_queue & operator = (const bounded_mpsc_queue & rhs) = delete;
+   ~bounded_mpsc_queue()
+   {
+      // destroy the items never popped
+      for (size_t pos = posDequeue;
+           cells[pos & mask].seq.load(std::memory_order_relaxed) == pos + 1;
+           pos++)
+         if (cells[pos & mask].full)
+            cells[pos & mask].value().~T();
+      delete [] cells;
+   }
+
+   //
+   // Insert: safe to call from any number of threads
+   //
+   bool push(const T & t)   { return emplace(t);            }
+   bool push(      T && t)  { return emplace(std::move(t)); }
+   template <class ... Args>
+   bool emplace(Args && ... args);
+
+   //
+   // Remove: only the single consumer thread may call this
+   //
+   bool pop(T & t);
+
+   //
+   // Status
+   //
+   size_t capacity() const { return mask + 1; }
+
+private:
+   // one slot in the ring; the item is built in data when the cell
+   // is written and destroyed when it is read. A cell whose T threw
+   // while being built is still handed on, but not full
+   struct Cell
+   {
+      T & value() { return *reinterpret_cast<T *>(data); }
+
+      std::atomic <size_t> seq;                  // which lap of the ring this cell is on
+      bool full;                                 // data holds a T
+      alignas(T) unsigned char data[sizeof(T)];
+   };
+
+   Cell * cells;                      // the ring buffer
+   size_t mask;                       // capacity - 1
+   std::atomic <size_t> posEnqueue;   // next position to claim (producers)
+   size_t posDequeue;                 // next position to read (consumer)
+};
+
+/*********************************************
+ * BOUNDED MPSC QUEUE :: EMPLACE
+ * Claim the next free cell and build the item in it.
+ * The claim cannot be undone once later producers
+ * are past it, so if T's constructor throws the cell
+ * is published empty and pop() steps over it.
+ *    INPUT  : the arguments to T's constructor
+ *    OUTPUT : false if the queue is full
+ *    COST   : O(1) amortized, lock-free
+ *********************************************/
+template <typename T>
+template <class ... Args>
+bool bounded_mpsc_queue <T> ::emplace(Args && ... args)
+{
+   size_t pos = posEnqueue.load(std::memory_order_relaxed);
+   Cell * cell;
+   for (;;)
+   {
+      cell = &cells[pos & mask];
+      size_t seq = cell->seq.load(std::memory_order_acquire);
+      std::ptrdiff_t dif = (std::ptrdiff_t)seq - (std::ptrdiff_t)pos;
+      if (dif == 0)
+      {
+         // the cell is free on this lap: try to claim it
+         if (posEnqueue.compare_exchange_weak(pos, pos + 1,
+                                              std::memory_order_relaxed))
+            break;
+      }
+      else if (dif < 0)
+         return false;   // the consumer has not freed it yet: full
+      else
+         pos = posEnqueue.load(std::memory_order_relaxed);
+   }
+
+   try
+   {
+      new (cell->data) T(std::forward<Args>(args)...);
+   }
+   catch (...)
+   {
+      cell->full = false;
+      cell->seq.store(pos + 1, std::memory_order_release);
+      throw;
+   }
+   cell->full = true;
+   cell->seq.store(pos + 1, std::memory_order_release);
+   return true;
+}
+
+/*********************************************
+ * BOUNDED MPSC QUEUE :: POP
+ * Read the oldest item and hand its cell back to
+ * the producers for the next lap, skipping any cell
+ * left empty by a throwing emplace
+ *    INPUT  : where to put the item
+ *    OUTPUT : false if the queue is empty
+ *    COST   : O(1)
+ *********************************************/
+template <typename T>
+bool bounded_mpsc_queue <T> ::pop(T & t)
+{
+   for (;;)
+   {
+      Cell * cell = &cells[posDequeue & mask];
+      if (cell->seq.load(std::memory_order_acquire) != posDequeue + 1)
+         return false;
+
+      bool full = cell->full;
+      if (full)
+      {
+         t = std::move(cell->value());
+         cell->value().~T();
+      }
+      cell->seq.store(posDequeue + mask + 1, std::memory_order_release);
+      posDequeue++;
+      if (full)
+         return true;
+   }
+}
+
+} // namespace custom
@@ -50,11 +50,19 @@ public:
       pPrev = nullptr;
       pNext = nullptr;
    }
-   Node(      T && data)
+   Node(      T && data) : data(std::move(data))
+   {
+      pPrev = nullptr;
+      pNext = nullptr;
+   }
+
+   // build the data in place from the constructor arguments of T
+   struct Emplace {};
+   template <class ... Args>
+   Node(Emplace, Args && ... args) : data(std::forward<Args>(args)...)
    {
       pPrev = nullptr;
       pNext = nullptr;
-      this->data = std::move(data);
    }
 
    //
@@ -101,6 +109,8 @@ inline Node <T> * copy(const Node <T> * pSource)
  * Assign
  * Copy the values from pSource into pDestination
  * reusing the nodes already created in pDestination if possible.
+ * Extra destination nodes are trimmed and missing ones appended
+ * in a single forward pass, so no recursion is involved.
  *   INPUT  : the list to be copied
  *   OUTPUT : return the new list
  *   COST   : O(n)
@@ -108,51 +118,46 @@ inline Node <T> * copy(const Node <T> * pSource)
 template <class T>
 inline void assign(Node <T> * & pDestination, const Node <T> * pSource)
 {
-   if (pSource == nullptr)
-   {
-      if (pDestination == nullptr)
-         return;
-      else 
-      {
-         clear(pDestination);
-         return;
-      }
-   }
-   else if (pDestination == nullptr)
-   {
-      pDestination = copy(pSource);
-      return;
-   }
-
    const Node <T>* pS = pSource;
    Node <T>* pD = pDestination;
-   Node <T>* pSave = pDestination;
+   Node <T>* pSave = nullptr;     // last destination node that was filled
 
+   // reuse the nodes the two lists have in common
    while (pD != nullptr && pS != nullptr)
    {
       pD->data = pS->data;
-      if (pD->pNext == nullptr)
-         pSave = pD;
+      pSave = pD;
       pD = pD->pNext;
       pS = pS->pNext;
    }
-   if (pS == nullptr && pD != nullptr)
-   {
-      if (pD->pNext != nullptr)
-         clear(pD->pNext);
-
-      if (pD->pPrev != nullptr)
-         pD->pPrev->pNext = nullptr;
 
-      delete pD;
-   }
-   else if (pS != nullptr && pD == nullptr)
+   // the source is longer: append the remaining items
+   if (pS != nullptr)
    {
-      pD = copy(pS);
-      pD->pPrev = pSave;
-      pSave->pNext = pD;
+      pD = pSave;
+      for (; pS != nullptr; pS = pS->pNext)
+      {
+         pD = insert(pD, pS->data, true /*after*/);
+         if (pDestination == nullptr)
+            pDestination = pD;
+      }
    }
 
+   // the destination is longer: trim the rest
+   else if (pD != nullptr)
+   {
+      if (pSave != nullptr)
+         pSave->pNext = nullptr;
+      else
+         pDestination = nullptr;
+
+      while (pD != nullptr)
+      {
+         Node <T>* pDelete = pD;
+         pD = pD->pNext;
+         delete pDelete;
+      }
+   }
 }
 
 /***********************************************
@@ -250,6 +255,50 @@ inline Node <T> * insert(Node <T> * pCurrent,
    return newNode;
 }
 
+/**********************************************
+ * EMPLACE
+ * Construct a new node directly from the arguments to T's
+ * constructor and link it into a linked list next to the
+ * current position.
+ *   INPUT   : pCurrent - a pointer to the node next to which
+ *                we will be inserting the new node
+ *             after - whether we will be inserting after
+ *             args - the arguments to T's constructor
+ *   OUTPUT  : return the newly inserted item
+ *   COST    : O(1)
+ **********************************************/
+template <class T, class ... Args>
+inline Node <T> * emplace(Node <T> * pCurrent,
+                          bool after,
+                          Args && ... args)
+{
+   Node <T>* newNode = new Node <T>(typename Node <T>::Emplace(),
+                                    std::forward<Args>(args)...);
+   if (pCurrent == nullptr)
+      return newNode;
+
+   Node <T>* pFar;
+   if (after)
+   {
+      pFar = pCurrent->pNext;
+      newNode->pPrev = pCurrent;
+      newNode->pNext = pFar;
+      pCurrent->pNext = newNode;
+      if (pFar != nullptr)
+         pFar->pPrev = newNode;
+   }
+   else
+   {
+      pFar = pCurrent->pPrev;
+      newNode->pNext = pCurrent;
+      newNode->pPrev = pFar;
+      pCurrent->pPrev = newNode;
+      if (pFar != nullptr)
+         pFar->pNext = newNode;
+   }
+   return newNode;
+}
+
 /******************************************************
  * SIZE
  * Find the size an unsorted linked list.  
@@ -288,7 +337,9 @@ inline std::ostream & operator << (std::ostream & out, const Node <T> * pHead)
 
 /*****************************************************
  * CLEAR
- * Free all the data currently in the linked list
+ * Free all the data currently in the linked list. Both the
+ * nodes before and after pHead are walked with a loop rather
+ * than recursion so very long lists cannot exhaust the stack.
  *   INPUT   : pointer to the head of the linked list
  *   OUTPUT  : pHead set to NULL
  *   COST    : O(n)
@@ -299,20 +350,22 @@ inline void clear(Node <T> * & pHead)
    if (pHead == nullptr)
       return;
 
-   if (pHead->pNext != nullptr)
+   // free everything in front of pHead
+   Node <T>* p = pHead->pPrev;
+   while (p != nullptr)
    {
-      pHead->pNext->pPrev = nullptr;
-      clear(pHead->pNext);
+      Node <T>* pDelete = p;
+      p = p->pPrev;
+      delete pDelete;
    }
 
-   if (pHead->pPrev != nullptr) 
+   // free pHead and everything after it
+   while (pHead != nullptr)
    {
-      pHead->pPrev->pNext = nullptr;
-      clear(pHead->pPrev);
+      Node <T>* pDelete = pHead;
+      pHead = pHead->pNext;
+      delete pDelete;
    }
-
-   delete pHead;
-   pHead = nullptr;
 }
 
 
@@ -0,0 +1,351 @@
+/***********************************************************************
+ * Header:
+ *    TEST MPSC QUEUE
+ * Summary:
+ *    Unit tests for the multi-producer single-consumer queues
+ * Author
+ *    M Scott O'Connor & Gabe Lytle
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "mpscQueue.h"
+#include "unitTest.h"
+#include "spy.h"
+
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+class TestMpscQueue : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Unbounded
+      test_construct_default();
+      test_pop_empty();
+      test_push_order();
+      test_emplace_inPlace();
+      test_emplace_noArguments();
+      test_destructor_standard();
+      test_push_manyProducers();
+
+      // Bounded
+      test_bounded_capacity();
+      test_bounded_emplace_inPlace();
+      test_bounded_emplace_noArguments();
+      test_bounded_emplace_throws();
+      test_bounded_destructor_standard();
+      test_bounded_full();
+      test_bounded_wrap();
+      test_bounded_manyProducers();
+
+      report("MpscQueue");
+   }
+
+   /***************************************
+    * UNBOUNDED
+    ***************************************/
+
+   // a new queue holds only the stub node
+   void test_construct_default()
+   {  // setup
+      // exercise
+      custom::mpsc_queue <int> q;
+      // verify
+      assertUnit(q.pTail != nullptr);
+      assertUnit(q.pHead.load() == q.pTail);
+      assertUnit(q.empty());
+   }  // teardown
+
+   // nothing to pop from an empty queue
+   void test_pop_empty()
+   {  // setup
+      custom::mpsc_queue <int> q;
+      int value = 99;
+      // exercise
+      bool popped = q.pop(value);
+      // verify
+      assertUnit(popped == false);
+      assertUnit(value == 99);
+   }  // teardown
+
+   // items come out in the order they went in
+   void test_push_order()
+   {  // setup
+      custom::mpsc_queue <int> q;
+      int value = 0;
+      // exercise
+      q.push(11);
+      q.push(26);
+      q.push(31);
+      // verify
+      assertUnit(!q.empty());
+      assertUnit(q.pop(value) && value == 11);
+      assertUnit(q.pop(value) && value == 26);
+      assertUnit(q.pop(value) && value == 31);
+      assertUnit(!q.pop(value));
+      assertUnit(q.empty());
+   }  // teardown
+
+   // emplace builds the item directly in the node
+   void test_emplace_inPlace()
+   {  // setup
+      custom::mpsc_queue <Spy> q;
+      Spy::reset();
+      // exercise
+      q.emplace(99);
+      // verify
+      assertUnit(Spy::numNondefault() == 1);  // construct [99] in place
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numAssign() == 0);
+      Spy s;
+      assertUnit(q.pop(s));
+      assertUnit(s == Spy(99));
+   }  // teardown
+
+   // emplace with no arguments builds a default item, not a stub
+   void test_emplace_noArguments()
+   {  // setup
+      custom::mpsc_queue <std::string> q;
+      std::string s("before");
+      // exercise
+      q.emplace();
+      q.emplace(3, 'x');
+      // verify
+      assertUnit(q.pop(s));
+      assertUnit(s.empty());
+      assertUnit(q.pop(s));
+      assertUnit(s == "xxx");
+      assertUnit(q.empty());
+   }  // teardown
+
+   // the destructor frees the items never popped
+   void test_destructor_standard()
+   {  // setup
+      {
+         custom::mpsc_queue <Spy> q;
+         q.push(Spy(11));
+         q.push(Spy(26));
+         q.push(Spy(31));
+         Spy::reset();
+      }  // exercise
+      // verify
+      assertUnit(Spy::numDestructor() == 3);  // [11][26][31]; the stub holds none
+      assertUnit(Spy::numDelete() == 3);      // free [11][26][31]
+   }  // teardown
+
+   // several threads push at once; every item arrives exactly once and
+   // in per-producer order
+   void test_push_manyProducers()
+   {  // setup
+      const int numProducers = 4;
+      const int numItems = 20000;
+      custom::mpsc_queue <int> q;
+      std::vector <std::thread> producers;
+      // exercise
+      for (int p = 0; p < numProducers; p++)
+         producers.emplace_back([&q, p, numItems]()
+         {
+            for (int i = 0; i < numItems; i++)
+               q.push(p * numItems + i);
+         });
+
+      std::vector <int> last(numProducers, -1);
+      bool inOrder = true;
+      int numPopped = 0;
+      while (numPopped < numProducers * numItems)
+      {
+         int value;
+         if (q.pop(value))
+         {
+            int p = value / numItems;
+            inOrder = inOrder && last[p] < value % numItems;
+            last[p] = value % numItems;
+            numPopped++;
+         }
+      }
+      for (auto & t : producers)
+         t.join();
+      // verify
+      assertUnit(inOrder);
+      assertUnit(numPopped == numProducers * numItems);
+      assertUnit(q.empty());
+   }  // teardown
+
+   /***************************************
+    * BOUNDED
+    ***************************************/
+
+   // the capacity is rounded up to a power of two
+   void test_bounded_capacity()
+   {  // setup
+      // exercise
+      custom::bounded_mpsc_queue <int> q(5);
+      // verify
+      assertUnit(q.capacity() == 8);
+      assertUnit(q.mask == 7);
+   }  // teardown
+
+   // the ring holds no items until they are pushed, and emplace builds
+   // each one in its cell
+   void test_bounded_emplace_inPlace()
+   {  // setup
+      Spy::reset();
+      custom::bounded_mpsc_queue <Spy> q(4);
+      assertUnit(Spy::numDefault() == 0);
+      // exercise
+      q.emplace(99);
+      // verify
+      assertUnit(Spy::numNondefault() == 1);  // construct [99] in place
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numAssignMove() == 0);
+      Spy s;
+      assertUnit(q.pop(s));
+      assertUnit(s == Spy(99));
+   }  // teardown
+
+   // emplace with no arguments builds a default item
+   void test_bounded_emplace_noArguments()
+   {  // setup
+      custom::bounded_mpsc_queue <std::string> q(4);
+      std::string s("before");
+      // exercise
+      q.emplace();
+      // verify
+      assertUnit(q.pop(s));
+      assertUnit(s.empty());
+      assertUnit(!q.pop(s));
+   }  // teardown
+
+   // a cell whose item throws while being built is skipped, not stuck
+   void test_bounded_emplace_throws()
+   {  // setup
+      struct Picky
+      {
+         Picky() : value(0) {}
+         Picky(int value) : value(value)
+         {
+            if (value < 0)
+               throw std::invalid_argument("negative");
+         }
+         int value;
+      };
+      custom::bounded_mpsc_queue <Picky> q(4);
+      Picky p;
+      bool thrown = false;
+      q.push(Picky(11));
+      // exercise
+      try
+      {
+         q.emplace(-1);
+      }
+      catch (const std::invalid_argument &)
+      {
+         thrown = true;
+      }
+      q.emplace(26);
+      // verify
+      assertUnit(thrown);
+      assertUnit(q.pop(p));
+      assertUnit(p.value == 11);
+      assertUnit(q.pop(p));
+      assertUnit(p.value == 26);
+      assertUnit(!q.pop(p));
+      for (int i = 0; i < 4; i++)           // the skipped cell is free again
+         assertUnit(q.emplace(31));
+      assertUnit(!q.emplace(31));
+   }  // teardown
+
+   // the destructor frees the items never popped, and only those
+   void test_bounded_destructor_standard()
+   {  // setup
+      {
+         custom::bounded_mpsc_queue <Spy> q(4);
+         Spy s;
+         for (int i = 0; i < 4; i++)
+            q.push(Spy(i + 1));
+         q.pop(s);
+         Spy::reset();
+      }  // exercise
+      // verify
+      assertUnit(Spy::numDestructor() == 4);  // [2][3][4] and s
+      assertUnit(Spy::numDelete() == 4);
+   }  // teardown
+
+   // a full queue refuses new items until one is popped
+   void test_bounded_full()
+   {  // setup
+      custom::bounded_mpsc_queue <int> q(4);
+      int value = 0;
+      // exercise
+      for (int i = 0; i < 4; i++)
+         assertUnit(q.push(i));
+      bool pushedFull = q.push(99);
+      // verify
+      assertUnit(pushedFull == false);
+      assertUnit(q.pop(value) && value == 0);
+      assertUnit(q.push(99));
+   }  // teardown
+
+   // cells are reused lap after lap
+   void test_bounded_wrap()
+   {  // setup
+      custom::bounded_mpsc_queue <int> q(2);
+      int value = 0;
+      bool inOrder = true;
+      // exercise
+      for (int i = 0; i < 100; i++)
+      {
+         inOrder = inOrder && q.push(i);
+         inOrder = inOrder && q.pop(value) && value == i;
+      }
+      // verify
+      assertUnit(inOrder);
+      assertUnit(!q.pop(value));
+   }  // teardown
+
+   // several threads push at once into a small ring
+   void test_bounded_manyProducers()
+   {  // setup
+      const int numProducers = 4;
+      const int numItems = 20000;
+      custom::bounded_mpsc_queue <int> q(64);
+      std::vector <std::thread> producers;
+      // exercise
+      for (int p = 0; p < numProducers; p++)
+         producers.emplace_back([&q, p, numItems]()
+         {
+            for (int i = 0; i < numItems; i++)
+               while (!q.push(p * numItems + i))
+                  std::this_thread::yield();
+         });
+
+      long long sum = 0;
+      int numPopped = 0;
+      while (numPopped < numProducers * numItems)
+      {
+         int value;
+         if (q.pop(value))
+         {
+            sum += value;
+            numPopped++;
+         }
+      }
+      for (auto & t : producers)
+         t.join();
+      // verify
+      long long n = (long long)numProducers * numItems;
+      assertUnit(sum == n * (n - 1) / 2);
+   }  // teardown
+};
+
+#endif // DEBUG
@@ -14,6 +14,7 @@
 
 #include "testSpy.h"        // for the spy unit tests
 #include "testNode.h"       // for the unit tests
+#include "testMpscQueue.h"  // for the queue unit tests
 int Spy::counters[] = {};
 
 /**********************************************************************
@@ -26,6 +27,7 @@ int main()
    // unit tests
    TestSpy().run();
    TestNode().run();
+   TestMpscQueue().run();
 #endif // DEBUG
   
    return 0;
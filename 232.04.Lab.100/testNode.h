@@ -27,6 +27,7 @@ public:
       // Construct
       test_create_default();
       test_create_value();
+      test_create_move();
       test_copy_nullptr();
       test_copy_one();
       test_copy_standard();
@@ -37,6 +38,7 @@ public:
       test_assign_emptyToStandard();
       test_assign_smallToBig();
       test_assign_bigToSmall();
+      test_assign_longToShort();
       test_swap_emptyEmpty();
       test_swap_emptyStandard();
       test_swap_standardEmpty();
@@ -51,6 +53,8 @@ public:
       test_insert_backAfter();
       test_insert_middleBefore();
       test_insert_middleAfter();
+      test_emplace_empty();
+      test_emplace_middleAfter();
 
       //// Remove
       test_remove_nullptr();
@@ -60,6 +64,7 @@ public:
       test_clear_nullptr();
       test_clear_one();
       test_clear_standard();
+      test_clear_long();
 
       //// Status
       test_size_empty();
@@ -121,6 +126,28 @@ public:
       assertEmptyFixture(&n);
    }  // teardown
    
+   // non-default constructor that steals the value
+   void test_create_move()
+   {  // setup
+      Spy s(99);
+      Spy::reset();
+      // exercise
+      Node <Spy> n(std::move(s));
+      // verify
+      assertUnit(Spy::numCopyMove() == 1);   // move 99 into n
+      assertUnit(Spy::numDefault() == 0);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(Spy::numAssignMove() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(Spy::numCopy() == 0);
+      //    +----+
+      //    | 99 |
+      //    +----+
+      assertUnit(n.data == Spy(99));
+      assertUnit(n.pNext == nullptr);
+      assertUnit(n.pPrev == nullptr);
+   }  // teardown
+   
    /***************************************
     * COPY
     ***************************************/
@@ -447,6 +474,40 @@ public:
       teardownStandardFixture(p67);
    }
 
+   // assign a short list onto a very long one, trimming the extra nodes
+   void test_assign_longToShort()
+   {  // setup
+      //     p11      p26      p31
+      //    +----+   +----+   +----+
+      //    | 11 | - | 26 | - | 31 |
+      //    +----+   +----+   +----+
+      Node <int>* p11, * p26, * p31;
+      setupStandardFixture(p11, p26, p31);
+      //    +----+           +----+
+      //    |  0 | - ... -   | N  |
+      //    +----+           +----+
+      Node <int>* pLong = nullptr;
+      Node <int>* pTail = nullptr;
+      for (int i = 0; i < 500000; i++)
+      {
+         pTail = insert(pTail, i, true /*after*/);
+         if (pLong == nullptr)
+            pLong = pTail;
+      }
+      // exercise
+      assign(pLong, p11);
+      // verify
+      //    +----+   +----+   +----+
+      //    | 11 | - | 26 | - | 31 |
+      //    +----+   +----+   +----+
+      assertUnit(size(pLong) == 3);
+      assertStandardFixture(pLong);
+      assertStandardFixture(p11);
+      // teardown
+      teardownStandardFixture(p11);
+      teardownStandardFixture(pLong);
+   }
+
    /***************************************
     * SWAP
     ***************************************/
@@ -1208,6 +1269,75 @@ public:
       delete p31;
    }
   
+   // construct a node in place with nothing to link to
+   void test_emplace_empty()
+   {  // setup
+      Node <Spy>* pReturn = nullptr;
+      Spy::reset();
+      // exercise
+      pReturn = emplace((Node <Spy>*)nullptr, false /*after*/, 99);
+      // verify
+      assertUnit(Spy::numNondefault() == 1);    // construct [99] in place
+      assertUnit(Spy::numAlloc() == 1);         // allocate [99]
+      assertUnit(Spy::numDefault() == 0);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(Spy::numAssignMove() == 0);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      //    +----+
+      //    | 99 |
+      //    +----+
+      assertUnit(pReturn != nullptr);
+      if (pReturn)
+      {
+         assertUnit(pReturn->data == Spy(99));
+         assertUnit(pReturn->pNext == nullptr);
+         assertUnit(pReturn->pPrev == nullptr);
+      }
+      // teardown
+      delete pReturn;
+   }
+
+   // construct a node in place in the middle of the standard fixture
+   void test_emplace_middleAfter()
+   {  // setup
+      //     p11      p26      p31
+      //    +----+   +----+   +----+
+      //    | 11 | - | 26 | - | 31 |
+      //    +----+   +----+   +----+
+      Node <Spy>* p11, * p26, * p31;
+      setupStandardFixture(p11, p26, p31);
+      Node <Spy>* pReturn = nullptr;
+      Spy::reset();
+      // exercise
+      pReturn = emplace(p26, true /*after*/, 99);
+      // verify
+      assertUnit(Spy::numNondefault() == 1);    // construct [99] in place
+      assertUnit(Spy::numAlloc() == 1);         // allocate [99]
+      assertUnit(Spy::numDefault() == 0);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      //      p11       p26    pReturn   p31
+      //     +----+   +----+   +----+   +----+
+      //     | 11 | - | 26 | - | 99 | - | 31 |
+      //     +----+   +----+   +----+   +----+
+      assertUnit(p26->pNext == pReturn);
+      assertUnit(p31->pPrev == pReturn);
+      assertUnit(pReturn != nullptr);
+      if (pReturn)
+      {
+         assertUnit(pReturn->data == Spy(99));
+         assertUnit(pReturn->pPrev == p26);
+         assertUnit(pReturn->pNext == p31);
+      }
+      // teardown
+      delete pReturn;
+      delete p11;
+      delete p26;
+      delete p31;
+   }
+  
    /***************************************
     * FIND
     ***************************************/
@@ -1372,6 +1502,23 @@ public:
    }  // teardown
 
 
+   // clear a list far longer than the stack could recurse through
+   void test_clear_long()
+   {  // setup
+      Node <int>* pHead = nullptr;
+      Node <int>* pTail = nullptr;
+      for (int i = 0; i < 1000000; i++)
+      {
+         pTail = insert(pTail, i, true /*after*/);
+         if (pHead == nullptr)
+            pHead = pTail;
+      }
+      // exercise
+      clear(pTail);
+      // verify
+      assertUnit(pTail == nullptr);
+   }  // teardown
+
    /*************************************************************
     * SETUP STANDARD FIXTURE
     *    +----+   +----+   +----+
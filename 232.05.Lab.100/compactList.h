@@ -0,0 +1,590 @@
+/***********************************************************************
+ * Header:
+ *    COMPACT LIST
+ * Summary:
+ *    A linked list with the same interface as custom::list, but whose
+ *    nodes live side by side in one growable array and refer to each
+ *    other by 32-bit index rather than by pointer. For small T this
+ *    cuts the per-element overhead from two pointers plus a heap block
+ *    to two 32-bit indices, and walking the list stays inside one
+ *    allocation.
+ *
+ *    This will contain the class definition of:
+ *        compact_list           : A class that represents a compact list
+ *        compact_list::iterator : An iterator through compact_list
+ * Author
+ *    M Scott O'Connor & Gabe Lytle
+ ************************************************************************/
+
+#pragma once
+#include <cassert>     // for ASSERT
+#include <cstdint>     // for uint32_t
+#include <initializer_list>
+#include <new>         // for placement new
+#include <utility>     // for std::move and std::forward
+
+class TestCompactList;   // forward declaration for unit tests
+
+namespace custom
+{
+
+   /**************************************************
+    * COMPACT LIST
+    * Just like std::list, but index linked
+    **************************************************/
+   template <typename T>
+   class compact_list
+   {
+      friend class ::TestCompactList; // give unit tests access to the privates
+   public:
+      //
+      // Construct
+      //
+
+      compact_list();
+      compact_list(const compact_list <T>& rhs);
+      compact_list(compact_list <T>&& rhs);
+      compact_list(size_t num, const T& t);
+      compact_list(size_t num);
+      compact_list(const std::initializer_list<T>& il);
+      template <class Iterator>
+      compact_list(Iterator first, Iterator last);
+      ~compact_list();
+
+      //
+      // Assign
+      //
+
+      compact_list <T>& operator = (const compact_list& rhs);
+      compact_list <T>& operator = (compact_list&& rhs);
+      compact_list <T>& operator = (const std::initializer_list<T>& il);
+      void swap(compact_list <T>& rhs);
+
+      //
+      // Iterator
+      //
+
+      class  iterator;
+      iterator begin()  { return iterator(this, iHead); }
+      iterator rbegin() { return iterator(this, iTail); }
+      iterator end()    { return iterator(this, NIL);   }
+
+      //
+      // Access
+      //
+
+      T& front();
+      T& back();
+
+      //
+      // Insert
+      //
+
+      void push_front(const T& data) { emplace_front(data);            }
+      void push_front(T&& data)      { emplace_front(std::move(data)); }
+      void push_back(const T& data)  { emplace_back(data);             }
+      void push_back(T&& data)       { emplace_back(std::move(data));  }
+      iterator insert(iterator it, const T& data) { return emplace(it, data);            }
+      iterator insert(iterator it, T&& data)      { return emplace(it, std::move(data)); }
+      template <class ... Args>
+      void emplace_front(Args&& ... args) { emplace(begin(), std::forward<Args>(args)...); }
+      template <class ... Args>
+      void emplace_back(Args&& ... args)  { emplace(end(), std::forward<Args>(args)...);   }
+      template <class ... Args>
+      iterator emplace(iterator it, Args&& ... args);
+
+      //
+      // Remove
+      //
+
+      void pop_back();
+      void pop_front();
+      void clear();
+      iterator erase(const iterator& it);
+
+      //
+      // Status
+      //
+
+      bool empty()  const { return numElements == 0; }
+      size_t size() const { return numElements; }
+      size_t capacity() const { return numCapacity; }
+
+   private:
+      // "null" for an index
+      static const uint32_t NIL = 0xFFFFFFFF;
+
+      // nested node class
+      struct Node;
+
+      uint32_t allocate();
+      void release(uint32_t i);
+      void grow();
+
+      // member variables
+      Node* nodes;           // every node, live or free, lives here
+      uint32_t numCapacity;  // number of slots in nodes
+      uint32_t numUsed;      // slots [0, numUsed) have been handed out at least once
+      uint32_t numElements;  // number of live nodes
+      uint32_t iHead;        // index of the beginning of the list
+      uint32_t iTail;        // index of the ending of the list
+      uint32_t iFree;        // index of the first released slot
+   };
+
+   /*************************************************
+    * NODE
+    * The two links are always valid; the data is only
+    * constructed while the node is in the list. A free
+    * node reuses iNext to point to the next free slot.
+    *************************************************/
+   template <typename T>
+   struct compact_list <T> ::Node
+   {
+      uint32_t iNext;       // index of next node
+      uint32_t iPrev;       // index of previous node
+      alignas(T) unsigned char storage[sizeof(T)];
+
+      T& data() { return *reinterpret_cast<T*>(storage); }
+   };
+
+   /*************************************************
+    * COMPACT LIST ITERATOR
+    * Iterate through a compact list. Since the node
+    * array may move as it grows, the iterator keeps
+    * the list and an index rather than a pointer.
+    ************************************************/
+   template <typename T>
+   class compact_list <T> ::iterator
+   {
+      friend class ::TestCompactList; // give unit tests access to the privates
+      template <typename TT>
+      friend class custom::compact_list;
+   public:
+      // constructors, destructors, and assignment operator
+      iterator() : pList(nullptr), i(NIL) {}
+      iterator(compact_list <T>* pList, uint32_t i) : pList(pList), i(i) {}
+      iterator(const iterator& rhs) : pList(rhs.pList), i(rhs.i) {}
+      iterator& operator = (const iterator& rhs)
+      {
+         pList = rhs.pList;
+         i = rhs.i;
+         return *this;
+      }
+
+      // equals, not equals operator
+      bool operator == (const iterator& rhs) const { return i == rhs.i; }
+      bool operator != (const iterator& rhs) const { return i != rhs.i; }
+
+      // dereference operator, fetch a node
+      T& operator * ()
+      {
+         if (i == NIL)
+            throw "Accessing null iterator";
+         return pList->nodes[i].data();
+      }
+
+      // postfix increment
+      iterator operator ++ (int)
+      {
+         iterator temp = *this;
+         ++(*this);
+         return temp;
+      }
+
+      // prefix increment
+      iterator& operator ++ ()
+      {
+         if (i != NIL)
+            i = pList->nodes[i].iNext;
+         return *this;
+      }
+
+      // postfix decrement
+      iterator operator -- (int)
+      {
+         iterator temp = *this;
+         --(*this);
+         return temp;
+      }
+
+      // prefix decrement
+      iterator& operator -- ()
+      {
+         if (i != NIL)
+            i = pList->nodes[i].iPrev;
+         return *this;
+      }
+
+   private:
+      compact_list <T>* pList;
+      uint32_t i;
+   };
+
+   /*****************************************
+    * COMPACT LIST :: DEFAULT constructor
+    ****************************************/
+   template <typename T>
+   compact_list <T> ::compact_list() : nodes(nullptr), numCapacity(0), numUsed(0),
+      numElements(0), iHead(NIL), iTail(NIL), iFree(NIL)
+   {
+   }
+
+   /*****************************************
+    * COMPACT LIST :: NON-DEFAULT constructors
+    * Create a list initialized to a value
+    ****************************************/
+   template <typename T>
+   compact_list <T> ::compact_list(size_t num, const T& t) : compact_list()
+   {
+      for (size_t i = 0; i < num; i++)
+         emplace_back(t);
+   }
+
+   template <typename T>
+   compact_list <T> ::compact_list(size_t num) : compact_list()
+   {
+      for (size_t i = 0; i < num; i++)
+         emplace_back();
+   }
+
+   /*****************************************
+    * COMPACT LIST :: INITIALIZER and ITERATOR constructors
+    * Create a list initialized to a set of values
+    ****************************************/
+   template <typename T>
+   compact_list <T> ::compact_list(const std::initializer_list<T>& il) : compact_list()
+   {
+      for (auto it = il.begin(); it != il.end(); it++)
+         emplace_back(*it);
+   }
+
+   template <typename T>
+   template <class Iterator>
+   compact_list <T> ::compact_list(Iterator first, Iterator last) : compact_list()
+   {
+      for (auto it = first; it != last; it++)
+         emplace_back(*it);
+   }
+
+   /*****************************************
+    * COMPACT LIST :: COPY constructor
+    * The copy is packed: its nodes sit in list order
+    ****************************************/
+   template <typename T>
+   compact_list <T> ::compact_list(const compact_list <T>& rhs) : compact_list()
+   {
+      for (uint32_t i = rhs.iHead; i != NIL; i = rhs.nodes[i].iNext)
+         emplace_back(rhs.nodes[i].data());
+   }
+
+   /*****************************************
+    * COMPACT LIST :: MOVE constructor
+    * Steal the node array from the RHS
+    ****************************************/
+   template <typename T>
+   compact_list <T> ::compact_list(compact_list <T>&& rhs) : compact_list()
+   {
+      swap(rhs);
+   }
+
+   /*****************************************
+    * COMPACT LIST :: DESTRUCTOR
+    ****************************************/
+   template <typename T>
+   compact_list <T> :: ~compact_list()
+   {
+      clear();
+      delete [] nodes;
+   }
+
+   /**********************************************
+    * COMPACT LIST :: assignment operator
+    * Copy one list onto another, reusing the slots
+    * we already have
+    *     INPUT  : a list to be copied
+    *     OUTPUT :
+    *     COST   : O(n) with respect to the number of nodes
+    *********************************************/
+   template <typename T>
+   compact_list <T>& compact_list <T> :: operator = (const compact_list <T>& rhs)
+   {
+      if (this == &rhs)
+         return *this;
+
+      uint32_t iDes = iHead;
+      uint32_t iSrc = rhs.iHead;
+
+      // assign onto the nodes the two lists have in common
+      for (; iDes != NIL && iSrc != NIL; iDes = nodes[iDes].iNext, iSrc = rhs.nodes[iSrc].iNext)
+         nodes[iDes].data() = rhs.nodes[iSrc].data();
+
+      // the source is longer: append the rest
+      for (; iSrc != NIL; iSrc = rhs.nodes[iSrc].iNext)
+         emplace_back(rhs.nodes[iSrc].data());
+
+      // the destination is longer: trim the rest
+      while (iDes != NIL)
+      {
+         uint32_t iNext = nodes[iDes].iNext;
+         erase(iterator(this, iDes));
+         iDes = iNext;
+      }
+
+      return *this;
+   }
+
+   /**********************************************
+    * COMPACT LIST :: assignment operator - MOVE
+    *     INPUT  : a list to be moved
+    *     OUTPUT :
+    *     COST   : O(n) with respect to the size of the LHS
+    *********************************************/
+   template <typename T>
+   compact_list <T>& compact_list <T> :: operator = (compact_list <T>&& rhs)
+   {
+      clear();
+      swap(rhs);
+      return *this;
+   }
+
+   /**********************************************
+    * COMPACT LIST :: assignment operator - INITIALIZER
+    *     INPUT  : the values to be copied
+    *     OUTPUT :
+    *     COST   : O(n)
+    *********************************************/
+   template <typename T>
+   compact_list <T>& compact_list <T> :: operator = (const std::initializer_list<T>& il)
+   {
+      clear();
+      for (auto it = il.begin(); it != il.end(); it++)
+         emplace_back(*it);
+      return *this;
+   }
+
+   /**********************************************
+    * COMPACT LIST :: SWAP
+    *     COST   : O(1)
+    *********************************************/
+   template <typename T>
+   void compact_list <T> ::swap(compact_list <T>& rhs)
+   {
+      std::swap(nodes,       rhs.nodes);
+      std::swap(numCapacity, rhs.numCapacity);
+      std::swap(numUsed,     rhs.numUsed);
+      std::swap(numElements, rhs.numElements);
+      std::swap(iHead,       rhs.iHead);
+      std::swap(iTail,       rhs.iTail);
+      std::swap(iFree,       rhs.iFree);
+   }
+
+   template <typename T>
+   void swap(compact_list <T>& lhs, compact_list <T>& rhs)
+   {
+      lhs.swap(rhs);
+   }
+
+   /**********************************************
+    * COMPACT LIST :: CLEAR
+    * Destroy every item. The node array is kept so
+    * the list can be refilled without allocating.
+    *     COST   : O(n) with respect to the number of nodes
+    *********************************************/
+   template <typename T>
+   void compact_list <T> ::clear()
+   {
+      for (uint32_t i = iHead; i != NIL; i = nodes[i].iNext)
+         nodes[i].data().~T();
+
+      numUsed = 0;
+      numElements = 0;
+      iHead = iTail = iFree = NIL;
+   }
+
+   /*********************************************
+    * COMPACT LIST :: FRONT and BACK
+    * retrieves the first or last element in the list
+    *     COST   : O(1)
+    *********************************************/
+   template <typename T>
+   T& compact_list <T> ::front()
+   {
+      if (iHead == NIL)
+         throw "ERROR: unable to access data from an empty list";
+      return nodes[iHead].data();
+   }
+
+   template <typename T>
+   T& compact_list <T> ::back()
+   {
+      if (iTail == NIL)
+         throw "ERROR: unable to access data from an empty list";
+      return nodes[iTail].data();
+   }
+
+   /******************************************
+    * COMPACT LIST :: EMPLACE
+    * construct an item directly in a free slot and link it
+    * in immediately before the iterator
+    *     INPUT  : an iterator to the location where it is to be inserted
+    *              the arguments to T's constructor
+    *     OUTPUT : iterator to the new item
+    *     COST   : O(1) amortized
+    ******************************************/
+   template <typename T>
+   template <class ... Args>
+   typename compact_list <T> ::iterator compact_list <T> ::emplace(iterator it, Args&& ... args)
+   {
+      uint32_t iNew;
+      if (iFree == NIL && numUsed == numCapacity)
+      {
+         // the arguments may refer into the array we are about to move
+         T t(std::forward<Args>(args)...);
+         iNew = allocate();
+         new (nodes[iNew].storage) T(std::move(t));
+      }
+      else
+      {
+         iNew = allocate();
+         new (nodes[iNew].storage) T(std::forward<Args>(args)...);
+      }
+
+      uint32_t iNext = it.i;
+      uint32_t iPrev = (iNext == NIL) ? iTail : nodes[iNext].iPrev;
+      nodes[iNew].iNext = iNext;
+      nodes[iNew].iPrev = iPrev;
+
+      if (iPrev == NIL)
+         iHead = iNew;
+      else
+         nodes[iPrev].iNext = iNew;
+
+      if (iNext == NIL)
+         iTail = iNew;
+      else
+         nodes[iNext].iPrev = iNew;
+
+      numElements++;
+      return iterator(this, iNew);
+   }
+
+   /******************************************
+    * COMPACT LIST :: ERASE
+    * remove an item from the middle of the list
+    *     INPUT  : an iterator to the item being removed
+    *     OUTPUT : iterator to the new location
+    *     COST   : O(1)
+    ******************************************/
+   template <typename T>
+   typename compact_list <T> ::iterator compact_list <T> ::erase(const iterator& it)
+   {
+      if (it.i == NIL)
+         return end();
+
+      uint32_t iNext = nodes[it.i].iNext;
+      uint32_t iPrev = nodes[it.i].iPrev;
+
+      if (iPrev == NIL)
+         iHead = iNext;
+      else
+         nodes[iPrev].iNext = iNext;
+
+      if (iNext == NIL)
+         iTail = iPrev;
+      else
+         nodes[iNext].iPrev = iPrev;
+
+      nodes[it.i].data().~T();
+      release(it.i);
+      numElements--;
+
+      return iterator(this, iNext);
+   }
+
+   /*********************************************
+    * COMPACT LIST :: POP BACK and POP FRONT
+    * remove an item from the end or front of the list
+    *    COST   : O(1)
+    *********************************************/
+   template <typename T>
+   void compact_list <T> ::pop_back()
+   {
+      erase(rbegin());
+   }
+
+   template <typename T>
+   void compact_list <T> ::pop_front()
+   {
+      erase(begin());
+   }
+
+   /*********************************************
+    * COMPACT LIST :: ALLOCATE
+    * Find a slot for a new node: a released one first,
+    * then a never-used one, then grow the array
+    *    OUTPUT : index of the slot
+    *    COST   : O(1) amortized
+    *********************************************/
+   template <typename T>
+   uint32_t compact_list <T> ::allocate()
+   {
+      if (iFree != NIL)
+      {
+         uint32_t i = iFree;
+         iFree = nodes[i].iNext;
+         return i;
+      }
+
+      if (numUsed == numCapacity)
+         grow();
+
+      return numUsed++;
+   }
+
+   /*********************************************
+    * COMPACT LIST :: RELEASE
+    * Put a slot whose data is already destroyed on
+    * the free list
+    *    COST   : O(1)
+    *********************************************/
+   template <typename T>
+   void compact_list <T> ::release(uint32_t i)
+   {
+      nodes[i].iNext = iFree;
+      nodes[i].iPrev = NIL;
+      iFree = i;
+   }
+
+   /*********************************************
+    * COMPACT LIST :: GROW
+    * Double the node array. Indices do not change, so
+    * only the live data needs to be moved across.
+    *    COST   : O(n)
+    *********************************************/
+   template <typename T>
+   void compact_list <T> ::grow()
+   {
+      if (numCapacity >= NIL / 2)
+         throw "ERROR: compact_list is too large for 32-bit indices";
+
+      uint32_t numNew = (numCapacity == 0) ? 4 : numCapacity * 2;
+      Node* nodesNew = new Node[numNew];
+
+      for (uint32_t i = 0; i < numUsed; i++)
+      {
+         nodesNew[i].iNext = nodes[i].iNext;
+         nodesNew[i].iPrev = nodes[i].iPrev;
+      }
+
+      for (uint32_t i = iHead; i != NIL; i = nodes[i].iNext)
+      {
+         new (nodesNew[i].storage) T(std::move(nodes[i].data()));
+         nodes[i].data().~T();
+      }
+
+      delete [] nodes;
+      nodes = nodesNew;
+      numCapacity = numNew;
+   }
+
+}; // namespace custom
@@ -103,6 +103,12 @@ namespace custom
       void push_back(T&& data);
       iterator insert(iterator it, const T& data);
       iterator insert(iterator it, T&& data);
+      template <class ... Args>
+      void emplace_front(Args&& ... args);
+      template <class ... Args>
+      void emplace_back(Args&& ... args);
+      template <class ... Args>
+      iterator emplace(iterator it, Args&& ... args);
 
       //
       // Remove
@@ -153,10 +159,17 @@ namespace custom
       {
          pNext = pPrev = nullptr;
       }
-      Node(T&& data)
+      Node(T&& data) : data(std::move(data))
+      {
+         pNext = pPrev = nullptr;
+      }
+
+      // build the data in place from the constructor arguments of T
+      struct Emplace {};
+      template <class ... Args>
+      Node(Emplace, Args&& ... args) : data(std::forward<Args>(args)...)
       {
          pNext = pPrev = nullptr;
-         this->data = std::move(data);
       }
 
       //
@@ -296,29 +309,12 @@ namespace custom
    template <class Iterator>
    list <T> ::list(Iterator first, Iterator last)
    {
-      if (first == last)
-      {
-         pHead = nullptr;
-         pTail = nullptr;
-         numElements = 0;
-         return;
-      }
-
-      numElements = 0;//il.size();
-      this->pHead = new list <T> ::Node();
-      auto* p = pHead;
+      numElements = 0;
+      pHead = pTail = nullptr;
 
+      // construct each element directly in its node
       for (auto it = first; it != last; it++)
-      {
-         p->pNext = new list <T> ::Node();
-         p->pNext->pPrev = p;
-         p->data = *it;
-         pTail = p;
-         p = p->pNext;
-         numElements++;
-      }
-
-      pTail->pNext = nullptr;
+         emplace_back(*it);
    }
 
    /*****************************************
@@ -328,28 +324,11 @@ namespace custom
    template <typename T>
    list <T> ::list(const std::initializer_list<T>& il)
    {
-      if (il.size() == 0)
-      {
-         pHead = nullptr;
-         pTail = nullptr;
-         numElements = 0;
-         return;
-      }
-
-      numElements = il.size();
-      this->pHead = new list <T> ::Node();
-      auto* p = pHead;
+      numElements = 0;
+      pHead = pTail = nullptr;
 
       for (auto it = il.begin(); it != il.end(); it++)
-      {
-         p->pNext = new list <T> ::Node();
-         p->pNext->pPrev = p;
-         p->data = *it;
-         pTail = p;
-         p = p->pNext;
-      }
-
-      pTail->pNext = nullptr;
+         emplace_back(*it);
    }
 
    /*****************************************
@@ -497,26 +476,11 @@ namespace custom
    template <typename T>
    list <T>& list <T> :: operator = (const std::initializer_list<T>& rhs)
    {
-      if (rhs.size() == 0)
-      {
-         clear();
-         return *this;
-      }
-
-      numElements = rhs.size();
-      this->pHead = new list <T> ::Node();
-      auto* p = pHead;
+      clear();
 
       for (auto it = rhs.begin(); it != rhs.end(); it++)
-      {
-         p->pNext = new list <T> ::Node();
-         p->pNext->pPrev = p;
-         p->data = *it;
-         pTail = p;
-         p = p->pNext;
-      }
+         emplace_back(*it);
 
-      pTail->pNext = nullptr;
       return *this;
    }
 
@@ -530,12 +494,11 @@ namespace custom
    template <typename T>
    void list <T> ::clear()
    {
-      if (pHead == nullptr)
-         return;
-
-      for (auto p = pHead; p->pNext != nullptr; p = p->pNext)
+      while (pHead != nullptr)
       {
-         delete p->pPrev;
+         Node* pDelete = pHead;
+         pHead = pHead->pNext;
+         delete pDelete;
       }
 
       pTail = nullptr;
@@ -617,6 +580,54 @@ namespace custom
       pHead = pNew;
    }
 
+   /*********************************************
+    * LIST :: EMPLACE BACK
+    * construct an item directly in a new node at the end of the list
+    *    INPUT  : the arguments to T's constructor
+    *    OUTPUT :
+    *    COST   : O(1)
+    *********************************************/
+   template <typename T>
+   template <class ... Args>
+   void list <T> ::emplace_back(Args&& ... args)
+   {
+      auto pNew = new typename list<T>::Node(typename Node::Emplace(),
+                                             std::forward<Args>(args)...);
+      numElements++;
+      if (pHead == nullptr)
+      {
+         pHead = pTail = pNew;
+         return;
+      }
+      pTail->pNext = pNew;
+      pNew->pPrev = pTail;
+      pTail = pNew;
+   }
+
+   /*********************************************
+    * LIST :: EMPLACE FRONT
+    * construct an item directly in a new node at the head of the list
+    *    INPUT  : the arguments to T's constructor
+    *    OUTPUT :
+    *    COST   : O(1)
+    *********************************************/
+   template <typename T>
+   template <class ... Args>
+   void list <T> ::emplace_front(Args&& ... args)
+   {
+      auto pNew = new typename list<T>::Node(typename Node::Emplace(),
+                                             std::forward<Args>(args)...);
+      numElements++;
+      if (pHead == nullptr)
+      {
+         pHead = pTail = pNew;
+         return;
+      }
+      pHead->pPrev = pNew;
+      pNew->pNext = pHead;
+      pHead = pNew;
+   }
+
 
    /*********************************************
     * LIST :: POP BACK
@@ -835,6 +846,52 @@ namespace custom
       return iterator(pNew);
    }
 
+   /******************************************
+    * LIST :: EMPLACE
+    * construct an item directly in a new node in the middle of the list
+    *     INPUT  : an iterator to the location where it is to be inserted
+    *              the arguments to T's constructor
+    *     OUTPUT : iterator to the new item
+    *     COST   : O(1)
+    ******************************************/
+   template <typename T>
+   template <class ... Args>
+   typename list <T> ::iterator list <T> ::emplace(list <T> ::iterator it,
+      Args&& ... args)
+   {
+      auto pNew = new typename list<T>::Node(typename Node::Emplace(),
+                                             std::forward<Args>(args)...);
+      if (it.p == nullptr)
+      {
+         pNew->pPrev = pTail;
+         pNew->pNext = nullptr;
+
+         if (pTail != nullptr)
+            pTail->pNext = pNew;
+         if (pHead == nullptr)
+            pHead = pNew;
+         pTail = pNew;
+      }
+      else if (it.p == pHead)
+      {
+         pNew->pNext = pHead;
+         pHead->pPrev = pNew;
+         pHead = pNew;
+      }
+      else
+      {
+         Node* prevNode = it.p->pPrev;
+         pNew->pPrev = prevNode;
+         pNew->pNext = it.p;
+
+         prevNode->pNext = pNew;
+         it.p->pPrev = pNew;
+      }
+
+      numElements++;
+      return iterator(pNew);
+   }
+
    /**********************************************
     * LIST :: assignment operator - MOVE
     * Copy one list onto another
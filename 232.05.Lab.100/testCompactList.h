@@ -0,0 +1,340 @@
+/***********************************************************************
+ * Header:
+ *    TEST COMPACT LIST
+ * Summary:
+ *    Unit tests for compact_list
+ * Author
+ *    M Scott O'Connor & Gabe Lytle
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "compactList.h"
+#include "unitTest.h"
+
+#include <memory>
+#include <string>
+
+class TestCompactList : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_constructInit_standard();
+      test_constructCopy_standard();
+      test_constructMove_standard();
+
+      // Assign
+      test_assign_bigToSmall();
+      test_assign_smallToBig();
+
+      // Insert
+      test_pushback_grow();
+      test_pushfront_standard();
+      test_insert_standardMiddle();
+      test_emplace_moveOnly();
+      test_pushback_selfReference();
+
+      // Remove
+      test_erase_standardMiddle();
+      test_erase_reuseSlot();
+      test_pop_standard();
+      test_clear_standard();
+
+      // Iterator
+      test_iterator_forwardBackward();
+
+      // Status
+      test_nodeSize();
+
+      report("CompactList");
+   }
+
+   /***************************************
+    * CONSTRUCT
+    ***************************************/
+
+   // an empty list has no node array
+   void test_construct_default()
+   {  // setup
+      // exercise
+      custom::compact_list<int> l;
+      // verify
+      assertUnit(l.nodes == nullptr);
+      assertUnit(l.numCapacity == 0);
+      assertUnit(l.numElements == 0);
+      assertUnit(l.iHead == custom::compact_list<int>::NIL);
+      assertUnit(l.iTail == custom::compact_list<int>::NIL);
+      assertUnit(l.empty());
+   }  // teardown
+
+   // the initializer list fills the array in order
+   void test_constructInit_standard()
+   {  // setup
+      // exercise
+      custom::compact_list<int> l{ 11, 26, 31 };
+      // verify
+      assertStandardFixture(l);
+      assertUnit(l.iHead == 0);
+      assertUnit(l.iTail == 2);
+   }  // teardown
+
+   // copy a list
+   void test_constructCopy_standard()
+   {  // setup
+      custom::compact_list<int> lSrc{ 11, 26, 31 };
+      // exercise
+      custom::compact_list<int> lDes(lSrc);
+      // verify
+      assertStandardFixture(lSrc);
+      assertStandardFixture(lDes);
+      assertUnit(lSrc.nodes != lDes.nodes);
+   }  // teardown
+
+   // move a list, stealing the array
+   void test_constructMove_standard()
+   {  // setup
+      custom::compact_list<int> lSrc{ 11, 26, 31 };
+      auto nodes = lSrc.nodes;
+      // exercise
+      custom::compact_list<int> lDes(std::move(lSrc));
+      // verify
+      assertStandardFixture(lDes);
+      assertUnit(lDes.nodes == nodes);
+      assertUnit(lSrc.nodes == nullptr);
+      assertUnit(lSrc.empty());
+   }  // teardown
+
+   /***************************************
+    * ASSIGN
+    ***************************************/
+
+   // assign a three element list onto a five element list
+   void test_assign_bigToSmall()
+   {  // setup
+      custom::compact_list<int> lSrc{ 11, 26, 31 };
+      custom::compact_list<int> lDes{ 1, 2, 3, 4, 5 };
+      auto nodes = lDes.nodes;
+      // exercise
+      lDes = lSrc;
+      // verify
+      assertStandardFixture(lDes);
+      assertUnit(lDes.nodes == nodes);    // reused the array
+   }  // teardown
+
+   // assign a three element list onto a one element list
+   void test_assign_smallToBig()
+   {  // setup
+      custom::compact_list<int> lSrc{ 11, 26, 31 };
+      custom::compact_list<int> lDes{ 99 };
+      // exercise
+      lDes = lSrc;
+      // verify
+      assertStandardFixture(lDes);
+   }  // teardown
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   // pushing past the capacity keeps every item
+   void test_pushback_grow()
+   {  // setup
+      custom::compact_list<std::string> l;
+      // exercise
+      for (int i = 0; i < 100; i++)
+         l.push_back(std::to_string(i));
+      // verify
+      assertUnit(l.size() == 100);
+      assertUnit(l.capacity() >= 100);
+      int i = 0;
+      bool same = true;
+      for (auto it = l.begin(); it != l.end(); ++it, ++i)
+         same = same && *it == std::to_string(i);
+      assertUnit(same);
+      assertUnit(i == 100);
+   }  // teardown
+
+   // push onto the front
+   void test_pushfront_standard()
+   {  // setup
+      custom::compact_list<int> l{ 26, 31 };
+      // exercise
+      l.push_front(11);
+      // verify
+      assertStandardFixture(l);
+   }  // teardown
+
+   // insert into the middle
+   void test_insert_standardMiddle()
+   {  // setup
+      custom::compact_list<int> l{ 11, 31 };
+      auto it = l.begin();
+      ++it;
+      // exercise
+      auto itReturn = l.insert(it, 26);
+      // verify
+      assertUnit(*itReturn == 26);
+      assertStandardFixture(l);
+   }  // teardown
+
+   // a move-only type can be built in place
+   void test_emplace_moveOnly()
+   {  // setup
+      custom::compact_list<std::unique_ptr<int>> l;
+      // exercise
+      for (int i = 0; i < 10; i++)
+         l.emplace_back(new int(i));
+      l.emplace_front(new int(-1));
+      // verify
+      assertUnit(l.size() == 11);
+      assertUnit(*l.front() == -1);
+      assertUnit(*l.back() == 9);
+   }  // teardown
+
+   // pushing a copy of one of our own items survives the array growing
+   void test_pushback_selfReference()
+   {  // setup
+      custom::compact_list<std::string> l{ "eleven", "twenty-six", "thirty-one", "forty" };
+      assertUnit(l.numUsed == l.numCapacity);
+      // exercise
+      l.push_back(l.front());
+      // verify
+      assertUnit(l.size() == 5);
+      assertUnit(l.back() == std::string("eleven"));
+      assertUnit(l.front() == std::string("eleven"));
+   }  // teardown
+
+   /***************************************
+    * REMOVE
+    ***************************************/
+
+   // erase from the middle
+   void test_erase_standardMiddle()
+   {  // setup
+      custom::compact_list<int> l{ 11, 26, 99, 31 };
+      auto it = l.begin();
+      ++it;
+      ++it;
+      // exercise
+      auto itReturn = l.erase(it);
+      // verify
+      assertUnit(*itReturn == 31);
+      assertStandardFixture(l);
+   }  // teardown
+
+   // the slot of an erased node is handed to the next insert
+   void test_erase_reuseSlot()
+   {  // setup
+      custom::compact_list<int> l{ 11, 99, 26 };
+      auto it = l.begin();
+      ++it;
+      uint32_t iErased = it.i;
+      // exercise
+      l.erase(it);
+      l.push_back(31);
+      // verify
+      assertUnit(l.iTail == iErased);
+      assertUnit(l.numUsed == 3);
+      assertStandardFixture(l);
+   }  // teardown
+
+   // pop from both ends
+   void test_pop_standard()
+   {  // setup
+      custom::compact_list<int> l{ 1, 11, 26, 31, 99 };
+      // exercise
+      l.pop_front();
+      l.pop_back();
+      // verify
+      assertStandardFixture(l);
+   }  // teardown
+
+   // clear keeps the array for reuse
+   void test_clear_standard()
+   {  // setup
+      custom::compact_list<std::string> l{ "a", "b", "c" };
+      auto nodes = l.nodes;
+      // exercise
+      l.clear();
+      // verify
+      assertUnit(l.empty());
+      assertUnit(l.iHead == custom::compact_list<std::string>::NIL);
+      assertUnit(l.iTail == custom::compact_list<std::string>::NIL);
+      assertUnit(l.nodes == nodes);
+      l.push_back("d");
+      assertUnit(l.front() == std::string("d"));
+   }  // teardown
+
+   /***************************************
+    * ITERATOR
+    ***************************************/
+
+   // walk forward then backward
+   void test_iterator_forwardBackward()
+   {  // setup
+      custom::compact_list<int> l{ 11, 26, 31 };
+      // exercise
+      auto it = l.begin();
+      it++;
+      ++it;
+      // verify
+      assertUnit(*it == 31);
+      assertUnit(it == l.rbegin());
+      --it;
+      assertUnit(*it == 26);
+      it--;
+      assertUnit(it == l.begin());
+      --it;
+      assertUnit(it == l.end());
+   }  // teardown
+
+   /***************************************
+    * STATUS
+    ***************************************/
+
+   // an int node is two 32-bit links and the int: half of custom::list
+   void test_nodeSize()
+   {  // setup
+      // exercise
+      size_t sizeNode = sizeof(custom::compact_list<int>::Node);
+      // verify
+      assertUnit(sizeNode == 12);
+   }  // teardown
+
+   /****************************************************************
+    * Verify Standard Fixture
+    *       +----+   +----+   +----+
+    *       | 11 | - | 26 | - | 31 |
+    *       +----+   +----+   +----+
+    ****************************************************************/
+   void assertStandardFixtureParameters(custom::compact_list<int>& l, int line, const char* function)
+   {
+      assertIndirect(l.numElements == 3);
+      assertIndirect(l.iHead != custom::compact_list<int>::NIL);
+      assertIndirect(l.iTail != custom::compact_list<int>::NIL);
+
+      if (l.numElements == 3)
+      {
+         uint32_t i11 = l.iHead;
+         uint32_t i26 = l.nodes[i11].iNext;
+         uint32_t i31 = l.nodes[i26].iNext;
+         assertIndirect(l.nodes[i11].data() == 11);
+         assertIndirect(l.nodes[i11].iPrev == custom::compact_list<int>::NIL);
+         assertIndirect(l.nodes[i26].data() == 26);
+         assertIndirect(l.nodes[i26].iPrev == i11);
+         assertIndirect(l.nodes[i31].data() == 31);
+         assertIndirect(l.nodes[i31].iPrev == i26);
+         assertIndirect(l.nodes[i31].iNext == custom::compact_list<int>::NIL);
+         assertIndirect(l.iTail == i31);
+      }
+   }
+};
+
+#endif // DEBUG
@@ -13,6 +13,7 @@
  //#undef DEBUG  // Remove this comment to disable unit tests
 
 #include "testList.h"       // for the spy unit tests
+#include "testCompactList.h" // for the compact list unit tests
 
 
 /**********************************************************************
@@ -24,6 +25,7 @@ int main()
 #ifdef DEBUG
    // unit tests
    TestList().run();
+   TestCompactList().run();
 #endif // DEBUG
    
    return 0;
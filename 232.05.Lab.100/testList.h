@@ -99,6 +99,10 @@ public:
       test_insertMove_empty();
       test_insertMove_standardFront();
       test_insertMove_standardMiddle();
+      test_emplaceback_standard();
+      test_emplacefront_empty();
+      test_emplace_standardMiddle();
+      test_emplace_moveOnly();
 
       // Remove
       test_clear_empty();
@@ -2348,6 +2352,131 @@ public:
       teardownStandardFixture(l);
    }
 
+   /***************************************
+    * EMPLACE
+    ***************************************/
+
+   // construct an element directly onto the back of the standard fixture
+   void test_emplaceback_standard()
+   {  // setup
+      //        pHead             pTail
+      //       +----+   +----+   +----+
+      //       | 11 | - | 26 | - | 31 |
+      //       +----+   +----+   +----+
+      custom::list<int> l;
+      setupStandardFixture(l);
+      // exercise
+      l.emplace_back(99);
+      // verify
+      //        pHead                      pTail
+      //       +----+   +----+   +----+   +----+
+      //       | 11 | - | 26 | - | 31 | - | 99 |
+      //       +----+   +----+   +----+   +----+
+      assertUnit(l.numElements == 4);
+      assertUnit(l.pTail != nullptr);
+      if (l.pTail)
+      {
+         assertUnit(l.pTail->data == int(99));
+         assertUnit(l.pTail->pNext == nullptr);
+         assertUnit(l.pTail->pPrev != nullptr);
+         if (l.pTail->pPrev)
+         {
+            assertUnit(l.pTail->pPrev->pNext == l.pTail);
+            l.pTail = l.pTail->pPrev;
+            delete l.pTail->pNext;
+            l.numElements--;
+            l.pTail->pNext = nullptr;
+         }
+      }
+      assertStandardFixture(l);
+      // teardown
+      teardownStandardFixture(l);
+   }
+
+   // construct an element directly onto the front of an empty list
+   void test_emplacefront_empty()
+   {  // setup
+      custom::list<int> l;
+      // exercise
+      l.emplace_front(99);
+      // verify
+      //       +----+
+      //       | 99 |
+      //       +----+
+      assertUnit(l.pHead != nullptr);
+      assertUnit(l.pTail == l.pHead);
+      assertUnit(l.numElements == 1);
+      if (l.pHead)
+      {
+         assertUnit(l.pHead->data == int(99));
+         assertUnit(l.pHead->pNext == nullptr);
+         assertUnit(l.pHead->pPrev == nullptr);
+      }
+      // teardown
+      teardownStandardFixture(l);
+   }
+
+   // construct an element directly in the middle of the standard list
+   void test_emplace_standardMiddle()
+   {  // setup
+      custom::list<int>::iterator it;
+      custom::list<int>::iterator itReturn;
+      //       +----+   +----+   +----+
+      //       | 11 | - | 26 | - | 31 |
+      //       +----+   +----+   +----+
+      //                  it
+      custom::list<int> l;
+      setupStandardFixture(l);
+      it.p = l.pHead->pNext;
+      // exercise
+      itReturn = l.emplace(it, 99);
+      // verify
+      //       +----+   +----+   +----+   +----+
+      //       | 11 | - | 99 | - | 26 | - | 31 |
+      //       +----+   +----+   +----+   +----+
+      //               itReturn    it
+      assertUnit(l.numElements == 4);
+      assertUnit(itReturn.p == l.pHead->pNext);
+      assertUnit(itReturn.p->pNext == it.p);
+      assertUnit(it.p->pPrev == itReturn.p);
+      assertUnit(l.pTail->data == int(31));
+      if (itReturn.p)
+      {
+         assertUnit(itReturn.p->data == int(99));
+         l.pHead->pNext = it.p;
+         it.p->pPrev = l.pHead;
+         delete itReturn.p;
+         l.numElements--;
+      }
+      assertStandardFixture(l);
+      // teardown
+      teardownStandardFixture(l);
+   }
+
+   // a move-only type can only be placed in the list by construction
+   void test_emplace_moveOnly()
+   {  // setup
+      custom::list<std::unique_ptr<int>> l;
+      // exercise
+      l.emplace_back(new int(26));
+      l.emplace_front(new int(11));
+      l.emplace(l.end(), new int(31));
+      // verify
+      //       +----+   +----+   +----+
+      //       | 11 | - | 26 | - | 31 |
+      //       +----+   +----+   +----+
+      assertUnit(l.numElements == 3);
+      assertUnit(*l.front() == 11);
+      assertUnit(*l.back() == 31);
+      assertUnit(l.pHead->pNext != nullptr);
+      if (l.pHead->pNext)
+         assertUnit(*l.pHead->pNext->data == 26);
+      // teardown
+      l.clear();
+      assertUnit(l.pHead == nullptr);
+      assertUnit(l.numElements == 0);
+   }
+
    /****************************************************************
     * Setup Standard Fixture
     *        pHead             pTail
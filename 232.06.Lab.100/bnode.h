@@ -22,6 +22,8 @@
 
 #include <iostream>  // for OFSTREAM
 #include <cassert>
+#include <utility>   // for std::pair
+#include <vector>    // for the subtrees still to visit
 
 /*****************************************************************
  * BNODE
@@ -68,18 +70,31 @@ public:
 
 /*******************************************************************
  * SIZE BTREE
- * Return the size of a b-tree under the current node
+ * Return the size of a b-tree under the current node. None of these
+ * functions recurse, so a tree as deep as it is long is fine. Only
+ * a node with two children leaves one behind to come back to.
  *******************************************************************/
 template <class T>
 inline size_t size(const BNode <T> * p)
 {
-   if (p == nullptr)
-      return 0;
-   
-   int n = 1;
+   size_t n = 0;
+   std::vector <const BNode <T> *> pending;
 
-   n += size(p->pLeft);
-   n += size(p->pRight);
+   for (;;)
+   {
+      if (p == nullptr)
+      {
+         if (pending.empty())
+            break;
+         p = pending.back();
+         pending.pop_back();
+      }
+
+      n++;
+      if (p->pLeft != nullptr && p->pRight != nullptr)
+         pending.push_back(p->pRight);
+      p = (p->pLeft != nullptr) ? p->pLeft : p->pRight;
+   }
 
    return n;
 }
@@ -92,12 +107,11 @@ inline size_t size(const BNode <T> * p)
 template <class T>
 inline void addLeft(BNode <T> * pNode, BNode <T> * pAdd)
 {
-   if (pNode->pLeft != nullptr)
-      addLeft(pNode->pLeft, pAdd);
-   else {
-      pNode->pLeft = pAdd;
-      pNode->pLeft->pParent = pNode;
-   }
+   while (pNode->pLeft != nullptr)
+      pNode = pNode->pLeft;
+
+   pNode->pLeft = pAdd;
+   pNode->pLeft->pParent = pNode;
 }
 
 /******************************************************
@@ -107,12 +121,11 @@ inline void addLeft(BNode <T> * pNode, BNode <T> * pAdd)
 template <class T>
 inline void addRight (BNode <T> * pNode, BNode <T> * pAdd)
 {
-   if (pNode->pRight != nullptr)
-      addRight(pNode->pRight, pAdd);
-   else {
-      pNode->pRight = pAdd;
-      pNode->pRight->pParent = pNode;
-   }
+   while (pNode->pRight != nullptr)
+      pNode = pNode->pRight;
+
+   pNode->pRight = pAdd;
+   pNode->pRight->pParent = pNode;
 }
 
 /******************************************************
@@ -122,23 +135,13 @@ inline void addRight (BNode <T> * pNode, BNode <T> * pAdd)
 template <class T>
 inline void addLeft (BNode <T> * pNode, const T & t)
 {
-   if (pNode->pLeft != nullptr)
-      addLeft(pNode->pLeft, t);
-   else {
-      pNode->pLeft = new BNode<T>(t);
-      pNode->pLeft->pParent = pNode;
-   }
+   addLeft(pNode, new BNode<T>(t));
 }
 
 template <class T>
 inline void addLeft(BNode <T>* pNode, T && t)
 {
-   if (pNode->pLeft != nullptr)
-      addLeft(pNode->pLeft, std::move(t));
-   else {
-      pNode->pLeft = new BNode<T>(std::move(t));
-      pNode->pLeft->pParent = pNode;
-   }
+   addLeft(pNode, new BNode<T>(std::move(t)));
 }
 
 /******************************************************
@@ -148,43 +151,43 @@ inline void addLeft(BNode <T>* pNode, T && t)
 template <class T>
 void addRight (BNode <T> * pNode, const T & t)
 {
-   if (pNode->pRight != nullptr)
-      addRight(pNode->pRight, t);
-   else {
-      pNode->pRight = new BNode<T>(t);
-      pNode->pRight->pParent = pNode;
-   }
+   addRight(pNode, new BNode<T>(t));
 }
 
 template <class T>
 void addRight(BNode <T>* pNode, T && t)
 {
-   if (pNode->pRight != nullptr)
-      addRight(pNode->pRight, std::move(t));
-   else {
-      pNode->pRight = new BNode<T>(std::move(t));
-      pNode->pRight->pParent = pNode;
-   }
+   addRight(pNode, new BNode<T>(std::move(t)));
 }
 
 /*****************************************************
  * DELETE BINARY TREE
- * Delete all the nodes below pThis including pThis
- * using postfix traverse: LRV
+ * Delete all the nodes below pThis including pThis.
+ * A node with a left child is rotated right until it
+ * has none; then it can go, and its right subtree is
+ * next. No stack is needed at all.
  ****************************************************/
 template <class T>
 void clear(BNode <T> * & pThis)
 {
-   if (pThis == nullptr)
-      return;
-
-   if (pThis->pLeft != nullptr)
-      clear(pThis->pLeft);
-
-   if (pThis->pRight != nullptr)
-      clear(pThis->pRight);
+   BNode <T>* p = pThis;
+   while (p != nullptr)
+   {
+      if (p->pLeft != nullptr)
+      {
+         BNode <T>* pLeft = p->pLeft;
+         p->pLeft = pLeft->pRight;
+         pLeft->pRight = p;
+         p = pLeft;
+      }
+      else
+      {
+         BNode <T>* pRight = p->pRight;
+         delete p;
+         p = pRight;
+      }
+   }
 
-   delete pThis;
    pThis = nullptr;
 }
 
@@ -202,35 +205,64 @@ inline void swap(BNode <T>*& pLHS, BNode <T>*& pRHS)
 /**********************************************
  * COPY BINARY TREE
  * Copy pSrc->pRight to pDest->pRight and
- * pSrc->pLeft onto pDest->pLeft
+ * pSrc->pLeft onto pDest->pLeft in one pass,
+ * making exactly one node for each in pSrc
  *********************************************/
 template <class T>
 BNode <T> * copy(const BNode <T> * pSrc)
 {
-   BNode<T>* dest = new BNode<T>;
-
    if (pSrc == nullptr)
       return nullptr;
 
-   dest->data = pSrc->data;
+   BNode <T>* pDest = new BNode<T>(pSrc->data);
 
-   if (pSrc->pLeft != nullptr) {
-      dest->pLeft = copy(pSrc->pLeft);
-      dest->pLeft->pParent = dest;
-   }
-   
-   if (pSrc->pRight != nullptr) {
-      dest->pRight = copy(pSrc->pRight);
-      dest->pRight->pParent = dest;
+   // nodes whose right subtree is still to be copied
+   std::vector <std::pair <const BNode <T> *, BNode <T> *>> pending;
+   const BNode <T>* s = pSrc;
+   BNode <T>* d = pDest;
+
+   for (;;)
+   {
+      if (s->pLeft != nullptr && s->pRight != nullptr)
+         pending.push_back(std::make_pair(s, d));
+
+      if (s->pLeft != nullptr)
+      {
+         d->pLeft = new BNode<T>(s->pLeft->data);
+         d->pLeft->pParent = d;
+         s = s->pLeft;
+         d = d->pLeft;
+      }
+      else if (s->pRight != nullptr)
+      {
+         d->pRight = new BNode<T>(s->pRight->data);
+         d->pRight->pParent = d;
+         s = s->pRight;
+         d = d->pRight;
+      }
+      else if (!pending.empty())
+      {
+         const BNode <T>* sParent = pending.back().first;
+         BNode <T>* dParent = pending.back().second;
+         pending.pop_back();
+         dParent->pRight = new BNode<T>(sParent->pRight->data);
+         dParent->pRight->pParent = dParent;
+         s = sParent->pRight;
+         d = dParent->pRight;
+      }
+      else
+         break;
    }
 
-   return dest;
+   return pDest;
 }
 
 /**********************************************
  * assign
  * copy the values from pSrc onto pDest preserving
- * as many of the nodes as possible.
+ * as many of the nodes as possible. Where only
+ * pSrc has a subtree it is copied; where only
+ * pDest has one it is cleared.
  *********************************************/
 template <class T>
 void assign(BNode <T> * & pDest, const BNode <T>* pSrc)
@@ -242,16 +274,47 @@ void assign(BNode <T> * & pDest, const BNode <T>* pSrc)
 
    if (pDest == nullptr) {
       pDest = copy(pSrc);
+      return;
    }
 
-   pDest->data = pSrc->data;
+   // nodes in both trees whose right subtrees are still to be assigned
+   std::vector <std::pair <const BNode <T> *, BNode <T> *>> pending;
+   pending.push_back(std::make_pair(pSrc, pDest));
+
+   while (!pending.empty())
+   {
+      const BNode <T>* s = pending.back().first;
+      BNode <T>* d = pending.back().second;
+      pending.pop_back();
+
+      // down the left side as far as both trees go
+      for (;;)
+      {
+         d->data = s->data;
 
-   assign(pDest->pLeft, pSrc->pLeft);
-   assign(pDest->pRight, pSrc->pRight);
-   
-   if (pDest->pLeft != nullptr)
-      pDest->pLeft->pParent = pDest;
+         if (s->pRight == nullptr)
+            clear(d->pRight);
+         else if (d->pRight == nullptr) {
+            d->pRight = copy(s->pRight);
+            d->pRight->pParent = d;
+         }
+         else {
+            d->pRight->pParent = d;
+            pending.push_back(std::make_pair(s->pRight, d->pRight));
+         }
 
-   if (pDest->pRight != nullptr)
-      pDest->pRight->pParent = pDest;
+         if (s->pLeft == nullptr) {
+            clear(d->pLeft);
+            break;
+         }
+         if (d->pLeft == nullptr) {
+            d->pLeft = copy(s->pLeft);
+            d->pLeft->pParent = d;
+            break;
+         }
+         d->pLeft->pParent = d;
+         s = s->pLeft;
+         d = d->pLeft;
+      }
+   }
 }
@@ -34,6 +34,7 @@ public:
       test_copy_nullptr();
       test_copy_one();
       test_copy_standard();
+      test_copy_deep();
 
       // Assign
       test_assign_emptyToEmpty();
@@ -42,6 +43,7 @@ public:
       test_assign_oneToStandard();
       test_assign_standardToOne();
       test_assign_standardToStandard();
+      test_assign_deep();
       test_swap_emptyEmpty();
       test_swap_emptyStandard();
       test_swap_standardEmpty();
@@ -60,16 +62,19 @@ public:
       test_addLeft_standardTree();
       test_addRight_oneTree();
       test_addRight_standardTree();
+      test_addLeft_deepValue();
 
       //// Remove
       test_clear_empty();
       test_clear_one();
       test_clear_standard();
+      test_clear_deep();
 
       //// Status
       test_size_empty();
       test_size_one();
       test_size_standard();
+      test_size_deep();
 
       report("BNode");
    }
@@ -216,6 +221,22 @@ public:
       teardownStandardFixture(pDest);
    }
 
+   // copy a tree far too deep to copy recursively
+   void test_copy_deep()
+   {  // setup
+      BNode <int>* pSrc = setupChain(DEEP, true /* isLeft */);
+      BNode <int>* pDest = nullptr;
+      // exercise
+      pDest = copy(pSrc);
+      // verify
+      assertUnit(pDest != pSrc);
+      assertUnit(isChain(pDest, DEEP, true /* isLeft */));
+      assertUnit(isChain(pSrc, DEEP, true /* isLeft */));
+      // teardown
+      clear(pSrc);
+      clear(pDest);
+   }
+
    /***************************************
     * Assignment
     *    void assign(BNode <T> * & pDest, const BNode <T>* pSrc)
@@ -387,6 +408,21 @@ public:
      teardownStandardFixture(pDest);
    }
 
+   // assign a deep tree onto a short one leaning the other way
+   void test_assign_deep()
+   {  // setup
+      BNode <int>* pSrc = setupChain(DEEP, true /* isLeft */);
+      BNode <int>* pDest = setupChain(100, false /* isLeft */);
+      // exercise
+      assign(pDest, pSrc);
+      // verify
+      assertUnit(isChain(pDest, DEEP, true /* isLeft */));
+      assertUnit(isChain(pSrc, DEEP, true /* isLeft */));
+      // teardown
+      clear(pSrc);
+      clear(pDest);
+   }
+
    /***************************************
     * SWAP
     ***************************************/
@@ -538,11 +574,35 @@ public:
       teardownStandardFixture(p);
    }
 
+   // size of a tree far too deep to count recursively
+   void test_size_deep()
+   {  // setup
+      BNode <int>* p = setupChain(DEEP, true /* isLeft */);
+      // exercise
+      size_t s = size(p);
+      // verify
+      assertUnit(s == DEEP);
+      // teardown
+      clear(p);
+   }
+
    /***************************************
     * ADD 
     * addLeft() and addRight()
     ***************************************/
 
+   // add to the bottom of a tree far too deep to walk recursively
+   void test_addLeft_deepValue()
+   {  // setup
+      BNode <int>* p = setupChain(DEEP, true /* isLeft */);
+      // exercise
+      addLeft(p, int(DEEP));
+      // verify
+      assertUnit(isChain(p, DEEP + 1, true /* isLeft */));
+      // teardown
+      clear(p);
+   }
+
    // add one copy-value to the left of a single-node btree
    void test_addLeft_oneValue()
    {  // setup
@@ -1209,7 +1269,56 @@ public:
       assertUnit(p == nullptr);
    }  // teardown
 
+   // clear a tree far too deep to clear recursively
+   void test_clear_deep()
+   {  // setup
+      BNode <int>* p = setupChain(DEEP, false /* isLeft */);
+      // exercise
+      clear(p);
+      // verify
+      assertUnit(p == nullptr);
+   }  // teardown
+
+
 
+   /*************************************************************
+    * SETUP CHAIN
+    * num nodes, each the left (or right) child of the one
+    * before: 0, 1, 2, ... As deep as a tree can be.
+    *************************************************************/
+   static const int DEEP = 300000;
+   BNode <int>* setupChain(int num, bool isLeft)
+   {
+      BNode <int>* pRoot = new BNode <int>(0);
+      BNode <int>* pBottom = pRoot;
+      for (int i = 1; i < num; i++)
+      {
+         BNode <int>* pNew = new BNode <int>(i);
+         (isLeft ? pBottom->pLeft : pBottom->pRight) = pNew;
+         pNew->pParent = pBottom;
+         pBottom = pNew;
+      }
+      return pRoot;
+   }
+
+   /*************************************************************
+    * IS CHAIN
+    * Is this exactly what setupChain() would make?
+    *************************************************************/
+   bool isChain(const BNode <int>* pRoot, int num, bool isLeft)
+   {
+      const BNode <int>* pParent = nullptr;
+      const BNode <int>* p = pRoot;
+      for (int i = 0; i < num; i++)
+      {
+         if (p == nullptr || p->data != i || p->pParent != pParent ||
+             (isLeft ? p->pRight : p->pLeft) != nullptr)
+            return false;
+         pParent = p;
+         p = isLeft ? p->pLeft : p->pRight;
+      }
+      return p == nullptr;
+   }
 
    /*************************************************************
     * SETUP STANDARD FIXTURE
@@ -0,0 +1,125 @@
+/***********************************************************************
+ * Program:
+ *    Bench B-Tree
+ * Summary:
+ *    Nanoseconds per insert, find, and step of iteration for
+ *    custom::map, std::map, and custom::btree_map, with N unique int
+ *    keys in random order for N from 1K up to a limit.
+ *
+ *    This is a stand-alone program and is not part of the unit test
+ *    project. Build it with optimization, for example:
+ *       g++ -std=c++14 -O2 benchBTree.cpp -o benchBTree
+ *    By default it stops at 10M keys. Give the limit as an argument
+ *    to go further; 100M keys needs several GB for custom::map:
+ *       ./benchBTree 100000000
+ * Author
+ *    Gabe Lytle, M. Scott O'Connor
+ ************************************************************************/
+
+#include "map.h"      // for MAP
+#include "btree.h"    // for BTREE_MAP
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <random>
+#include <vector>
+
+/*************************************************
+ * TIMES
+ * Nanoseconds per operation for one container
+ *************************************************/
+struct Times
+{
+   double insert;
+   double find;
+   double iterate;
+};
+
+/*************************************************
+ * ELAPSED
+ * Nanoseconds per item since start
+ *************************************************/
+double elapsed(std::chrono::steady_clock::time_point start, size_t num)
+{
+   std::chrono::duration <double, std::nano> ns = std::chrono::steady_clock::now() - start;
+   return ns.count() / num;
+}
+
+/*************************************************
+ * RUN
+ * Insert every key, find every key in a different
+ * order, then walk the whole container
+ *************************************************/
+template <class Map, class Insert>
+Times run(const std::vector <int> & keysInsert, const std::vector <int> & keysFind, Insert insert)
+{
+   Times times;
+   Map m;
+
+   auto start = std::chrono::steady_clock::now();
+   for (int k : keysInsert)
+      insert(m, k);
+   times.insert = elapsed(start, keysInsert.size());
+
+   long long sum = 0;
+   start = std::chrono::steady_clock::now();
+   for (int k : keysFind)
+      sum += (*m.find(k)).second;
+   times.find = elapsed(start, keysFind.size());
+
+   start = std::chrono::steady_clock::now();
+   for (auto it = m.begin(); it != m.end(); ++it)
+      sum -= (*it).second;
+   times.iterate = elapsed(start, keysInsert.size());
+
+   if (sum != 0)
+      std::cerr << "ERROR: lost keys\n";
+   return times;
+}
+
+/*************************************************
+ * DISPLAY
+ *************************************************/
+void display(const char* name, size_t num, const Times & times)
+{
+   std::cout << std::setw(11) << num
+             << std::setw(18) << name
+             << std::fixed << std::setprecision(1)
+             << std::setw(10) << times.insert
+             << std::setw(10) << times.find
+             << std::setw(10) << times.iterate << '\n';
+}
+
+/**********************************************************************
+ * MAIN
+ * One row per container for each key count, in nanoseconds per key
+ ***********************************************************************/
+int main(int argc, char** argv)
+{
+   size_t numMax = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+   std::mt19937 random(232);
+
+   std::cout << "       keys         container    insert      find   iterate   (ns/key)\n";
+   for (size_t num = 1000; num <= numMax; num *= 10)
+   {
+      std::vector <int> keysInsert(num);
+      for (size_t i = 0; i < num; i++)
+         keysInsert[i] = (int)i;
+      std::shuffle(keysInsert.begin(), keysInsert.end(), random);
+      std::vector <int> keysFind(keysInsert);
+      std::shuffle(keysFind.begin(), keysFind.end(), random);
+
+      display("custom::map", num, run <custom::map <int, int>>(keysInsert, keysFind,
+         [](custom::map <int, int> & m, int k) { m.insert(custom::pair <int, int>(k, k)); }));
+      display("std::map", num, run <std::map <int, int>>(keysInsert, keysFind,
+         [](std::map <int, int> & m, int k) { m.emplace(k, k); }));
+      display("custom::btree_map", num, run <custom::btree_map <int, int>>(keysInsert, keysFind,
+         [](custom::btree_map <int, int> & m, int k) { m.insert(custom::pair <int, int>(k, k)); }));
+   }
+
+   return 0;
+}
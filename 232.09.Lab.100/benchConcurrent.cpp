@@ -0,0 +1,105 @@
+/***********************************************************************
+ * Program:
+ *    Bench Concurrent
+ * Summary:
+ *    Millions of operations per second on a map of 100K int keys
+ *    shared by T threads, each looking up random keys and now and
+ *    then writing one: custom::map behind one std::mutex, against
+ *    concurrent_map, whose lookups take no lock. One row per thread
+ *    count and mix of reads and writes.
+ *
+ *    This is a stand-alone program and is not part of the unit test
+ *    project. Build it with optimization, for example:
+ *       g++ -std=c++14 -O2 -pthread benchConcurrent.cpp -o benchConcurrent
+ *    By default it goes up to 16 threads; give the limit as an
+ *    argument to change that. The speedup can only show with at
+ *    least as many cores as threads.
+ * Author
+ *    Gabe Lytle, M. Scott O'Connor
+ ************************************************************************/
+
+#include "map.h"            // for map
+#include "concurrentMap.h"  // for concurrent_map
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+const int NUM_KEYS = 100000;
+const int NUM_OPS = 200000;    // per thread
+
+/*************************************************
+ * MOPS
+ * Millions of operations per second when each of
+ * numThreads threads runs NUM_OPS calls of op
+ *************************************************/
+template <class Op>
+double mops(int numThreads, Op op)
+{
+   auto start = std::chrono::steady_clock::now();
+   std::vector <std::thread> threads;
+   for (int t = 0; t < numThreads; t++)
+      threads.push_back(std::thread([t, &op]()
+      {
+         std::mt19937 random(232 + t);
+         for (int i = 0; i < NUM_OPS; i++)
+            op(random);
+      }));
+   for (auto& thread : threads)
+      thread.join();
+   std::chrono::duration <double, std::micro> us = std::chrono::steady_clock::now() - start;
+   return (double)numThreads * NUM_OPS / us.count();
+}
+
+/**********************************************************************
+ * MAIN
+ * One row per thread count and write percentage
+ ***********************************************************************/
+int main(int argc, char** argv)
+{
+   int numThreadsMax = argc > 1 ? std::atoi(argv[1]) : 16;
+
+   custom::map <int, int> m;
+   std::mutex mutexMap;
+   custom::concurrent_map <int, int> cm;
+   for (int k = 0; k < NUM_KEYS; k++)
+   {
+      m[k] = k;
+      cm.insert_or_assign(k, k);
+   }
+
+   std::cout << "   threads  writes   map+mutex  concurrent_map   (Mops/s)\n";
+   for (int numThreads = 1; numThreads <= numThreadsMax; numThreads *= 2)
+      for (int percentWrite : { 0, 1, 10 })
+      {
+         std::cout << std::setw(10) << numThreads << std::setw(7) << percentWrite << '%'
+                   << std::fixed << std::setprecision(2);
+
+         std::cout << std::setw(12) << mops(numThreads, [&](std::mt19937& random)
+         {
+            int k = (int)(random() % NUM_KEYS);
+            std::lock_guard <std::mutex> guard(mutexMap);
+            if ((int)(random() % 100) < percentWrite)
+               m[k] = k + 1;
+            else if (m.find(k) == m.end())
+               std::cerr << "ERROR: key missing\n";
+         });
+
+         std::cout << std::setw(16) << mops(numThreads, [&](std::mt19937& random)
+         {
+            int k = (int)(random() % NUM_KEYS);
+            int value;
+            if ((int)(random() % 100) < percentWrite)
+               cm.insert_or_assign(k, k + 1);
+            else if (!cm.find(k, value))
+               std::cerr << "ERROR: key missing\n";
+         }) << '\n';
+      }
+
+   return 0;
+}
@@ -0,0 +1,115 @@
+/***********************************************************************
+ * Program:
+ *    Bench Flat
+ * Summary:
+ *    custom::map against flat_map holding the same N int pairs:
+ *    nanoseconds to build it from random pairs, per lookup of a
+ *    random key (about half of them missing), and per element of a
+ *    walk from begin() to end().
+ *
+ *    This is a stand-alone program and is not part of the unit test
+ *    project. Build it with optimization, for example:
+ *       g++ -std=c++14 -O2 benchFlat.cpp -o benchFlat
+ *    By default it stops at 1M elements; give the limit as an
+ *    argument to change that.
+ * Author
+ *    Gabe Lytle, M. Scott O'Connor
+ ************************************************************************/
+
+#include "map.h"        // for map
+#include "flatMap.h"    // for flat_map
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+const size_t NUM_LOOKUPS = 1000000;
+
+/*************************************************
+ * NANOSECONDS
+ * How long f() takes, divided by num
+ *************************************************/
+template <class F>
+double nanoseconds(size_t num, F f)
+{
+   auto start = std::chrono::steady_clock::now();
+   f();
+   std::chrono::duration <double, std::nano> ns = std::chrono::steady_clock::now() - start;
+   return ns.count() / num;
+}
+
+/*************************************************
+ * COLUMNS
+ * Build, lookup, and walk times for one container
+ *************************************************/
+template <class Map>
+void columns(const std::vector <custom::pair <int, int>>& pairs,
+             const std::vector <int>& keys, size_t numExpected)
+{
+   Map m;
+   double nsBuild = nanoseconds(pairs.size(), [&]()
+   {
+      m = Map(pairs.begin(), pairs.end());
+   });
+
+   size_t numFound = 0;
+   double nsFind = nanoseconds(keys.size(), [&]()
+   {
+      for (int k : keys)
+         numFound += m.find(k) != m.end();
+   });
+
+   long long sum = 0;
+   double nsWalk = nanoseconds(m.size(), [&]()
+   {
+      for (auto it = m.begin(); it != m.end(); ++it)
+         sum += (*it).second;
+   });
+
+   if (numFound != numExpected || sum == 0)
+      std::cerr << "ERROR: lookups disagree\n";
+   std::cout << std::setw(9) << nsBuild << std::setw(7) << nsFind
+             << std::setw(7) << nsWalk;
+}
+
+/**********************************************************************
+ * MAIN
+ * One row per size: build, find, and walk for each container, in
+ * nanoseconds per element or per lookup
+ ***********************************************************************/
+int main(int argc, char** argv)
+{
+   size_t numMax = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+   std::mt19937 random(232);
+
+   std::cout << "              map                   flat_map\n"
+             << "   elements    build   find   walk    build   find   walk"
+             << "   (ns)\n";
+   for (size_t num = 10; num <= numMax; num *= 10)
+   {
+      // the even numbers with their halves, in random order
+      std::vector <custom::pair <int, int>> pairs;
+      for (size_t i = 0; i < num; i++)
+         pairs.push_back(custom::pair <int, int>((int)(i * 2), (int)i + 1));
+      std::shuffle(pairs.begin(), pairs.end(), random);
+
+      std::vector <int> keys(NUM_LOOKUPS);
+      size_t numExpected = 0;
+      for (size_t i = 0; i < NUM_LOOKUPS; i++)
+      {
+         keys[i] = (int)(random() % (num * 2));
+         numExpected += !(keys[i] & 1);
+      }
+
+      std::cout << std::setw(11) << num << std::fixed << std::setprecision(1);
+      columns <custom::map <int, int>>(pairs, keys, numExpected);
+      columns <custom::flat_map <int, int>>(pairs, keys, numExpected);
+      std::cout << '\n';
+   }
+
+   return 0;
+}
@@ -0,0 +1,97 @@
+/***********************************************************************
+ * Program:
+ *    Bench Persistent
+ * Summary:
+ *    Microseconds per update for a writer that hands a consistent
+ *    copy of N ints to its readers after every insert, replacing the
+ *    copy it handed out before: copying the whole BST each time,
+ *    against taking a snapshot of a persistent_set, which shares all
+ *    but the path it changed.
+ *
+ *    This is a stand-alone program and is not part of the unit test
+ *    project. Build it with optimization, for example:
+ *       g++ -std=c++14 -O2 -pthread benchPersistent.cpp -o benchPersistent
+ *    By default it stops at 1M elements; give the limit as an argument
+ *    to change that.
+ * Author
+ *    Gabe Lytle, M. Scott O'Connor
+ ************************************************************************/
+
+#include "bst.h"          // for BST
+#include "persistent.h"   // for persistent_set
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+const int NUM_UPDATES = 100;
+
+/*************************************************
+ * ELAPSED
+ * Microseconds per update since start
+ *************************************************/
+double elapsed(Clock::time_point start)
+{
+   std::chrono::duration <double, std::micro> us = Clock::now() - start;
+   return us.count() / NUM_UPDATES;
+}
+
+/**********************************************************************
+ * MAIN
+ * One row per size, in microseconds per update
+ ***********************************************************************/
+int main(int argc, char** argv)
+{
+   size_t numMax = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+   std::mt19937 random(232);
+
+   std::cout << "   elements   BST insert+copy   persistent insert+snapshot"
+             << "   (us/update)\n";
+   for (size_t num = 1000; num <= numMax; num *= 10)
+   {
+      std::vector <int> values(num + NUM_UPDATES);
+      for (size_t i = 0; i < values.size(); i++)
+         values[i] = (int)random();
+
+      custom::BST <int> bst;
+      custom::persistent_set <int> s;
+      for (size_t i = 0; i < num; i++)
+      {
+         bst.insert(values[i], true /* keepUnique */);
+         s.insert(values[i]);
+      }
+
+      std::cout << std::setw(11) << num << std::fixed << std::setprecision(2);
+
+      {
+         custom::BST <int> published;
+         auto start = Clock::now();
+         for (int i = 0; i < NUM_UPDATES; i++)
+         {
+            bst.insert(values[num + i], true /* keepUnique */);
+            published = custom::BST <int>(bst);
+         }
+         std::cout << std::setw(18) << elapsed(start);
+      }
+
+      {
+         custom::persistent_set <int> published;
+         auto start = Clock::now();
+         for (int i = 0; i < NUM_UPDATES; i++)
+         {
+            s.insert(values[num + i]);
+            published = s.snapshot();
+         }
+         std::cout << std::setw(29) << elapsed(start) << '\n';
+         if (published.size() != bst.size())
+            std::cerr << "ERROR: versions differ\n";
+      }
+   }
+
+   return 0;
+}
@@ -0,0 +1,110 @@
+/***********************************************************************
+ * Program:
+ *    Bench Scan
+ * Summary:
+ *    Nanoseconds per element to walk a whole BST or map in order:
+ *    the iterator, which climbs pParent links to find the next node,
+ *    against the stack_iterator and for_each(), which keep the way
+ *    back up on a stack of their own. The keys go in in random order,
+ *    so neighbors in the tree are not neighbors in memory.
+ *
+ *    This is a stand-alone program and is not part of the unit test
+ *    project. Build it with optimization, for example:
+ *       g++ -std=c++14 -O2 benchScan.cpp -o benchScan
+ *    By default it stops at 10M elements; give the limit as an
+ *    argument to change that.
+ * Author
+ *    Gabe Lytle, M. Scott O'Connor
+ ************************************************************************/
+
+#include "map.h"      // for MAP and BST
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+/*************************************************
+ * TIME
+ * Nanoseconds per element for one scan, checking
+ * that it saw everything
+ *************************************************/
+template <class Scan>
+double time(size_t num, long long sumExpected, Scan scan)
+{
+   auto start = std::chrono::steady_clock::now();
+   long long sum = scan();
+   std::chrono::duration <double, std::nano> ns = std::chrono::steady_clock::now() - start;
+   if (sum != sumExpected)
+      std::cerr << "ERROR: scan missed elements\n";
+   return ns.count() / num;
+}
+
+/**********************************************************************
+ * MAIN
+ * One row per size, in nanoseconds per element
+ ***********************************************************************/
+int main(int argc, char** argv)
+{
+   size_t numMax = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+   std::mt19937 random(232);
+
+   std::cout << "   elements   BST iterator  stack_iterator  for_each"
+             << "   map iterator  for_each   (ns/element)\n";
+   for (size_t num = 1000; num <= numMax; num *= 10)
+   {
+      std::vector <int> keys(num);
+      for (size_t i = 0; i < num; i++)
+         keys[i] = (int)i;
+      std::shuffle(keys.begin(), keys.end(), random);
+      long long sumExpected = (long long)num * (num - 1) / 2;
+
+      custom::BST <int> bst;
+      custom::map <int, int> m;
+      for (int k : keys)
+      {
+         bst.insert(k);
+         m.insert(custom::pair <int, int>(k, k));
+      }
+
+      std::cout << std::setw(11) << num << std::fixed << std::setprecision(1);
+      std::cout << std::setw(15) << time(num, sumExpected, [&bst]()
+      {
+         long long sum = 0;
+         for (auto it = bst.begin(); it != bst.end(); ++it)
+            sum += *it;
+         return sum;
+      });
+      std::cout << std::setw(16) << time(num, sumExpected, [&bst]()
+      {
+         long long sum = 0;
+         for (auto it = bst.scan_begin(); it != bst.scan_end(); ++it)
+            sum += *it;
+         return sum;
+      });
+      std::cout << std::setw(10) << time(num, sumExpected, [&bst]()
+      {
+         long long sum = 0;
+         bst.for_each([&sum](int value) { sum += value; });
+         return sum;
+      });
+      std::cout << std::setw(15) << time(num, sumExpected, [&m]()
+      {
+         long long sum = 0;
+         for (auto it = m.begin(); it != m.end(); ++it)
+            sum += (*it).second;
+         return sum;
+      });
+      std::cout << std::setw(10) << time(num, sumExpected, [&m]()
+      {
+         long long sum = 0;
+         m.for_each([&sum](custom::pair <int, int>& p) { sum += p.second; });
+         return sum;
+      }) << '\n';
+   }
+
+   return 0;
+}
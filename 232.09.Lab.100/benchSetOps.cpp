@@ -0,0 +1,158 @@
+/***********************************************************************
+ * Program:
+ *    Bench Set Operations
+ * Summary:
+ *    Milliseconds to take the union, intersection, and difference of
+ *    two BSTs of N random unique ints: one element at a time through
+ *    insert() and erase(), against unite(), intersect(), and subtract(),
+ *    which split and join whole subtrees. As those empty the right-hand
+ *    tree, the one-at-a-time versions clear it too. Also microseconds
+ *    for a split() down the middle of a Ranked tree and the join() back.
+ *
+ *    This is a stand-alone program and is not part of the unit test
+ *    project. Build it with optimization, for example:
+ *       g++ -std=c++14 -O2 -pthread benchSetOps.cpp -o benchSetOps
+ *    By default it stops at 1M elements; give the limit as an argument
+ *    to change that.
+ * Author
+ *    Gabe Lytle, M. Scott O'Connor
+ ************************************************************************/
+
+#include "bst.h"      // for BST
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <set>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+/*************************************************
+ * ELAPSED
+ * Milliseconds since start
+ *************************************************/
+double elapsed(Clock::time_point start)
+{
+   std::chrono::duration <double, std::milli> ms = Clock::now() - start;
+   return ms.count();
+}
+
+/*************************************************
+ * FILL
+ * A tree of num unique random values
+ *************************************************/
+void fill(custom::BST <int> & bst, size_t num, std::mt19937 & random)
+{
+   std::set <int> values;
+   while (values.size() < num)
+      values.insert((int)(random() % (num * 4)));
+   custom::BST <int> bstSorted(custom::sorted_range, values.begin(), values.end());
+   bst = std::move(bstSorted);
+}
+
+/**********************************************************************
+ * MAIN
+ * One row per size, in milliseconds per operation
+ ***********************************************************************/
+int main(int argc, char** argv)
+{
+   size_t numMax = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+   std::mt19937 random(232);
+
+   std::cout << "   elements   insert  unite   erase  intersect  erase  subtract"
+             << "   split  join (us)\n";
+   for (size_t num = 1000; num <= numMax; num *= 10)
+   {
+      custom::BST <int> bst1;
+      custom::BST <int> bst2;
+      fill(bst1, num, random);
+      fill(bst2, num, random);
+
+      std::cout << std::setw(11) << num << std::fixed << std::setprecision(1);
+
+      // union
+      {
+         custom::BST <int> bstA(bst1);
+         custom::BST <int> bstB(bst2);
+         auto start = Clock::now();
+         for (auto it = bstB.begin(); it != bstB.end(); ++it)
+            bstA.insert(*it, true /* keepUnique */);
+         bstB.clear();
+         std::cout << std::setw(9) << elapsed(start);
+
+         custom::BST <int> bstC(bst1);
+         custom::BST <int> bstD(bst2);
+         start = Clock::now();
+         bstC.unite(bstD);
+         std::cout << std::setw(7) << elapsed(start);
+         if (bstA.size() != bstC.size())
+            std::cerr << "ERROR: unions differ\n";
+      }
+
+      // intersection
+      {
+         custom::BST <int> bstA(bst1);
+         custom::BST <int> bstB(bst2);
+         auto start = Clock::now();
+         for (auto it = bstA.begin(); it != bstA.end(); )
+            if (bstB.find(*it) == bstB.end())
+               it = bstA.erase(it);
+            else
+               ++it;
+         bstB.clear();
+         std::cout << std::setw(8) << elapsed(start);
+
+         custom::BST <int> bstC(bst1);
+         custom::BST <int> bstD(bst2);
+         start = Clock::now();
+         bstC.intersect(bstD);
+         std::cout << std::setw(11) << elapsed(start);
+         if (bstA.size() != bstC.size())
+            std::cerr << "ERROR: intersections differ\n";
+      }
+
+      // difference
+      {
+         custom::BST <int> bstA(bst1);
+         custom::BST <int> bstB(bst2);
+         auto start = Clock::now();
+         for (auto it = bstB.begin(); it != bstB.end(); ++it)
+         {
+            auto itFound = bstA.find(*it);
+            if (itFound != bstA.end())
+               bstA.erase(itFound);
+         }
+         bstB.clear();
+         std::cout << std::setw(7) << elapsed(start);
+
+         custom::BST <int> bstC(bst1);
+         custom::BST <int> bstD(bst2);
+         start = Clock::now();
+         bstC.subtract(bstD);
+         std::cout << std::setw(10) << elapsed(start);
+         if (bstA.size() != bstC.size())
+            std::cerr << "ERROR: differences differ\n";
+      }
+
+      // split down the middle and join back: a Ranked tree knows the
+      // size of each part without counting
+      {
+         custom::BST <int, std::allocator <int>, true> bstA(custom::sorted_range, bst1.begin(), bst1.end());
+         auto start = Clock::now();
+         auto bstB = bstA.split((int)(num * 2));
+         double msSplit = elapsed(start);
+         start = Clock::now();
+         bstA.join(bstB);
+         double msJoin = elapsed(start);
+         std::cout << std::setw(8) << msSplit * 1000.0
+                   << std::setw(6) << msJoin * 1000.0 << '\n';
+         if (bstA.size() != num)
+            std::cerr << "ERROR: split and join lost elements\n";
+      }
+   }
+
+   return 0;
+}
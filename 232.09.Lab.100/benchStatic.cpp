@@ -0,0 +1,98 @@
+/***********************************************************************
+ * Program:
+ *    Bench Static
+ * Summary:
+ *    Nanoseconds per lookup of a random key in N ints: find() in a
+ *    BST, against std::lower_bound on a sorted std::vector, against
+ *    find() in a static_set frozen from the same BST. About half of
+ *    the keys looked up are missing.
+ *
+ *    This is a stand-alone program and is not part of the unit test
+ *    project. Build it with optimization, for example:
+ *       g++ -std=c++14 -O2 benchStatic.cpp -o benchStatic
+ *    By default it stops at 10M elements; give the limit as an
+ *    argument to change that.
+ * Author
+ *    Gabe Lytle, M. Scott O'Connor
+ ************************************************************************/
+
+#include "staticSet.h"  // for static_set and freeze
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+const size_t NUM_LOOKUPS = 1000000;
+
+/*************************************************
+ * TIME
+ * Nanoseconds per lookup, checking that all the
+ * containers found the same keys
+ *************************************************/
+template <class Find>
+double time(const std::vector <int>& keys, size_t numExpected, Find find)
+{
+   auto start = std::chrono::steady_clock::now();
+   size_t numFound = 0;
+   for (int k : keys)
+      numFound += find(k);
+   std::chrono::duration <double, std::nano> ns = std::chrono::steady_clock::now() - start;
+   if (numFound != numExpected)
+      std::cerr << "ERROR: lookups disagree\n";
+   return ns.count() / keys.size();
+}
+
+/**********************************************************************
+ * MAIN
+ * One row per size, in nanoseconds per lookup
+ ***********************************************************************/
+int main(int argc, char** argv)
+{
+   size_t numMax = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+   std::mt19937 random(232);
+
+   std::cout << "   elements   BST find  vector lower_bound  static_set find"
+             << "   (ns/lookup)\n";
+   for (size_t num = 1000; num <= numMax; num *= 10)
+   {
+      // the even numbers, inserted in random order
+      std::vector <int> values(num);
+      for (size_t i = 0; i < num; i++)
+         values[i] = (int)(i * 2);
+      std::shuffle(values.begin(), values.end(), random);
+      custom::BST <int> bst;
+      for (int value : values)
+         bst.insert(value);
+      std::sort(values.begin(), values.end());
+      custom::static_set <int> s = custom::freeze(bst);
+
+      std::vector <int> keys(NUM_LOOKUPS);
+      size_t numExpected = 0;
+      for (size_t i = 0; i < NUM_LOOKUPS; i++)
+      {
+         keys[i] = (int)(random() % (num * 2));
+         numExpected += !(keys[i] & 1);
+      }
+
+      std::cout << std::setw(11) << num << std::fixed << std::setprecision(1);
+      std::cout << std::setw(11) << time(keys, numExpected, [&bst](int k)
+      {
+         return bst.find(k) != bst.end();
+      });
+      std::cout << std::setw(20) << time(keys, numExpected, [&values](int k)
+      {
+         auto it = std::lower_bound(values.begin(), values.end(), k);
+         return it != values.end() && *it == k;
+      });
+      std::cout << std::setw(17) << time(keys, numExpected, [&s](int k)
+      {
+         return s.find(k) != s.end();
+      }) << '\n';
+   }
+
+   return 0;
+}
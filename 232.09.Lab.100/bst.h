@@ -26,52 +26,264 @@
 #endif // !DEBUG
 
 #include <cassert>
+#include <cstdint>    // for uintptr_t
 #include <utility>
 #include <memory>     // for std::allocator
 #include <functional> // for std::less
+#include <iterator>   // for std::iterator_traits
 #include <utility>    // for std::pair
 #include <stack>
+#include <stdexcept>   // for std::invalid_argument
+#include <type_traits> // for std::is_trivially_destructible
+#include <future>     // for std::async in the set operations
+#include <thread>     // for std::thread::hardware_concurrency
 
 class TestBST; // forward declaration for unit tests
 class TestMap;
 class TestSet;
+class TestMultiMap;
+class TestSlabAllocator;
 
 namespace custom
 {
 
    template <class TT>
    class set;
-   template <class KK, class VV>
+   template <class KK, class VV, class AA>
    class map;
+   template <class TT, class AA, class II>
+   class multi_tree;
+   template <class T1, class T2, typename C>
+   class pair;
+
+   /*****************************************************************
+    * KEY OF
+    * What a BST compares when it is searched by key: the value
+    * itself, or the first of a pair so that a map can be searched
+    * by key alone. before() and after() say whether a value's key
+    * sorts before or after a search key, the same way the values
+    * sort among themselves.
+    *****************************************************************/
+   template <class T>
+   struct keyOf
+   {
+      const T& operator () (const T& t) const { return t; }
+
+      template <class K>
+      static bool before(const T& t, const K& k) { return t < k; }
+      template <class K>
+      static bool after(const T& t, const K& k) { return k < t; }
+   };
+
+   /*****************************************************************
+    * KEY OF PAIR
+    * A pair sorts by its comparator C, so its key does too. When C
+    * is only std::less the key is compared with < directly, so a
+    * key of another type, such as a C string for a std::string,
+    * is not converted to T1 first.
+    *****************************************************************/
+   template <class T1, class T2, typename C>
+   struct keyOf <pair <T1, T2, C>>
+   {
+      const T1& operator () (const pair <T1, T2, C>& p) const { return p.first; }
+
+      template <class K>
+      static bool before(const pair <T1, T2, C>& p, const K& k)
+      {
+         return before(p, k, IsLess());
+      }
+      template <class K>
+      static bool after(const pair <T1, T2, C>& p, const K& k)
+      {
+         return after(p, k, IsLess());
+      }
+
+   private:
+      typedef std::integral_constant <bool,
+         std::is_same <C, std::less <T1>>::value ||
+         std::is_same <C, std::less <>>::value> IsLess;
+
+      template <class K>
+      static bool before(const pair <T1, T2, C>& p, const K& k, std::true_type)
+      {
+         return p.first < k;
+      }
+      template <class K>
+      static bool before(const pair <T1, T2, C>& p, const K& k, std::false_type)
+      {
+         return p.template compare <T1> (p.first, k);
+      }
+      template <class K>
+      static bool after(const pair <T1, T2, C>& p, const K& k, std::true_type)
+      {
+         return k < p.first;
+      }
+      template <class K>
+      static bool after(const pair <T1, T2, C>& p, const K& k, std::false_type)
+      {
+         return p.template compare <T1> (k, p.first);
+      }
+   };
+
+   /*****************************************************************
+    * SORTED RANGE
+    * Passed ahead of a range the caller promises is already in
+    * order, so the tree can be built in one pass
+    *****************************************************************/
+   struct sorted_range_t {};
+   const sorted_range_t sorted_range = sorted_range_t();
+
+   /*****************************************************************
+    * IN PLACE
+    * Passed ahead of the arguments of a value's constructor, so the
+    * value is built right where it will live rather than copied in
+    *****************************************************************/
+   struct in_place_t {};
+   const in_place_t in_place = in_place_t();
+
+   /*****************************************************************
+    * NODE COUNT
+    * The number of nodes in the subtree under a node. Only trees
+    * that answer rank queries keep it; for the rest it takes no
+    * space and every update does nothing.
+    *****************************************************************/
+   template <bool Ranked>
+   class NodeCount
+   {
+   public:
+      size_t count() const { return numNodes; }
+      void setCount(size_t num) { numNodes = num; }
+   private:
+      size_t numNodes = 1;
+   };
+
+   template <>
+   class NodeCount <false>
+   {
+   public:
+      size_t count() const { return 0; }
+      void setCount(size_t) {}
+   };
+
+   /*****************************************************************
+    * NODE FIELDS
+    * The value, color, and links of a node, laid out so the color
+    * costs no space of its own. It goes right after the value, in
+    * the padding the value leaves before the first pointer. A value
+    * that is a whole number of pointers long leaves none, so then
+    * the color is kept in the low bit of the parent pointer, which
+    * is always 0 since a node is aligned to at least two bytes.
+    *****************************************************************/
+   template <class Node, class T, bool Packed = sizeof(T) % alignof(Node*) == 0>
+   class NodeFields
+   {
+   public:
+      NodeFields() : data(), isRed(true), pLeft(nullptr), pRight(nullptr), pParent(nullptr) {}
+      NodeFields(const T& t) : data(t), isRed(true), pLeft(nullptr), pRight(nullptr), pParent(nullptr) {}
+      NodeFields(T&& t) : data(std::move(t)), isRed(true), pLeft(nullptr), pRight(nullptr), pParent(nullptr) {}
+      template <class ... Args>
+      NodeFields(in_place_t, Args&& ... args) : data(std::forward<Args>(args)...), isRed(true),
+         pLeft(nullptr), pRight(nullptr), pParent(nullptr) {}
+
+      T data;                  // Actual data stored in the BNode
+      bool isRed;              // Red-black balancing stuff: new nodes are red
+      Node* pLeft;             // Left child - smaller
+      Node* pRight;            // Right child - larger
+      Node* pParent;           // Parent
+   };
+
+   /*****************************************************************
+    * NODE FIELDS, PACKED
+    * pParent and isRed share one word. Each is a proxy over that
+    * word that reads and writes only its own bits, so the tree uses
+    * them as it would a Node* and a bool.
+    *****************************************************************/
+   template <class Node, class T>
+   class NodeFields <Node, T, true>
+   {
+      static const uintptr_t RED = 1;
+   public:
+      // the parent pointer: every bit but the lowest
+      struct Parent
+      {
+         operator Node* () const { return reinterpret_cast<Node*>(bits & ~RED); }
+         Node* operator -> () const { return *this; }
+         Parent& operator = (Node* p)
+         {
+            bits = reinterpret_cast<uintptr_t>(p) | (bits & RED);
+            return *this;
+         }
+         Parent& operator = (const Parent& rhs) { return *this = static_cast<Node*>(rhs); }
+         uintptr_t bits;
+      };
+
+      // the color: the lowest bit alone
+      struct Color
+      {
+         operator bool () const { return (bits & RED) != 0; }
+         Color& operator = (bool isRed)
+         {
+            bits = (bits & ~RED) | (isRed ? RED : 0);
+            return *this;
+         }
+         Color& operator = (const Color& rhs) { return *this = static_cast<bool>(rhs); }
+         uintptr_t bits;
+      };
+
+      NodeFields() : data(), pLeft(nullptr), pRight(nullptr), pParent{ RED } {}
+      NodeFields(const T& t) : data(t), pLeft(nullptr), pRight(nullptr), pParent{ RED } {}
+      NodeFields(T&& t) : data(std::move(t)), pLeft(nullptr), pRight(nullptr), pParent{ RED } {}
+      template <class ... Args>
+      NodeFields(in_place_t, Args&& ... args) : data(std::forward<Args>(args)...),
+         pLeft(nullptr), pRight(nullptr), pParent{ RED } {}
+
+      T data;                  // Actual data stored in the BNode
+      Node* pLeft;             // Left child - smaller
+      Node* pRight;            // Right child - larger
+      union
+      {
+         Parent pParent;       // Parent
+         Color isRed;          // Red-black balancing stuff: new nodes are red
+      };
+   };
 
    /*****************************************************************
     * BINARY SEARCH TREE
-    * Create a Binary Search Tree
+    * Create a Binary Search Tree. A Ranked tree counts the nodes
+    * under each node so it can find the k-th element and the rank
+    * of a value in O(log n).
     *****************************************************************/
-   template <typename T>
+   template <typename T, typename A = std::allocator<T>, bool Ranked = false>
    class BST
    {
       friend class ::TestBST; // give unit tests access to the privates
       friend class ::TestMap;
       friend class ::TestSet;
+      friend class ::TestMultiMap;
+      friend class ::TestSlabAllocator;
 
-      template <class KK, class VV>
+      template <class KK, class VV, class AA>
       friend class map;
 
       template <class TT>
       friend class set;
 
-      template <class KK, class VV>
-      friend void swap(map<KK, VV>& lhs, map<KK, VV>& rhs);
+      template <class TT, class AA, class II>
+      friend class multi_tree;
+
+      template <class KK, class VV, class AA>
+      friend void swap(map<KK, VV, AA>& lhs, map<KK, VV, AA>& rhs);
    public:
       //
       // Construct
       //
 
-      BST();
+      BST(const A& a = A());
       BST(const BST& rhs);
       BST(BST&& rhs);
-      BST(const std::initializer_list<T>& il);
+      BST(const std::initializer_list<T>& il, const A& a = A());
+      template <class Iterator>
+      BST(sorted_range_t, Iterator first, Iterator last, const A& a = A());
       ~BST();
 
       //
@@ -91,11 +303,55 @@ namespace custom
       iterator   begin() const noexcept;
       iterator   end()   const noexcept { return iterator (nullptr); }
 
+      //
+      // Scan: forward only, keeping the way back up on a stack
+      //
+
+      class stack_iterator;
+      stack_iterator scan_begin() const;
+      stack_iterator scan_end()   const;
+      template <class Visit>
+      void for_each(Visit visit) const;
+
       //
       // Access
       //
 
-      iterator find(const T& t);
+      iterator find(const T& t) const;
+
+      //
+      // Search by key: k may be a T or anything that compares with
+      // the key of a T, such as a map's key without its value
+      //
+
+      template <class K>
+      iterator find(const K& k) const;
+      template <class K>
+      iterator lower_bound(const K& k) const;
+      template <class K>
+      iterator upper_bound(const K& k) const;
+      template <class K>
+      std::pair<iterator, iterator> equal_range(const K& k) const
+      {
+         return std::pair<iterator, iterator>(lower_bound(k), upper_bound(k));
+      }
+
+      //
+      // Range: everything in [lo, hi)
+      //
+
+      template <class K>
+      size_t count_range(const K& lo, const K& hi) const;
+      template <class K, class Visit>
+      void visit_range(const K& lo, const K& hi, Visit visit) const;
+
+      //
+      // Order statistics: only for a Ranked tree
+      //
+
+      iterator nth_element(size_t k) const;
+      template <class K>
+      size_t rank(const K& k) const;
 
       // 
       // Insert
@@ -103,6 +359,26 @@ namespace custom
 
       std::pair<iterator, bool> insert(const T& t, bool keepUnique = false);
       std::pair<iterator, bool> insert(T&& t, bool keepUnique = false);
+      iterator insert(iterator hint, const T& t, bool keepUnique = false);
+      iterator insert(iterator hint, T&& t, bool keepUnique = false);
+
+      // insert a T built from args unless one with key k is there,
+      // in one search and without building anything if it is
+      template <class K, class ... Args>
+      std::pair<iterator, bool> emplace_key(const K& k, Args&& ... args);
+
+      //
+      // Node handles: a node taken out of one tree goes into another
+      // without being freed, built again, or copied. If the value is
+      // not taken, the handle keeps the node.
+      //
+
+      class node_handle;
+      std::pair<iterator, bool> insert(node_handle&& nh, bool keepUnique = false);
+      node_handle extract(iterator it);
+      template <class K>
+      node_handle extract(const K& k);
+      void merge(BST& rhs);
 
       //
       // Remove
@@ -111,6 +387,27 @@ namespace custom
       iterator erase(iterator& it);
       void   clear() noexcept;
 
+      //
+      // Split and join: whole subtrees change hands rather than one
+      // element at a time. Both trees must share an allocator for the
+      // nodes to move; otherwise rhs is copied first. Only a Ranked
+      // tree knows the sizes of the halves, so split is O(log n) there
+      // and O(log n + min(n1, n2)) on any other.
+      //
+
+      template <class K>
+      BST split(const K& k);
+      void join(BST& rhs);
+
+      //
+      // Set algebra on trees of unique values, taking everything
+      // out of rhs. Big trees divide the work across threads.
+      //
+
+      void unite(BST& rhs);
+      void intersect(BST& rhs);
+      void subtract(BST& rhs);
+
       // 
       // Status
       //
@@ -122,8 +419,174 @@ namespace custom
    private:
 
       class BNode;
+
+      //
+      // Red-black balancing
+      //
+
+      static bool isRedNode(const BNode* pNode) { return pNode && pNode->isRed; }
+      void rotateLeft(BNode* pNode) { rotateLeft(pNode, root); }
+      void rotateRight(BNode* pNode) { rotateRight(pNode, root); }
+      void balanceInsert(BNode* pNode) { balanceInsert(pNode, root); }
+      static void rotateLeft(BNode* pNode, BNode*& pRoot);
+      static void rotateRight(BNode* pNode, BNode*& pRoot);
+      static void balanceInsert(BNode* pNode, BNode*& pRoot);
+      static void balanceErase(BNode* pNode, BNode* pParent, BNode*& pRoot);
+      void balanceErase(BNode* pNode, BNode* pParent) { balanceErase(pNode, pParent, root); }
+      size_t deleteSubtree(BNode* pNode);
+
+      //
+      // Placing a new node
+      //
+
+      static BNode* rightmost(BNode* pNode)
+      {
+         while (pNode && pNode->pRight)
+            pNode = pNode->pRight;
+         return pNode;
+      }
+      static BNode* leftmost(BNode* pNode)
+      {
+         while (pNode && pNode->pLeft)
+            pNode = pNode->pLeft;
+         return pNode;
+      }
+      bool isAppend(const T& t, bool keepUnique) const
+      {
+         return root != nullptr && pMax != nullptr &&
+            (keepUnique ? pMax->data < t : !(t < pMax->data));
+      }
+      bool fitsBefore(BNode* pHint, const T& t, bool keepUnique,
+                      BNode*& pParent, bool& isLeft) const;
+      template <class K>
+      BNode* descend(const K& k, bool keepUnique, BNode*& pParent, bool& isLeft) const;
+      iterator attach(BNode* pParent, bool isLeft, BNode* pNode);
+      iterator place(BNode* pParent, bool isLeft, BNode* pNode);
+      BNode* unlink(BNode* pNode);
+
+      //
+      // Subtree counts
+      //
+
+      static size_t countOf(const BNode* pNode) { return pNode ? pNode->count() : 0; }
+      static void recount(BNode* pNode)
+      {
+         pNode->setCount(1 + countOf(pNode->pLeft) + countOf(pNode->pRight));
+      }
+      static void recountToRoot(BNode* pNode)
+      {
+         if (Ranked)
+            for (; pNode; pNode = pNode->pParent)
+               recount(pNode);
+      }
+      template <class K>
+      size_t rankOf(const K& k) const;
+      template <class K>
+      size_t countRange(const K& lo, const K& hi, std::true_type isRanked) const;
+      template <class K>
+      size_t countRange(const K& lo, const K& hi, std::false_type isRanked) const;
+
+      //
+      // Comparing with a search key: a whole T compares as a T,
+      // anything else compares with the T's key
+      //
+
+      static bool valueLess(const T& t, const T& u) { return t < u; }
+      template <class K>
+      static bool valueLess(const T& t, const K& k) { return keyOf<T>::before(t, k); }
+      static bool keyLess(const T& t, const T& u) { return t < u; }
+      template <class K>
+      static bool keyLess(const K& k, const T& t) { return keyOf<T>::after(t, k); }
+
+      //
+      // Node allocation
+      //
+
+      typedef typename std::allocator_traits<A>::template rebind_alloc<BNode> NodeAlloc;
+      typedef std::allocator_traits<NodeAlloc> NodeTraits;
+      template <class ... Args>
+      BNode* createNode(Args&& ... args);
+      void deleteNode(BNode* pNode);
+      template <class Alloc>
+      static auto releaseNodes(Alloc& alloc, int) -> decltype(alloc.release()) { return alloc.release(); }
+      template <class Alloc>
+      static bool releaseNodes(Alloc&, long) { return false; }
+
+      //
+      // Bulk load
+      //
+
+      template <class Iterator>
+      static bool isSorted(Iterator first, Iterator last);
+      template <class Iterator>
+      static bool canBuildSorted(Iterator first, Iterator last)
+      {
+         return canBuildSorted(first, last, typename std::iterator_traits<Iterator>::iterator_category());
+      }
+      template <class Iterator>
+      static bool canBuildSorted(Iterator first, Iterator last, std::forward_iterator_tag)
+      {
+         return isSorted(first, last);
+      }
+      template <class Iterator>
+      static bool canBuildSorted(Iterator, Iterator, std::input_iterator_tag)
+      {
+         return false;
+      }
+      template <class Iterator>
+      void buildSorted(Iterator first, Iterator last, bool keepUnique = false);
+      template <class Iterator>
+      BNode* buildBalanced(Iterator& it, size_t num, size_t depth, size_t depthRed,
+                           BNode*& pPrev, bool keepUnique);
+
+      //
+      // Split and join on bare subtrees, each with its own root
+      //
+
+      static size_t heightBlack(const BNode* pNode);
+      static BNode* detach(BNode* pNode);
+      static BNode* joinNodes(BNode* pLeft, BNode* pMid, BNode* pRight);
+      static BNode* joinNodes(BNode* pLeft, BNode* pRight);
+      static BNode* removeLast(BNode* pRoot, BNode*& pLast);
+      template <class K>
+      static void splitNodes(BNode* pNode, const K& k, BNode*& pLess, BNode*& pMore);
+      template <class K>
+      static void splitNodes(BNode* pNode, const K& k, BNode*& pLess, BNode*& pEqual, BNode*& pMore);
+
+      //
+      // Set algebra on bare subtrees. What falls out is chained
+      // through pParent onto pDropped and freed afterwards by the
+      // calling thread, as the allocator may not be thread safe.
+      //
+
+      typedef BNode* (*SetOperation)(BNode* p1, BNode* p2, BNode*& pDropped, int numFork);
+      static const size_t PARALLEL_MIN = 1 << 15;  // fewer elements are not worth a thread
+      void combine(BST& rhs, SetOperation op);
+      static BNode* uniteNodes(BNode* p1, BNode* p2, BNode*& pDropped, int numFork);
+      static BNode* intersectNodes(BNode* p1, BNode* p2, BNode*& pDropped, int numFork);
+      static BNode* subtractNodes(BNode* p1, BNode* p2, BNode*& pDropped, int numFork);
+      template <class Left, class Right>
+      static void fork(int numFork, BNode*& pDropped, Left left, Right right);
+      static void drop(BNode* pNode, BNode*& pDropped)
+      {
+         if (pNode)
+         {
+            pNode->pParent = pDropped;
+            pDropped = pNode;
+         }
+      }
+      size_t deleteDropped(BNode* pDropped);
+
+#ifdef DEBUG
+      bool isRedBlack() const;
+      static int blackHeight(const BNode* pNode);
+#endif // DEBUG
+
+      NodeAlloc alloc;           // where the nodes come from
       BNode* root;              // root node of the binary search tree
       size_t numElements;        // number of elements currently in the tree
+      BNode* pMax;              // largest node, or nullptr when not known
+      bool appending;            // did the last insert go after the largest?
    };
 
 
@@ -132,20 +595,24 @@ namespace custom
     * A single node in a binary tree. Note that the node does not know
     * anything about the properties of the tree so no validation can be done.
     *****************************************************************/
-   template <typename T>
-   class BST <T> ::BNode
+   template <typename T, typename A, bool Ranked>
+   class BST <T, A, Ranked> ::BNode : public NodeCount <Ranked>, public NodeFields <BNode, T>
    {
    public:
       // 
       // Construct
       //
-      BNode() : pLeft(nullptr), pRight(nullptr), pParent(nullptr), data()
+      BNode() : NodeFields <BNode, T>()
       {
       }
-      BNode(const T& t) : pLeft(nullptr), pRight(nullptr), pParent(nullptr), data(t)
+      BNode(const T& t) : NodeFields <BNode, T>(t)
       {
       }
-      BNode(T&& t) : pLeft(nullptr), pRight(nullptr), pParent(nullptr), data(std::move(t))
+      BNode(T&& t) : NodeFields <BNode, T>(std::move(t))
+      {
+      }
+      template <class ... Args>
+      BNode(in_place_t, Args&& ... args) : NodeFields <BNode, T>(in_place, std::forward<Args>(args)...)
       {
       }
 
@@ -164,29 +631,21 @@ namespace custom
       //
       bool isRightChild(BNode* pNode) const { return true; }
       bool isLeftChild(BNode* pNode) const { return true; }
-
-      //
-      // Data
-      //
-      T data;                  // Actual data stored in the BNode
-      BNode* pLeft;          // Left child - smaller
-      BNode* pRight;         // Right child - larger
-      BNode* pParent;        // Parent
-      bool isRed;              // Red-black balancing stuff
    };
 
    /**********************************************************
     * BINARY SEARCH TREE ITERATOR
     * Forward and reverse iterator through a BST
     *********************************************************/
-   template <typename T>
-   class BST <T> ::iterator
+   template <typename T, typename A, bool Ranked>
+   class BST <T, A, Ranked> ::iterator
    {
       friend class ::TestBST; // give unit tests access to the privates
       friend class ::TestMap;
       friend class ::TestSet;
+      friend class ::TestSlabAllocator;
 
-      template <class KK, class VV>
+      template <class KK, class VV, class AA>
       friend class map;
 
       template <class TT>
@@ -241,7 +700,16 @@ namespace custom
       }
 
       // must give friend status to remove so it can call getNode() from it
-      friend BST <T> ::iterator BST <T> ::erase(iterator& it);
+      friend BST <T, A, Ranked> ::iterator BST <T, A, Ranked> ::erase(iterator& it);
+      friend BST <T, A, Ranked> ::node_handle BST <T, A, Ranked> ::extract(iterator it);
+      friend void BST <T, A, Ranked> ::merge(BST& rhs);
+
+      // and to a hinted insert so it can start from the hint
+      friend BST <T, A, Ranked> ::iterator BST <T, A, Ranked> ::insert(iterator hint, const T& t, bool keepUnique);
+      friend BST <T, A, Ranked> ::iterator BST <T, A, Ranked> ::insert(iterator hint, T&& t, bool keepUnique);
+
+      // and to move assignment so it can move the values out of nodes it cannot keep
+      friend BST <T, A, Ranked>& BST <T, A, Ranked> :: operator = (BST&& rhs);
 
    private:
 
@@ -249,6 +717,164 @@ namespace custom
       BNode* pNode;
    };
 
+   /**********************************************************
+    * BINARY SEARCH TREE NODE HANDLE
+    * Owns one node taken out of a tree, and the allocator it
+    * came from, until the node goes into another tree. A
+    * handle still holding a node frees it when it goes.
+    *********************************************************/
+   template <typename T, typename A, bool Ranked>
+   class BST <T, A, Ranked> ::node_handle
+   {
+      friend class ::TestBST; // give unit tests access to the privates
+      friend class BST <T, A, Ranked>;
+   public:
+      node_handle() : pNode(nullptr) {}
+      node_handle(node_handle&& rhs) : pNode(rhs.pNode), alloc(rhs.alloc)
+      {
+         rhs.pNode = nullptr;
+      }
+      node_handle& operator = (node_handle&& rhs)
+      {
+         if (this != &rhs)
+         {
+            reset();
+            pNode = rhs.pNode;
+            alloc = rhs.alloc;
+            rhs.pNode = nullptr;
+         }
+         return *this;
+      }
+      node_handle(const node_handle& rhs) = delete;
+      node_handle& operator = (const node_handle& rhs) = delete;
+      ~node_handle() { reset(); }
+
+      // the value, and for a map the key and the value it maps to
+      T& value() const { return pNode->data; }
+      template <class TT = T>
+      auto key() const -> decltype((std::declval<TT&>().first)) { return pNode->data.first; }
+      template <class TT = T>
+      auto mapped() const -> decltype((std::declval<TT&>().second)) { return pNode->data.second; }
+
+      bool empty() const { return pNode == nullptr; }
+      explicit operator bool () const { return pNode != nullptr; }
+
+   private:
+      node_handle(BNode* pNode, const NodeAlloc& alloc) : pNode(pNode), alloc(alloc) {}
+      void reset()
+      {
+         if (pNode)
+         {
+            NodeTraits::destroy(alloc, pNode);
+            NodeTraits::deallocate(alloc, pNode, 1);
+            pNode = nullptr;
+         }
+      }
+
+      BNode* pNode;           // the node, or nullptr once it is gone
+      NodeAlloc alloc;        // where the node goes back to
+   };
+
+
+   /**********************************************************
+    * BINARY SEARCH TREE STACK ITERATOR
+    * Forward-only iterator for scans. Rather than climbing
+    * pParent links to find the next node, a chain of dependent
+    * loads from nodes long out of cache, it keeps the nodes still
+    * to be visited on a stack of its own. Any insert or erase
+    * invalidates it.
+    *********************************************************/
+   template <typename T, typename A, bool Ranked>
+   class BST <T, A, Ranked> ::stack_iterator
+   {
+      friend class ::TestBST; // give unit tests access to the privates
+
+      template <class KK, class VV, class AA>
+      friend class map;
+   public:
+      // a red-black tree is never deeper than twice the bits in a size
+      static const int MAX_DEPTH = 2 * 8 * sizeof(size_t);
+
+      // constructors and assignment
+      stack_iterator() : numStack(0) {}
+      stack_iterator(BNode* pRoot) : numStack(0)
+      {
+         pushLeft(pRoot);
+      }
+      // start at the first value not less than k: the nodes we go
+      // left from are the ones still to come
+      template <class K>
+      stack_iterator(BNode* pRoot, const K& k) : numStack(0)
+      {
+         for (BNode* p = pRoot; p != nullptr; )
+            if (valueLess(p->data, k))
+               p = p->pRight;
+            else
+            {
+               push(p);
+               p = p->pLeft;
+            }
+      }
+      stack_iterator(const stack_iterator& rhs) : numStack(0)
+      {
+         *this = rhs;
+      }
+      stack_iterator& operator = (const stack_iterator& rhs)
+      {
+         numStack = rhs.numStack;
+         for (int i = 0; i < numStack; i++)
+            stack[i] = rhs.stack[i];
+         return *this;
+      }
+
+      // compare
+      bool operator == (const stack_iterator& rhs) const
+      {
+         return node() == rhs.node();
+      }
+      bool operator != (const stack_iterator& rhs) const
+      {
+         return node() != rhs.node();
+      }
+
+      // de-reference. Cannot change because it will invalidate the BST
+      const T& operator * () const
+      {
+         return node()->data;
+      }
+
+      // increment: the next node is the leftmost one under the right
+      // child, or else the one under it on the stack
+      stack_iterator& operator ++ ()
+      {
+         if (numStack > 0)
+            pushLeft(stack[--numStack]->pRight);
+         return *this;
+      }
+      stack_iterator operator ++ (int postfix)
+      {
+         stack_iterator itReturn = *this;
+         ++(*this);
+         return itReturn;
+      }
+
+   private:
+      BNode* node() const { return numStack ? stack[numStack - 1] : nullptr; }
+      void push(BNode* pNode)
+      {
+         assert(numStack < MAX_DEPTH);
+         stack[numStack++] = pNode;
+      }
+      void pushLeft(BNode* pNode)
+      {
+         for (; pNode != nullptr; pNode = pNode->pLeft)
+            push(pNode);
+      }
+
+      BNode* stack[MAX_DEPTH];   // the current node and those still to come
+      int numStack;              // how many are on the stack
+   };
+
 
    /*********************************************
     *********************************************
@@ -262,21 +888,26 @@ namespace custom
     /*********************************************
      * BST :: DEFAULT CONSTRUCTOR
      ********************************************/
-   template <typename T>
-   BST <T> ::BST()
+   template <typename T, typename A, bool Ranked>
+   BST <T, A, Ranked> ::BST(const A& a) : alloc(a)
    {
       numElements = 0;
       root = nullptr;
+      pMax = nullptr;
+      appending = false;
    }
 
    /*********************************************
     * BST :: COPY CONSTRUCTOR
     * Copy one tree to another
     ********************************************/
-   template <typename T>
-   BST <T> ::BST(const BST<T>& rhs)
+   template <typename T, typename A, bool Ranked>
+   BST <T, A, Ranked> ::BST(const BST <T, A, Ranked>& rhs) :
+      alloc(NodeTraits::select_on_container_copy_construction(rhs.alloc))
    {
       numElements = rhs.numElements;
+      pMax = nullptr;
+      appending = false;
 
       if (rhs.root == nullptr)
       {
@@ -287,7 +918,9 @@ namespace custom
       std::stack<BNode*> rhsNodeStack;
       std::stack<BNode*> newNodeStack;
 
-      auto newRoot = new BNode(rhs.root->data);
+      auto newRoot = createNode(rhs.root->data);
+      newRoot->isRed = rhs.root->isRed;
+      newRoot->setCount(rhs.root->count());
       rhsNodeStack.push(rhs.root);
       newNodeStack.push(newRoot);
 
@@ -302,7 +935,9 @@ namespace custom
 
          if (rhsTop->pRight != nullptr)
          {
-            auto newNode = new BNode(rhsTop->pRight->data);
+            auto newNode = createNode(rhsTop->pRight->data);
+            newNode->isRed = rhsTop->pRight->isRed;
+            newNode->setCount(rhsTop->pRight->count());
             newNode->pParent = newTop;
             newTop->pRight = newNode;
             rhsNodeStack.push(rhsTop->pRight);
@@ -311,7 +946,9 @@ namespace custom
 
          if (rhsTop->pLeft != nullptr)
          {
-            auto newNode = new BNode(rhsTop->pLeft->data);
+            auto newNode = createNode(rhsTop->pLeft->data);
+            newNode->isRed = rhsTop->pLeft->isRed;
+            newNode->setCount(rhsTop->pLeft->count());
             newNode->pParent = newTop;
             newTop->pLeft = newNode;
             rhsNodeStack.push(rhsTop->pLeft);
@@ -319,16 +956,20 @@ namespace custom
          }
       }
 
+      pMax = rightmost(root);
    }
 
    /*********************************************
     * BST :: MOVE CONSTRUCTOR
     * Move one tree to another
     ********************************************/
-   template <typename T>
-   BST <T> ::BST(BST <T>&& rhs)
+   template <typename T, typename A, bool Ranked>
+   BST <T, A, Ranked> ::BST(BST <T, A, Ranked>&& rhs) : alloc(rhs.alloc)
    {
       numElements = rhs.numElements;
+      pMax = rhs.pMax;
+      rhs.pMax = nullptr;
+      appending = rhs.appending;
 
       if (rhs.root == nullptr)
       {
@@ -346,11 +987,13 @@ namespace custom
     * BST :: INITIALIZER LIST CONSTRUCTOR
     * Create a BST from an initializer list
     ********************************************/
-   template <typename T>
-   BST <T> ::BST(const std::initializer_list<T>& il)
+   template <typename T, typename A, bool Ranked>
+   BST <T, A, Ranked> ::BST(const std::initializer_list<T>& il, const A& a) : alloc(a)
    {
       root = nullptr;
       numElements = 0;
+      pMax = nullptr;
+      appending = false;
       if (il.size() == 0)
          return;
 
@@ -359,11 +1002,24 @@ namespace custom
 
    }
 
+   /*********************************************
+    * BST :: SORTED RANGE CONSTRUCTOR
+    * Build a balanced tree from a range that is
+    * already in order without searching: O(n)
+    ********************************************/
+   template <typename T, typename A, bool Ranked>
+   template <class Iterator>
+   BST <T, A, Ranked> ::BST(sorted_range_t, Iterator first, Iterator last, const A& a) :
+      alloc(a), root(nullptr), numElements(0), pMax(nullptr), appending(false)
+   {
+      buildSorted(first, last);
+   }
+
    /*********************************************
     * BST :: DESTRUCTOR
     ********************************************/
-   template <typename T>
-   BST <T> :: ~BST()
+   template <typename T, typename A, bool Ranked>
+   BST <T, A, Ranked> :: ~BST()
    {
       this->clear();
    }
@@ -371,21 +1027,33 @@ namespace custom
 
    /*********************************************
     * BST :: ASSIGNMENT OPERATOR
-    * Copy one tree to another
+    * Copy one tree to another. An allocator that
+    * propagates on copy assignment replaces ours
+    * once our nodes have gone back to ours.
     ********************************************/
-   template <typename T>
-   BST <T>& BST <T> :: operator = (const BST <T>& rhs)
+   template <typename T, typename A, bool Ranked>
+   BST <T, A, Ranked>& BST <T, A, Ranked> :: operator = (const BST <T, A, Ranked>& rhs)
    {
+      if (NodeTraits::propagate_on_container_copy_assignment::value && alloc != rhs.alloc)
+      {
+         clear();
+         alloc = rhs.alloc;
+      }
+
       if (rhs.root == nullptr)
       {
          this->clear();
          return *this;
       }
 
+      // the nodes are reused, so the largest is found again at the end
+      pMax = nullptr;
       if (root == nullptr)
-         root = new BNode(rhs.root->data);
+         root = createNode(rhs.root->data);
       else
          root->data = rhs.root->data;
+      root->isRed = rhs.root->isRed;
+      root->setCount(rhs.root->count());
 
       numElements = rhs.size();
 
@@ -407,12 +1075,16 @@ namespace custom
             if (newTop->pRight != nullptr)
             {
                newTop->pRight->data = rhsTop->pRight->data;
+               newTop->pRight->isRed = rhsTop->pRight->isRed;
+               newTop->pRight->setCount(rhsTop->pRight->count());
                rhsNodeStack.push(rhsTop->pRight);
                newNodeStack.push(newTop->pRight);
             }
             else
             {
-               auto newNode = new BNode(rhsTop->pRight->data);
+               auto newNode = createNode(rhsTop->pRight->data);
+               newNode->isRed = rhsTop->pRight->isRed;
+               newNode->setCount(rhsTop->pRight->count());
                newNode->pParent = newTop;
                newTop->pRight = newNode;
                rhsNodeStack.push(rhsTop->pRight);
@@ -421,12 +1093,9 @@ namespace custom
          }
          else if (newTop->pRight != nullptr)
          {
-            iterator it;
-            while (newTop->pRight != nullptr)
-            {
-               it = iterator(newTop->pRight);
-               this->erase(it);
-            }
+            // erase() would rebalance under us; the shape is copied from rhs
+            deleteSubtree(newTop->pRight);
+            newTop->pRight = nullptr;
          }
 
          if (rhsTop->pLeft != nullptr)
@@ -434,12 +1103,16 @@ namespace custom
             if (newTop->pLeft != nullptr)
             {
                newTop->pLeft->data = rhsTop->pLeft->data;
+               newTop->pLeft->isRed = rhsTop->pLeft->isRed;
+               newTop->pLeft->setCount(rhsTop->pLeft->count());
                rhsNodeStack.push(rhsTop->pLeft);
                newNodeStack.push(newTop->pLeft);
             }
             else
             {
-               auto newNode = new BNode(rhsTop->pLeft->data);
+               auto newNode = createNode(rhsTop->pLeft->data);
+               newNode->isRed = rhsTop->pLeft->isRed;
+               newNode->setCount(rhsTop->pLeft->count());
                newNode->pParent = newTop;
                newTop->pLeft = newNode;
                rhsNodeStack.push(rhsTop->pLeft);
@@ -448,15 +1121,13 @@ namespace custom
          }
          else if (newTop->pLeft != nullptr)
          {
-            iterator it;
-            while (newTop->pLeft != nullptr)
-            {
-               it = iterator(newTop->pLeft);
-               this->erase(it);
-            }
+            // erase() would rebalance under us; the shape is copied from rhs
+            deleteSubtree(newTop->pLeft);
+            newTop->pLeft = nullptr;
          }
 
       }
+      pMax = rightmost(root);
       return *this;
    }
 
@@ -464,8 +1135,8 @@ namespace custom
     * BST :: ASSIGNMENT OPERATOR with INITIALIZATION LIST
     * Copy nodes onto a BTree
     ********************************************/
-   template <typename T>
-   BST <T>& BST <T> :: operator = (const std::initializer_list<T>& il)
+   template <typename T, typename A, bool Ranked>
+   BST <T, A, Ranked>& BST <T, A, Ranked> :: operator = (const std::initializer_list<T>& il)
    {
       numElements = il.size();
       clear();
@@ -484,18 +1155,36 @@ namespace custom
 
    /*********************************************
     * BST :: ASSIGN-MOVE OPERATOR
-    * Move one tree to another
+    * Move one tree to another. The nodes are taken
+    * over when our allocator can free them: when it
+    * propagates on move assignment or equals rhs's.
+    * Otherwise each value moves into a node of our
+    * own.
     ********************************************/
-   template <typename T>
-   BST <T>& BST <T> :: operator = (BST <T>&& rhs)
+   template <typename T, typename A, bool Ranked>
+   BST <T, A, Ranked>& BST <T, A, Ranked> :: operator = (BST <T, A, Ranked>&& rhs)
    {
       if (root != nullptr)
          clear();
 
+      // the nodes must go back to the allocator they came from
+      if (NodeTraits::propagate_on_container_move_assignment::value)
+         alloc = rhs.alloc;
+      else if (alloc != rhs.alloc)
+      {
+         for (iterator it = rhs.begin(); it != rhs.end(); ++it)
+            insert(end(), std::move(it.pNode->data));
+         rhs.clear();
+         return *this;
+      }
+
       root = rhs.root;
       rhs.root = nullptr;
       numElements = rhs.size();
       rhs.numElements = 0;
+      pMax = rhs.pMax;
+      rhs.pMax = nullptr;
+      appending = rhs.appending;
       return *this;
    }
 
@@ -503,8 +1192,8 @@ namespace custom
     * BST :: SWAP
     * Swap two trees
     ********************************************/
-   template <typename T>
-   void BST <T> ::swap(BST <T>& rhs)
+   template <typename T, typename A, bool Ranked>
+   void BST <T, A, Ranked> ::swap(BST <T, A, Ranked>& rhs)
    {
 
       BNode* swap = root;
@@ -514,25 +1203,37 @@ namespace custom
       int numSwap = numElements;
       numElements = rhs.numElements;
       rhs.numElements = numSwap;
-      
+
+      std::swap(pMax, rhs.pMax);
+      std::swap(appending, rhs.appending);
+
+      if (NodeTraits::propagate_on_container_swap::value)
+         std::swap(alloc, rhs.alloc);
    }
 
    /*****************************************************
     * BST :: INSERT
     * Insert a node at a given location in the tree
     ****************************************************/
-   template <typename T>
-   std::pair<typename BST <T> ::iterator, bool> BST <T> ::insert(const T& t, bool keepUnique)
+   template <typename T, typename A, bool Ranked>
+   std::pair<typename BST <T, A, Ranked> ::iterator, bool> BST <T, A, Ranked> ::insert(const T& t, bool keepUnique)
    {
       if (root == nullptr)
       {
-         root = new BNode(t);
-         auto it = BST<T>::iterator(root);
+         root = createNode(t);
+         root->isRed = false;
+         pMax = root;
+         auto it = BST <T, A, Ranked>::iterator(root);
          std::pair<iterator, bool> pairReturn(it, true);
          numElements++;
          return pairReturn;
       }
 
+      // while the values come in order, appending after the largest
+      // needs no search
+      if (appending && isAppend(t, keepUnique))
+         return std::pair<iterator, bool>(attach(pMax, false /* isLeft */, createNode(t)), true);
+
       auto* pCurrent = root;
 
       bool exit = false;
@@ -544,7 +1245,7 @@ namespace custom
          {
             if (pCurrent->data == t)
             {
-               auto it = BST<T>::iterator(pCurrent);
+               auto it = BST <T, A, Ranked>::iterator(pCurrent);
                std::pair<iterator, bool> pairReturn(it, false);
                return pairReturn;
             }
@@ -573,33 +1274,31 @@ namespace custom
          }
       }
 
-      auto* newNode = new BNode(t);
-
-      if (isLeft)
-         pCurrent->pLeft = newNode;
-      else
-         pCurrent->pRight = newNode;
-
-
-      newNode->pParent = pCurrent;
-      auto it = BST<T>::iterator(newNode);
-      std::pair<iterator, bool> pairReturn(it, true);
-      numElements++;
+      auto* newNode = createNode(t);
+      std::pair<iterator, bool> pairReturn(attach(pCurrent, isLeft, newNode), true);
+      appending = newNode == pMax;
       return pairReturn;
    }
 
-   template <typename T>
-   std::pair<typename BST <T> ::iterator, bool> BST <T> ::insert(T&& t, bool keepUnique)
+   template <typename T, typename A, bool Ranked>
+   std::pair<typename BST <T, A, Ranked> ::iterator, bool> BST <T, A, Ranked> ::insert(T&& t, bool keepUnique)
    {
       if (root == nullptr)
       {
-         root = new BNode(t);
-         auto it = BST<T>::iterator(root);
+         root = createNode(std::move(t));
+         root->isRed = false;
+         pMax = root;
+         auto it = BST <T, A, Ranked>::iterator(root);
          std::pair<iterator, bool> pairReturn(it, true);
          numElements++;
          return pairReturn;
       }
 
+      // while the values come in order, appending after the largest
+      // needs no search
+      if (appending && isAppend(t, keepUnique))
+         return std::pair<iterator, bool>(attach(pMax, false /* isLeft */, createNode(std::move(t))), true);
+
       auto* pCurrent = root;
 
       bool exit = false;
@@ -611,7 +1310,7 @@ namespace custom
          {
             if (pCurrent->data == t)
             {
-               auto it = BST<T>::iterator(pCurrent);
+               auto it = BST <T, A, Ranked>::iterator(pCurrent);
                std::pair<iterator, bool> pairReturn(it, false);
                return pairReturn;
             }
@@ -640,26 +1339,272 @@ namespace custom
          }
       }
 
-      auto* newNode = new BNode(std::move(t));
+      auto* newNode = createNode(std::move(t));
+      std::pair<iterator, bool> pairReturn(attach(pCurrent, isLeft, newNode), true);
+      appending = newNode == pMax;
+      return pairReturn;
+   }
+
+   /*****************************************************
+    * BST :: INSERT with HINT
+    * Insert just before hint without a search when that
+    * keeps the tree in order. A hint of end() appends
+    * after the largest. A hint that does not fit is no
+    * worse than the ordinary insert.
+    ****************************************************/
+   template <typename T, typename A, bool Ranked>
+   typename BST <T, A, Ranked> ::iterator BST <T, A, Ranked> ::insert(iterator hint, const T& t, bool keepUnique)
+   {
+      BNode* pParent;
+      bool isLeft;
+      if (fitsBefore(hint.pNode, t, keepUnique, pParent, isLeft))
+         return attach(pParent, isLeft, createNode(t));
+      return insert(t, keepUnique).first;
+   }
+
+   template <typename T, typename A, bool Ranked>
+   typename BST <T, A, Ranked> ::iterator BST <T, A, Ranked> ::insert(iterator hint, T&& t, bool keepUnique)
+   {
+      BNode* pParent;
+      bool isLeft;
+      if (fitsBefore(hint.pNode, t, keepUnique, pParent, isLeft))
+         return attach(pParent, isLeft, createNode(std::move(t)));
+      return insert(std::move(t), keepUnique).first;
+   }
+
+   /*****************************************************
+    * BST :: EMPLACE KEY
+    * Find where key k belongs on the way down. If it is
+    * there, that is the answer; if not, the new node is
+    * built from args and hung where the search ended.
+    ****************************************************/
+   template <typename T, typename A, bool Ranked>
+   template <class K, class ... Args>
+   std::pair<typename BST <T, A, Ranked> ::iterator, bool> BST <T, A, Ranked> ::emplace_key(const K& k, Args&& ... args)
+   {
+      BNode* pParent;
+      bool isLeft;
+      BNode* pFound = descend(k, true /* keepUnique */, pParent, isLeft);
+      if (pFound)
+         return std::pair<iterator, bool>(iterator(pFound), false);
+      return std::pair<iterator, bool>(place(pParent, isLeft, createNode(in_place, std::forward<Args>(args)...)), true);
+   }
+
+   /*****************************************************
+    * BST :: INSERT NODE HANDLE
+    * Hang the handle's node where its value belongs. A
+    * node from another allocator cannot stay, so its
+    * value moves into a node of our own.
+    ****************************************************/
+   template <typename T, typename A, bool Ranked>
+   std::pair<typename BST <T, A, Ranked> ::iterator, bool> BST <T, A, Ranked> ::insert(node_handle&& nh, bool keepUnique)
+   {
+      if (nh.empty())
+         return std::pair<iterator, bool>(end(), false);
+
+      BNode* pParent;
+      bool isLeft;
+      BNode* pFound = descend(keyOf<T>()(nh.pNode->data), keepUnique, pParent, isLeft);
+      if (pFound)
+         return std::pair<iterator, bool>(iterator(pFound), false);
+
+      BNode* pNode;
+      if (nh.alloc == alloc)
+      {
+         pNode = nh.pNode;
+         nh.pNode = nullptr;
+      }
+      else
+      {
+         pNode = createNode(std::move(nh.pNode->data));
+         nh.reset();
+      }
+      return std::pair<iterator, bool>(place(pParent, isLeft, pNode), true);
+   }
+
+   /*****************************************************
+    * BST :: EXTRACT
+    * Take a node out of the tree, without freeing it,
+    * and hand it over. end() or a missing key gives an
+    * empty handle.
+    ****************************************************/
+   template <typename T, typename A, bool Ranked>
+   typename BST <T, A, Ranked> ::node_handle BST <T, A, Ranked> ::extract(iterator it)
+   {
+      if (it == end())
+         return node_handle(nullptr, alloc);
+      return node_handle(unlink(it.pNode), alloc);
+   }
+
+   template <typename T, typename A, bool Ranked>
+   template <class K>
+   typename BST <T, A, Ranked> ::node_handle BST <T, A, Ranked> ::extract(const K& k)
+   {
+      return extract(find(k));
+   }
+
+   /*****************************************************
+    * BST :: MERGE
+    * Move every node of rhs whose value is not here yet
+    * into this tree, one relink each. What is already
+    * here stays in rhs.
+    ****************************************************/
+   template <typename T, typename A, bool Ranked>
+   void BST <T, A, Ranked> ::merge(BST <T, A, Ranked>& rhs)
+   {
+      if (&rhs == this)
+         return;
+
+      iterator it = rhs.begin();
+      while (it != rhs.end())
+      {
+         BNode* pNode = it.pNode;
+         ++it;
+
+         BNode* pParent;
+         bool isLeft;
+         if (descend(keyOf<T>()(pNode->data), true /* keepUnique */, pParent, isLeft))
+            continue;
+
+         // nodes can only change trees if they go back to the same place
+         if (alloc == rhs.alloc)
+            place(pParent, isLeft, rhs.unlink(pNode));
+         else
+         {
+            place(pParent, isLeft, createNode(std::move(pNode->data)));
+            rhs.deleteNode(rhs.unlink(pNode));
+         }
+      }
+   }
+
+   /*****************************************************
+    * BST :: DESCEND
+    * Where does key k go? Returns the node that already
+    * has it, when keepUnique, or else nullptr and the
+    * parent and side the new node hangs from. A parent
+    * of nullptr means the tree is empty.
+    ****************************************************/
+   template <typename T, typename A, bool Ranked>
+   template <class K>
+   typename BST <T, A, Ranked> ::BNode* BST <T, A, Ranked> ::descend(const K& k, bool keepUnique,
+                                                                      BNode*& pParent, bool& isLeft) const
+   {
+      pParent = nullptr;
+      isLeft = false;
+
+      // while the keys come in order, appending after the largest
+      // needs no search
+      if (appending && pMax != nullptr &&
+          (keepUnique ? valueLess(pMax->data, k) : !keyLess(k, pMax->data)))
+      {
+         pParent = pMax;
+         return nullptr;
+      }
+
+      for (BNode* pCurrent = root; pCurrent != nullptr; pCurrent = isLeft ? pCurrent->pLeft : pCurrent->pRight)
+      {
+         pParent = pCurrent;
+         isLeft = keyLess(k, pCurrent->data);
+         if (!isLeft && keepUnique && !valueLess(pCurrent->data, k))
+            return pCurrent;
+      }
+      return nullptr;
+   }
+
+   /*****************************************************
+    * BST :: PLACE
+    * Hang a new node where descend() said it goes
+    ****************************************************/
+   template <typename T, typename A, bool Ranked>
+   typename BST <T, A, Ranked> ::iterator BST <T, A, Ranked> ::place(BNode* pParent, bool isLeft, BNode* pNode)
+   {
+      if (pParent == nullptr)
+      {
+         root = pNode;
+         root->isRed = false;
+         pMax = root;
+         numElements++;
+         return iterator(root);
+      }
+
+      iterator it = attach(pParent, isLeft, pNode);
+      appending = pNode == pMax;
+      return it;
+   }
+
+   /*****************************************************
+    * BST :: FITS BEFORE
+    * Can t go right before pHint (nullptr for end())? If
+    * so, say where: as the hint's left child, or as the
+    * right child of the one before it
+    ****************************************************/
+   template <typename T, typename A, bool Ranked>
+   bool BST <T, A, Ranked> ::fitsBefore(BNode* pHint, const T& t, bool keepUnique,
+                                       BNode*& pParent, bool& isLeft) const
+   {
+      if (pHint == nullptr)
+      {
+         if (!isAppend(t, keepUnique))
+            return false;
+         pParent = pMax;
+         isLeft = false;
+         return true;
+      }
+
+      // t may not come after the hint
+      if (keepUnique ? !(t < pHint->data) : pHint->data < t)
+         return false;
+
+      // nor before the one ahead of it
+      BNode* pPrev;
+      if (pHint->pLeft)
+      {
+         pPrev = rightmost(pHint->pLeft);
+         pParent = pPrev;
+         isLeft = false;
+      }
+      else
+      {
+         BNode* pChild = pHint;
+         while (pChild->pParent && pChild->pParent->pLeft == pChild)
+            pChild = pChild->pParent;
+         pPrev = pChild->pParent;
+         pParent = pHint;
+         isLeft = true;
+      }
+      return pPrev == nullptr ||
+         (keepUnique ? pPrev->data < t : !(t < pPrev->data));
+   }
 
+   /*****************************************************
+    * BST :: ATTACH
+    * Hang a new node where the search for its place
+    * ended, then count and balance
+    ****************************************************/
+   template <typename T, typename A, bool Ranked>
+   typename BST <T, A, Ranked> ::iterator BST <T, A, Ranked> ::attach(BNode* pParent, bool isLeft, BNode* pNode)
+   {
       if (isLeft)
-         pCurrent->pLeft = newNode;
+         pParent->pLeft = pNode;
       else
-         pCurrent->pRight = newNode;
+         pParent->pRight = pNode;
+      pNode->pParent = pParent;
+
+      if (!isLeft && pParent == pMax)
+         pMax = pNode;
 
-      newNode->pParent = pCurrent;
-      auto it = BST<T>::iterator(newNode);
-      std::pair<iterator, bool> pairReturn(it, true);
+      recountToRoot(pParent);
+      balanceInsert(pNode);
       numElements++;
-      return pairReturn;
+      return iterator(pNode);
    }
 
    /*************************************************
     * BST :: ERASE
     * Remove a given node as specified by the iterator
     ************************************************/
-   template <typename T>
-   typename BST <T> ::iterator BST <T> ::erase(iterator& it)
+   template <typename T, typename A, bool Ranked>
+   typename BST <T, A, Ranked> ::iterator BST <T, A, Ranked> ::erase(iterator& it)
    {
       if (it == end()) {
          return it;
@@ -667,10 +1612,30 @@ namespace custom
 
       iterator next = it;
       ++next;
+      deleteNode(unlink(it.pNode));
+      return next;
+   }
 
-      BNode* node = it.pNode;
+   /*************************************************
+    * BST :: UNLINK
+    * Take a node out of the tree and rebalance what
+    * is left. The node is not freed; its links are
+    * cleared as though it had just been made.
+    ************************************************/
+   template <typename T, typename A, bool Ranked>
+   typename BST <T, A, Ranked> ::BNode* BST <T, A, Ranked> ::unlink(BNode* node)
+   {
       BNode* parent = node->pParent;
 
+      // the largest is going, so the one before it takes its place
+      if (node == pMax)
+         pMax = node->pLeft ? rightmost(node->pLeft) : parent;
+
+      // the color taken out of the tree and what now sits in its place
+      bool removedRed = node->isRed;
+      BNode* pFix = node->pLeft ? node->pLeft : node->pRight;
+      BNode* pFixParent = parent;
+
       if (!node->pLeft && !node->pRight) {
          if (parent) {
             if (parent->pLeft == node) parent->pLeft = nullptr;
@@ -679,7 +1644,6 @@ namespace custom
          else {
             root = nullptr;
          }
-         delete node;
       }
       else if (!node->pLeft) {
          if (parent) {
@@ -690,7 +1654,6 @@ namespace custom
             root = node->pRight;
          }
          node->pRight->pParent = parent;
-         delete node;
       }
       else if (!node->pRight) {
          if (parent) {
@@ -701,7 +1664,6 @@ namespace custom
             root = node->pLeft;
          }
          node->pLeft->pParent = parent;
-         delete node;
       }
       else {
          BNode* successor = node->pRight;
@@ -709,6 +1671,12 @@ namespace custom
             successor = successor->pLeft;
          }
 
+         // the successor takes over the node's color, so its own is removed
+         removedRed = successor->isRed;
+         pFix = successor->pRight;
+         pFixParent = (successor->pParent == node) ? successor : successor->pParent;
+         successor->isRed = node->isRed;
+
          if (successor->pParent != node) {
             successor->pParent->pLeft = successor->pRight;
             if (successor->pRight)
@@ -732,24 +1700,43 @@ namespace custom
             root = successor;
          }
 
-         delete node;
       }
 
+      // everything whose subtree lost a node is above where it came out
+      recountToRoot(pFixParent);
+
+      if (!removedRed)
+         balanceErase(pFix, pFixParent);
+
       numElements--;
-      return next;
 
+      node->pLeft = nullptr;
+      node->pRight = nullptr;
+      node->pParent = nullptr;
+      node->isRed = true;
+      node->setCount(1);
+      return node;
    }
 
    /*****************************************************
     * BST :: CLEAR
     * Removes all the BNodes from a tree
     ****************************************************/
-   template <typename T>
-   void BST <T> ::clear() noexcept
+   template <typename T, typename A, bool Ranked>
+   void BST <T, A, Ranked> ::clear() noexcept
    {
+      pMax = nullptr;
       if (root == nullptr)
          return;
 
+      // with no destructors to run, a pool we own drops every node at once
+      if (std::is_trivially_destructible<T>::value && releaseNodes(alloc, 0))
+      {
+         root = nullptr;
+         numElements = 0;
+         return;
+      }
+
       BNode* visitor = root;
 
       while (root->pLeft != nullptr || root->pRight != nullptr)
@@ -764,29 +1751,32 @@ namespace custom
             if (visitor->pParent->pLeft == visitor)
             {
                visitor = visitor->pParent;
-               delete visitor->pLeft;
+               deleteNode(visitor->pLeft);
                visitor->pLeft = nullptr;
             }
             else
             {
                visitor = visitor->pParent;
-               delete visitor->pRight;
+               deleteNode(visitor->pRight);
                visitor->pRight = nullptr;
             }
          }
       }
 
-      delete root;
+      deleteNode(root);
       root = nullptr;
       numElements = 0;
+
+      // every node is back in the pool, so hand its memory back too
+      releaseNodes(alloc, 0);
    }
 
    /*****************************************************
     * BST :: BEGIN
     * Return the first node (left-most) in a binary search tree
     ****************************************************/
-   template <typename T>
-   typename BST <T> ::iterator custom::BST <T> ::begin() const noexcept
+   template <typename T, typename A, bool Ranked>
+   typename BST <T, A, Ranked> ::iterator custom::BST <T, A, Ranked> ::begin() const noexcept
    {
       if (root == nullptr)
          return end();
@@ -804,8 +1794,8 @@ namespace custom
     * BST :: FIND
     * Return the node corresponding to a given value
     ****************************************************/
-   template <typename T>
-   typename BST <T> ::iterator BST<T> ::find(const T& t)
+   template <typename T, typename A, bool Ranked>
+   typename BST <T, A, Ranked> ::iterator BST <T, A, Ranked> ::find(const T& t) const
    {
       for (BNode* p = root; p != nullptr; p = (t < p->data ? p->pLeft : p->pRight))
          if (p->data == t)
@@ -814,6 +1804,1167 @@ namespace custom
       return end();
    }
 
+   /****************************************************
+    * BST :: SCAN BEGIN and END
+    * The ends of a forward scan with a stack_iterator
+    ****************************************************/
+   template <typename T, typename A, bool Ranked>
+   typename BST <T, A, Ranked> ::stack_iterator BST <T, A, Ranked> ::scan_begin() const
+   {
+      return stack_iterator(root);
+   }
+
+   template <typename T, typename A, bool Ranked>
+   typename BST <T, A, Ranked> ::stack_iterator BST <T, A, Ranked> ::scan_end() const
+   {
+      return stack_iterator();
+   }
+
+   /****************************************************
+    * BST :: FOR EACH
+    * Call visit(value) on every value in order
+    ****************************************************/
+   template <typename T, typename A, bool Ranked>
+   template <class Visit>
+   void BST <T, A, Ranked> ::for_each(Visit visit) const
+   {
+      for (stack_iterator it = scan_begin(); it != scan_end(); ++it)
+         visit(*it);
+   }
+
+   /****************************************************
+    * BST :: FIND BY KEY
+    * Return the node whose key matches k without making
+    * a T to compare against: the lower bound, if k is
+    * not less than it
+    ****************************************************/
+   template <typename T, typename A, bool Ranked>
+   template <class K>
+   typename BST <T, A, Ranked> ::iterator BST <T, A, Ranked> ::find(const K& k) const
+   {
+      iterator it = lower_bound(k);
+      if (it != end() && !keyLess(k, *it))
+         return it;
+      return end();
+   }
+
+   /****************************************************
+    * BST :: LOWER BOUND
+    * Return the first node not less than a given value.
+    * Going left remembers the node as the best so far.
+    ****************************************************/
+   template <typename T, typename A, bool Ranked>
+   template <class K>
+   typename BST <T, A, Ranked> ::iterator BST <T, A, Ranked> ::lower_bound(const K& k) const
+   {
+      BNode* pBound = nullptr;
+      for (BNode* p = root; p != nullptr; )
+         if (valueLess(p->data, k))
+            p = p->pRight;
+         else
+         {
+            pBound = p;
+            p = p->pLeft;
+         }
+
+      return iterator(pBound);
+   }
+
+   /****************************************************
+    * BST :: UPPER BOUND
+    * Return the first node greater than a given value
+    ****************************************************/
+   template <typename T, typename A, bool Ranked>
+   template <class K>
+   typename BST <T, A, Ranked> ::iterator BST <T, A, Ranked> ::upper_bound(const K& k) const
+   {
+      BNode* pBound = nullptr;
+      for (BNode* p = root; p != nullptr; )
+         if (keyLess(k, p->data))
+         {
+            pBound = p;
+            p = p->pLeft;
+         }
+         else
+            p = p->pRight;
+
+      return iterator(pBound);
+   }
+
+   /****************************************************
+    * BST :: COUNT RANGE
+    * Count the values in [lo, hi): one descent to find
+    * lo and then a step per value in the range, or on
+    * a Ranked tree the difference of two ranks. The
+    * bounds are only ever compared with the values, so
+    * lo past hi counts nothing.
+    ****************************************************/
+   template <typename T, typename A, bool Ranked>
+   template <class K>
+   size_t BST <T, A, Ranked> ::count_range(const K& lo, const K& hi) const
+   {
+      return countRange(lo, hi, std::integral_constant<bool, Ranked>());
+   }
+
+   // a Ranked tree needs just the two descents
+   template <typename T, typename A, bool Ranked>
+   template <class K>
+   size_t BST <T, A, Ranked> ::countRange(const K& lo, const K& hi, std::true_type) const
+   {
+      size_t rankLo = rankOf(lo);
+      size_t rankHi = rankOf(hi);
+      return rankLo < rankHi ? rankHi - rankLo : 0;
+   }
+
+   template <typename T, typename A, bool Ranked>
+   template <class K>
+   size_t BST <T, A, Ranked> ::countRange(const K& lo, const K& hi, std::false_type) const
+   {
+      size_t num = 0;
+      visit_range(lo, hi, [&num](const T&) { num++; });
+      return num;
+   }
+
+   /****************************************************
+    * BST :: VISIT RANGE
+    * Call visit(value) on each value in [lo, hi) in
+    * order, without touching anything outside it
+    ****************************************************/
+   template <typename T, typename A, bool Ranked>
+   template <class K, class Visit>
+   void BST <T, A, Ranked> ::visit_range(const K& lo, const K& hi, Visit visit) const
+   {
+      for (stack_iterator it(root, lo); it != scan_end() && valueLess(*it, hi); ++it)
+         visit(*it);
+   }
+
+   /****************************************************
+    * BST :: NTH ELEMENT
+    * Return the k-th smallest element, counting from 0,
+    * or end() if there are not that many. Each step down
+    * skips the whole left subtree when k is past it.
+    ****************************************************/
+   template <typename T, typename A, bool Ranked>
+   typename BST <T, A, Ranked> ::iterator BST <T, A, Ranked> ::nth_element(size_t k) const
+   {
+      static_assert(Ranked, "nth_element() needs a BST <T, A, true>");
+
+      BNode* p = root;
+      while (p != nullptr)
+      {
+         size_t numLeft = countOf(p->pLeft);
+         if (k < numLeft)
+            p = p->pLeft;
+         else if (k == numLeft)
+            return iterator(p);
+         else
+         {
+            k -= numLeft + 1;
+            p = p->pRight;
+         }
+      }
+      return end();
+   }
+
+   /****************************************************
+    * BST :: RANK
+    * Return how many elements are less than k, which is
+    * where k is or would be in order
+    ****************************************************/
+   template <typename T, typename A, bool Ranked>
+   template <class K>
+   size_t BST <T, A, Ranked> ::rank(const K& k) const
+   {
+      static_assert(Ranked, "rank() needs a BST <T, A, true>");
+      return rankOf(k);
+   }
+
+   template <typename T, typename A, bool Ranked>
+   template <class K>
+   size_t BST <T, A, Ranked> ::rankOf(const K& k) const
+   {
+      size_t num = 0;
+      for (BNode* p = root; p != nullptr; )
+         if (valueLess(p->data, k))
+         {
+            num += countOf(p->pLeft) + 1;
+            p = p->pRight;
+         }
+         else
+            p = p->pLeft;
+      return num;
+   }
+
+   /****************************************************
+    * BST :: ROTATE LEFT
+    * Lift the right child into pNode's place
+    *          (N)                 (R)
+    *        +--+--+             +--+--+
+    *       a     (R)   =>     (N)     c
+    *           +--+--+      +--+--+
+    *           b     c      a     b
+    ****************************************************/
+   template <typename T, typename A, bool Ranked>
+   void BST <T, A, Ranked> ::rotateLeft(BNode* pNode, BNode*& pRoot)
+   {
+      BNode* pRight = pNode->pRight;
+
+      pNode->pRight = pRight->pLeft;
+      if (pRight->pLeft)
+         pRight->pLeft->pParent = pNode;
+
+      pRight->pParent = pNode->pParent;
+      if (pNode->pParent == nullptr)
+         pRoot = pRight;
+      else if (pNode->pParent->pLeft == pNode)
+         pNode->pParent->pLeft = pRight;
+      else
+         pNode->pParent->pRight = pRight;
+
+      pRight->pLeft = pNode;
+      pNode->pParent = pRight;
+
+      if (Ranked)
+      {
+         recount(pNode);
+         recount(pRight);
+      }
+   }
+
+   /****************************************************
+    * BST :: ROTATE RIGHT
+    * Lift the left child into pNode's place
+    ****************************************************/
+   template <typename T, typename A, bool Ranked>
+   void BST <T, A, Ranked> ::rotateRight(BNode* pNode, BNode*& pRoot)
+   {
+      BNode* pLeft = pNode->pLeft;
+
+      pNode->pLeft = pLeft->pRight;
+      if (pLeft->pRight)
+         pLeft->pRight->pParent = pNode;
+
+      pLeft->pParent = pNode->pParent;
+      if (pNode->pParent == nullptr)
+         pRoot = pLeft;
+      else if (pNode->pParent->pRight == pNode)
+         pNode->pParent->pRight = pLeft;
+      else
+         pNode->pParent->pLeft = pLeft;
+
+      pLeft->pRight = pNode;
+      pNode->pParent = pLeft;
+
+      if (Ranked)
+      {
+         recount(pNode);
+         recount(pLeft);
+      }
+   }
+
+   /****************************************************
+    * BST :: BALANCE INSERT
+    * pNode was just added as a red leaf. While its parent
+    * is also red, either push the red up to the grandparent
+    * (red aunt) or rotate it away (black aunt).
+    ****************************************************/
+   template <typename T, typename A, bool Ranked>
+   void BST <T, A, Ranked> ::balanceInsert(BNode* pNode, BNode*& pRoot)
+   {
+      while (isRedNode(pNode->pParent))
+      {
+         BNode* pParent = pNode->pParent;
+         BNode* pGranny = pParent->pParent;
+
+         // a red root: painting it black below is enough
+         if (pGranny == nullptr)
+            break;
+
+         if (pParent == pGranny->pLeft)
+         {
+            BNode* pAunt = pGranny->pRight;
+            if (isRedNode(pAunt))
+            {
+               pParent->isRed = false;
+               pAunt->isRed = false;
+               pGranny->isRed = true;
+               pNode = pGranny;
+            }
+            else
+            {
+               if (pNode == pParent->pRight)
+               {
+                  rotateLeft(pParent, pRoot);
+                  pParent = pNode;
+               }
+               pParent->isRed = false;
+               pGranny->isRed = true;
+               rotateRight(pGranny, pRoot);
+               break;
+            }
+         }
+         else
+         {
+            BNode* pAunt = pGranny->pLeft;
+            if (isRedNode(pAunt))
+            {
+               pParent->isRed = false;
+               pAunt->isRed = false;
+               pGranny->isRed = true;
+               pNode = pGranny;
+            }
+            else
+            {
+               if (pNode == pParent->pLeft)
+               {
+                  rotateRight(pParent, pRoot);
+                  pParent = pNode;
+               }
+               pParent->isRed = false;
+               pGranny->isRed = true;
+               rotateLeft(pGranny, pRoot);
+               break;
+            }
+         }
+      }
+
+      pRoot->isRed = false;
+   }
+
+   /****************************************************
+    * BST :: BALANCE ERASE
+    * A black node was removed from under pParent, leaving
+    * pNode (possibly null) one black short. Borrow from
+    * the sibling's side or pass the shortage up the tree.
+    ****************************************************/
+   template <typename T, typename A, bool Ranked>
+   void BST <T, A, Ranked> ::balanceErase(BNode* pNode, BNode* pParent, BNode*& pRoot)
+   {
+      while (pNode != pRoot && !isRedNode(pNode))
+      {
+         if (pNode == pParent->pLeft)
+         {
+            BNode* pSibling = pParent->pRight;
+            if (isRedNode(pSibling))
+            {
+               pSibling->isRed = false;
+               pParent->isRed = true;
+               rotateLeft(pParent, pRoot);
+               pSibling = pParent->pRight;
+            }
+
+            // only a tree that was never red-black gets here
+            if (pSibling == nullptr)
+               break;
+
+            if (!isRedNode(pSibling->pLeft) && !isRedNode(pSibling->pRight))
+            {
+               pSibling->isRed = true;
+               pNode = pParent;
+               pParent = pNode->pParent;
+            }
+            else
+            {
+               if (!isRedNode(pSibling->pRight))
+               {
+                  pSibling->pLeft->isRed = false;
+                  pSibling->isRed = true;
+                  rotateRight(pSibling, pRoot);
+                  pSibling = pParent->pRight;
+               }
+               pSibling->isRed = pParent->isRed;
+               pParent->isRed = false;
+               pSibling->pRight->isRed = false;
+               rotateLeft(pParent, pRoot);
+               pNode = pRoot;
+            }
+         }
+         else
+         {
+            BNode* pSibling = pParent->pLeft;
+            if (isRedNode(pSibling))
+            {
+               pSibling->isRed = false;
+               pParent->isRed = true;
+               rotateRight(pParent, pRoot);
+               pSibling = pParent->pLeft;
+            }
+
+            if (pSibling == nullptr)
+               break;
+
+            if (!isRedNode(pSibling->pLeft) && !isRedNode(pSibling->pRight))
+            {
+               pSibling->isRed = true;
+               pNode = pParent;
+               pParent = pNode->pParent;
+            }
+            else
+            {
+               if (!isRedNode(pSibling->pLeft))
+               {
+                  pSibling->pRight->isRed = false;
+                  pSibling->isRed = true;
+                  rotateLeft(pSibling, pRoot);
+                  pSibling = pParent->pLeft;
+               }
+               pSibling->isRed = pParent->isRed;
+               pParent->isRed = false;
+               pSibling->pLeft->isRed = false;
+               rotateRight(pParent, pRoot);
+               pNode = pRoot;
+            }
+         }
+      }
+
+      if (pNode)
+         pNode->isRed = false;
+   }
+
+   /****************************************************
+    * BST :: CREATE NODE
+    * Allocate and build a node with the tree's allocator
+    ****************************************************/
+   template <typename T, typename A, bool Ranked>
+   template <class ... Args>
+   typename BST <T, A, Ranked> ::BNode* BST <T, A, Ranked> ::createNode(Args&& ... args)
+   {
+      BNode* pNode = NodeTraits::allocate(alloc, 1);
+      try
+      {
+         NodeTraits::construct(alloc, pNode, std::forward<Args>(args)...);
+      }
+      catch (...)
+      {
+         NodeTraits::deallocate(alloc, pNode, 1);
+         throw;
+      }
+      return pNode;
+   }
+
+   /****************************************************
+    * BST :: DELETE NODE
+    * Destroy a node and give it back to the allocator
+    ****************************************************/
+   template <typename T, typename A, bool Ranked>
+   void BST <T, A, Ranked> ::deleteNode(BNode* pNode)
+   {
+      NodeTraits::destroy(alloc, pNode);
+      NodeTraits::deallocate(alloc, pNode, 1);
+   }
+
+   /****************************************************
+    * BST :: DELETE SUBTREE
+    * Free pNode and everything below it without any
+    * rebalancing, returning how many nodes that was. The
+    * caller unhooks it from its parent.
+    ****************************************************/
+   template <typename T, typename A, bool Ranked>
+   size_t BST <T, A, Ranked> ::deleteSubtree(BNode* pNode)
+   {
+      size_t num = 0;
+      std::stack<BNode*> nodeStack;
+      if (pNode)
+         nodeStack.push(pNode);
+
+      while (nodeStack.size() > 0)
+      {
+         BNode* pTop = nodeStack.top();
+         nodeStack.pop();
+         if (pTop->pLeft)
+            nodeStack.push(pTop->pLeft);
+         if (pTop->pRight)
+            nodeStack.push(pTop->pRight);
+         deleteNode(pTop);
+         num++;
+      }
+      return num;
+   }
+
+   /****************************************************
+    * BST :: SPLIT
+    * Keep what is less than k and hand back a tree of
+    * everything else. The new tree shares this one's
+    * allocator. Cutting the nodes apart is O(log n),
+    * which is all it costs on a Ranked tree. Any other
+    * tree also has to count the smaller half, so a split
+    * near the middle is O(n); use a Ranked tree where
+    * that matters.
+    ****************************************************/
+   template <typename T, typename A, bool Ranked>
+   template <class K>
+   BST <T, A, Ranked> BST <T, A, Ranked> ::split(const K& k)
+   {
+      BST rhs;
+      rhs.alloc = alloc;
+
+      BNode* pLess;
+      splitNodes(root, k, pLess, rhs.root);
+      root = pLess;
+
+      // a Ranked tree knows its size; otherwise count the smaller part
+      size_t numLess = countOf(root);
+      if (!Ranked)
+      {
+         stack_iterator itLess(root);
+         stack_iterator itMore(rhs.root);
+         size_t num = 0;
+         for (; itLess != scan_end() && itMore != scan_end(); ++itLess, ++itMore)
+            num++;
+         numLess = (itLess == scan_end()) ? num : numElements - num;
+      }
+      rhs.numElements = numElements - numLess;
+      numElements = numLess;
+
+      pMax = rightmost(root);
+      rhs.pMax = rightmost(rhs.root);
+      appending = false;
+      return rhs;
+   }
+
+   /****************************************************
+    * BST :: JOIN
+    * Move all of rhs, whose values may not come before
+    * any in this tree, onto the end of this tree. With a
+    * shared allocator this is O(log n).
+    ****************************************************/
+   template <typename T, typename A, bool Ranked>
+   void BST <T, A, Ranked> ::join(BST <T, A, Ranked>& rhs)
+   {
+      if (rhs.root == nullptr || &rhs == this)
+         return;
+      if (root != nullptr && leftmost(rhs.root)->data < rightmost(root)->data)
+         throw std::invalid_argument("invalid BST<T> join");
+
+      // nodes can only change trees if they go back to the same place
+      if (alloc != rhs.alloc)
+      {
+         for (auto it = rhs.begin(); it != rhs.end(); ++it)
+            insert(end(), *it);
+         rhs.clear();
+         return;
+      }
+
+      root = joinNodes(root, rhs.root);
+      numElements += rhs.numElements;
+      pMax = rhs.pMax ? rhs.pMax : rightmost(root);
+      appending = false;
+
+      rhs.root = nullptr;
+      rhs.numElements = 0;
+      rhs.pMax = nullptr;
+   }
+
+   /****************************************************
+    * BST :: UNITE, INTERSECT, SUBTRACT
+    * This becomes this | rhs, this & rhs, or this - rhs.
+    * rhs is left empty. Where both trees have a value,
+    * the one in this tree is kept.
+    ****************************************************/
+   template <typename T, typename A, bool Ranked>
+   void BST <T, A, Ranked> ::unite(BST <T, A, Ranked>& rhs)
+   {
+      combine(rhs, &uniteNodes);
+   }
+
+   template <typename T, typename A, bool Ranked>
+   void BST <T, A, Ranked> ::intersect(BST <T, A, Ranked>& rhs)
+   {
+      combine(rhs, &intersectNodes);
+   }
+
+   template <typename T, typename A, bool Ranked>
+   void BST <T, A, Ranked> ::subtract(BST <T, A, Ranked>& rhs)
+   {
+      combine(rhs, &subtractNodes);
+   }
+
+   /****************************************************
+    * BST :: COMBINE
+    * Run a set operation over the two roots. Each node
+    * ends up either in the result or dropped, so the new
+    * size is what is left once the dropped are freed.
+    ****************************************************/
+   template <typename T, typename A, bool Ranked>
+   void BST <T, A, Ranked> ::combine(BST <T, A, Ranked>& rhs, SetOperation op)
+   {
+      // the operation takes rhs apart, so it cannot also be this tree
+      if (&rhs == this)
+      {
+         BST copy(*this);
+         combine(copy, op);
+         return;
+      }
+
+      // nodes can only change trees if they go back to the same place
+      if (alloc != rhs.alloc)
+      {
+         BST same;
+         same.alloc = alloc;
+         same.buildSorted(rhs.begin(), rhs.end());
+         rhs.clear();
+         combine(same, op);
+         return;
+      }
+
+      // fork about twice as many tasks as there are cores
+      int numFork = 0;
+      if (numElements + rhs.numElements >= PARALLEL_MIN)
+         for (unsigned int num = std::thread::hardware_concurrency(); num > 1; num /= 2)
+            numFork++;
+      if (numFork > 0)
+         numFork++;
+
+      BNode* pDropped = nullptr;
+      root = op(root, rhs.root, pDropped, numFork);
+      if (root)
+      {
+         root->pParent = nullptr;
+         root->isRed = false;
+      }
+      numElements += rhs.numElements;
+      numElements -= deleteDropped(pDropped);
+      pMax = rightmost(root);
+      appending = false;
+
+      rhs.root = nullptr;
+      rhs.numElements = 0;
+      rhs.pMax = nullptr;
+   }
+
+   /****************************************************
+    * BST :: UNITE NODES
+    * Split p2 around the root of p1, unite the halves on
+    * each side, then join them back with the old root
+    ****************************************************/
+   template <typename T, typename A, bool Ranked>
+   typename BST <T, A, Ranked> ::BNode* BST <T, A, Ranked> ::uniteNodes(BNode* p1, BNode* p2,
+      BNode*& pDropped, int numFork)
+   {
+      if (p1 == nullptr)
+         return p2;
+      if (p2 == nullptr)
+         return p1;
+
+      BNode* pLeft1 = detach(p1->pLeft);
+      BNode* pRight1 = detach(p1->pRight);
+      p1->pLeft = p1->pRight = nullptr;
+      BNode* pLeft2;
+      BNode* pEqual;
+      BNode* pRight2;
+      splitNodes(p2, p1->data, pLeft2, pEqual, pRight2);
+      drop(pEqual, pDropped);
+
+      BNode* pLeft;
+      BNode* pRight;
+      fork(numFork, pDropped,
+         [&](BNode*& pDroppedLeft) { pLeft = uniteNodes(pLeft1, pLeft2, pDroppedLeft, numFork - 1); },
+         [&](BNode*& pDroppedRight) { pRight = uniteNodes(pRight1, pRight2, pDroppedRight, numFork - 1); });
+      return joinNodes(pLeft, p1, pRight);
+   }
+
+   /****************************************************
+    * BST :: INTERSECT NODES
+    * Keep the root of p1 only if p2 has it too
+    ****************************************************/
+   template <typename T, typename A, bool Ranked>
+   typename BST <T, A, Ranked> ::BNode* BST <T, A, Ranked> ::intersectNodes(BNode* p1, BNode* p2,
+      BNode*& pDropped, int numFork)
+   {
+      if (p1 == nullptr || p2 == nullptr)
+      {
+         drop(p1, pDropped);
+         drop(p2, pDropped);
+         return nullptr;
+      }
+
+      BNode* pLeft1 = detach(p1->pLeft);
+      BNode* pRight1 = detach(p1->pRight);
+      p1->pLeft = p1->pRight = nullptr;
+      BNode* pLeft2;
+      BNode* pEqual;
+      BNode* pRight2;
+      splitNodes(p2, p1->data, pLeft2, pEqual, pRight2);
+
+      BNode* pLeft;
+      BNode* pRight;
+      fork(numFork, pDropped,
+         [&](BNode*& pDroppedLeft) { pLeft = intersectNodes(pLeft1, pLeft2, pDroppedLeft, numFork - 1); },
+         [&](BNode*& pDroppedRight) { pRight = intersectNodes(pRight1, pRight2, pDroppedRight, numFork - 1); });
+
+      if (pEqual)
+      {
+         drop(pEqual, pDropped);
+         return joinNodes(pLeft, p1, pRight);
+      }
+      drop(p1, pDropped);
+      return joinNodes(pLeft, pRight);
+   }
+
+   /****************************************************
+    * BST :: SUBTRACT NODES
+    * Split p1 around the root of p2, which with anything
+    * equal to it is dropped, and subtract each side
+    ****************************************************/
+   template <typename T, typename A, bool Ranked>
+   typename BST <T, A, Ranked> ::BNode* BST <T, A, Ranked> ::subtractNodes(BNode* p1, BNode* p2,
+      BNode*& pDropped, int numFork)
+   {
+      if (p1 == nullptr)
+      {
+         drop(p2, pDropped);
+         return nullptr;
+      }
+      if (p2 == nullptr)
+         return p1;
+
+      BNode* pLeft2 = detach(p2->pLeft);
+      BNode* pRight2 = detach(p2->pRight);
+      p2->pLeft = p2->pRight = nullptr;
+      BNode* pLeft1;
+      BNode* pEqual;
+      BNode* pRight1;
+      splitNodes(p1, p2->data, pLeft1, pEqual, pRight1);
+      drop(pEqual, pDropped);
+      drop(p2, pDropped);
+
+      BNode* pLeft;
+      BNode* pRight;
+      fork(numFork, pDropped,
+         [&](BNode*& pDroppedLeft) { pLeft = subtractNodes(pLeft1, pLeft2, pDroppedLeft, numFork - 1); },
+         [&](BNode*& pDroppedRight) { pRight = subtractNodes(pRight1, pRight2, pDroppedRight, numFork - 1); });
+      return joinNodes(pLeft, pRight);
+   }
+
+   /****************************************************
+    * BST :: FORK
+    * Run left on another thread while right runs on this
+    * one, or both here once there are no forks left. The
+    * left side drops onto a chain of its own, which then
+    * goes on the end of pDropped.
+    ****************************************************/
+   template <typename T, typename A, bool Ranked>
+   template <class Left, class Right>
+   void BST <T, A, Ranked> ::fork(int numFork, BNode*& pDropped, Left left, Right right)
+   {
+      if (numFork <= 0)
+      {
+         left(pDropped);
+         right(pDropped);
+         return;
+      }
+
+      BNode* pDroppedLeft = nullptr;
+      auto future = std::async(std::launch::async, [&left, &pDroppedLeft]() { left(pDroppedLeft); });
+      right(pDropped);
+      future.get();
+
+      while (pDroppedLeft)
+      {
+         BNode* pNext = pDroppedLeft->pParent;
+         drop(pDroppedLeft, pDropped);
+         pDroppedLeft = pNext;
+      }
+   }
+
+   /****************************************************
+    * BST :: DELETE DROPPED
+    * Free every subtree on the chain, returning how many
+    * nodes that was
+    ****************************************************/
+   template <typename T, typename A, bool Ranked>
+   size_t BST <T, A, Ranked> ::deleteDropped(BNode* pDropped)
+   {
+      size_t num = 0;
+      while (pDropped)
+      {
+         BNode* pNext = pDropped->pParent;
+         num += deleteSubtree(pDropped);
+         pDropped = pNext;
+      }
+      return num;
+   }
+
+   /****************************************************
+    * BST :: HEIGHT BLACK
+    * How many black nodes are on every path down from
+    * pNode, counting pNode itself
+    ****************************************************/
+   template <typename T, typename A, bool Ranked>
+   size_t BST <T, A, Ranked> ::heightBlack(const BNode* pNode)
+   {
+      size_t height = 0;
+      for (; pNode; pNode = pNode->pLeft)
+         if (!pNode->isRed)
+            height++;
+      return height;
+   }
+
+   /****************************************************
+    * BST :: DETACH
+    * Make a subtree a tree of its own. A red root can
+    * be painted black and still be a red-black tree.
+    ****************************************************/
+   template <typename T, typename A, bool Ranked>
+   typename BST <T, A, Ranked> ::BNode* BST <T, A, Ranked> ::detach(BNode* pNode)
+   {
+      if (pNode)
+      {
+         pNode->pParent = nullptr;
+         pNode->isRed = false;
+      }
+      return pNode;
+   }
+
+   /****************************************************
+    * BST :: JOIN NODES
+    * Everything in pLeft comes before pMid, which comes
+    * before everything in pRight. Go down the side of
+    * the taller tree to a black node as high as the
+    * shorter, put pMid there as a red node over the two,
+    * and let the insert balancing fix any red parent.
+    * O(difference in height).
+    ****************************************************/
+   template <typename T, typename A, bool Ranked>
+   typename BST <T, A, Ranked> ::BNode* BST <T, A, Ranked> ::joinNodes(BNode* pLeft, BNode* pMid, BNode* pRight)
+   {
+      detach(pLeft);
+      detach(pRight);
+      size_t heightLeft = heightBlack(pLeft);
+      size_t heightRight = heightBlack(pRight);
+
+      // as tall as each other: pMid is the new root
+      if (heightLeft == heightRight)
+      {
+         pMid->pLeft = pLeft;
+         pMid->pRight = pRight;
+         if (pLeft)
+            pLeft->pParent = pMid;
+         if (pRight)
+            pRight->pParent = pMid;
+         pMid->pParent = nullptr;
+         pMid->isRed = false;
+         recountToRoot(pMid);
+         return pMid;
+      }
+
+      BNode* pRoot;
+      BNode* pParent = nullptr;
+      if (heightLeft > heightRight)
+      {
+         // down the right side of the taller left tree
+         pRoot = pLeft;
+         BNode* p = pLeft;
+         for (size_t height = heightLeft; p && (p->isRed || height != heightRight); p = p->pRight)
+         {
+            if (!p->isRed)
+               height--;
+            pParent = p;
+         }
+         pMid->pLeft = p;
+         pMid->pRight = pRight;
+         pParent->pRight = pMid;
+      }
+      else
+      {
+         // down the left side of the taller right tree
+         pRoot = pRight;
+         BNode* p = pRight;
+         for (size_t height = heightRight; p && (p->isRed || height != heightLeft); p = p->pLeft)
+         {
+            if (!p->isRed)
+               height--;
+            pParent = p;
+         }
+         pMid->pLeft = pLeft;
+         pMid->pRight = p;
+         pParent->pLeft = pMid;
+      }
+
+      if (pMid->pLeft)
+         pMid->pLeft->pParent = pMid;
+      if (pMid->pRight)
+         pMid->pRight->pParent = pMid;
+      pMid->pParent = pParent;
+      pMid->isRed = true;
+      recountToRoot(pMid);
+      balanceInsert(pMid, pRoot);
+      return pRoot;
+   }
+
+   /****************************************************
+    * BST :: JOIN NODES
+    * Join two trees with nothing in between: the last of
+    * pLeft goes between them
+    ****************************************************/
+   template <typename T, typename A, bool Ranked>
+   typename BST <T, A, Ranked> ::BNode* BST <T, A, Ranked> ::joinNodes(BNode* pLeft, BNode* pRight)
+   {
+      if (pLeft == nullptr)
+         return detach(pRight);
+
+      BNode* pLast;
+      BNode* pRest = removeLast(detach(pLeft), pLast);
+      return joinNodes(pRest, pLast, pRight);
+   }
+
+   /****************************************************
+    * BST :: REMOVE LAST
+    * Take the last node off a tree, balancing as erase
+    * does. The last node has no right child and at most
+    * a red leaf on its left.
+    ****************************************************/
+   template <typename T, typename A, bool Ranked>
+   typename BST <T, A, Ranked> ::BNode* BST <T, A, Ranked> ::removeLast(BNode* pRoot, BNode*& pLast)
+   {
+      pLast = rightmost(pRoot);
+      BNode* pParent = pLast->pParent;
+      BNode* pChild = pLast->pLeft;
+
+      if (pChild)
+         pChild->pParent = pParent;
+      if (pParent)
+         pParent->pRight = pChild;
+      else
+         pRoot = pChild;
+      pLast->pLeft = pLast->pParent = nullptr;
+
+      recountToRoot(pParent);
+      if (!pLast->isRed)
+      {
+         if (isRedNode(pChild))
+            pChild->isRed = false;
+         else
+            balanceErase(pChild, pParent, pRoot);
+      }
+      return pRoot;
+   }
+
+   /****************************************************
+    * BST :: SPLIT NODES
+    * Split a tree into what is less than k and what is
+    * not. Each node on the way down is joined back onto
+    * one side with the subtree it leaves behind.
+    ****************************************************/
+   template <typename T, typename A, bool Ranked>
+   template <class K>
+   void BST <T, A, Ranked> ::splitNodes(BNode* pNode, const K& k, BNode*& pLess, BNode*& pMore)
+   {
+      if (pNode == nullptr)
+      {
+         pLess = pMore = nullptr;
+         return;
+      }
+
+      BNode* pLeft = detach(pNode->pLeft);
+      BNode* pRight = detach(pNode->pRight);
+      pNode->pLeft = pNode->pRight = nullptr;
+
+      if (valueLess(pNode->data, k))
+      {
+         BNode* pLessRight;
+         splitNodes(pRight, k, pLessRight, pMore);
+         pLess = joinNodes(pLeft, pNode, pLessRight);
+      }
+      else
+      {
+         BNode* pMoreLeft;
+         splitNodes(pLeft, k, pLess, pMoreLeft);
+         pMore = joinNodes(pMoreLeft, pNode, pRight);
+      }
+   }
+
+   /****************************************************
+    * BST :: SPLIT NODES
+    * Split a tree of unique values into what is less
+    * than k, the node equal to k if there is one, and
+    * what is more
+    ****************************************************/
+   template <typename T, typename A, bool Ranked>
+   template <class K>
+   void BST <T, A, Ranked> ::splitNodes(BNode* pNode, const K& k, BNode*& pLess, BNode*& pEqual, BNode*& pMore)
+   {
+      if (pNode == nullptr)
+      {
+         pLess = pEqual = pMore = nullptr;
+         return;
+      }
+
+      BNode* pLeft = detach(pNode->pLeft);
+      BNode* pRight = detach(pNode->pRight);
+      pNode->pLeft = pNode->pRight = nullptr;
+
+      if (valueLess(pNode->data, k))
+      {
+         BNode* pLessRight;
+         splitNodes(pRight, k, pLessRight, pEqual, pMore);
+         pLess = joinNodes(pLeft, pNode, pLessRight);
+      }
+      else if (keyLess(k, pNode->data))
+      {
+         BNode* pMoreLeft;
+         splitNodes(pLeft, k, pLess, pEqual, pMoreLeft);
+         pMore = joinNodes(pMoreLeft, pNode, pRight);
+      }
+      else
+      {
+         pLess = pLeft;
+         pEqual = pNode;
+         pMore = pRight;
+      }
+   }
+
+   /****************************************************
+    * BST :: IS SORTED
+    * Is every element in the range no less than the one
+    * before it? Stops at the first one out of order.
+    * This reads the range, so callers about to build
+    * from it go through canBuildSorted(), which turns
+    * down a single-pass range without touching it.
+    ****************************************************/
+   template <typename T, typename A, bool Ranked>
+   template <class Iterator>
+   bool BST <T, A, Ranked> ::isSorted(Iterator first, Iterator last)
+   {
+      if (first == last)
+         return true;
+      for (Iterator itPrev = first++; first != last; itPrev = first++)
+         if (*first < *itPrev)
+            return false;
+      return true;
+   }
+
+   /****************************************************
+    * BST :: BUILD SORTED
+    * Replace the contents with a sorted range. Each level
+    * is filled before the next so the bottom level is the
+    * only partial one; painting it red and everything
+    * above black makes a valid red-black tree. The range
+    * is walked twice so it must be a forward range. With
+    * keepUnique only the first of equal elements is kept.
+    * If building a node throws, the tree is left empty.
+    ****************************************************/
+   template <typename T, typename A, bool Ranked>
+   template <class Iterator>
+   void BST <T, A, Ranked> ::buildSorted(Iterator first, Iterator last, bool keepUnique)
+   {
+      clear();
+
+      // count what will go in the tree
+      size_t num = 0;
+      for (Iterator it = first, itPrev = first; it != last; itPrev = it++)
+         if (!keepUnique || it == first || *itPrev < *it)
+            num++;
+      if (num == 0)
+         return;
+
+      // the deepest level is floor(log2(num))
+      size_t depthRed = 0;
+      for (size_t n = num; n > 1; n /= 2)
+         depthRed++;
+
+      BNode* pPrev = nullptr;
+      Iterator it = first;
+      root = buildBalanced(it, num, 0, depthRed, pPrev, keepUnique);
+      root->pParent = nullptr;
+      root->isRed = false;
+      numElements = num;
+      pMax = pPrev;
+   }
+
+   /****************************************************
+    * BST :: BUILD BALANCED
+    * Build a subtree of num nodes from the next elements
+    * of it, left subtree first so the nodes are created
+    * in order. If a node cannot be built, whatever this
+    * call has built so far is freed before the exception
+    * goes on up.
+    ****************************************************/
+   template <typename T, typename A, bool Ranked>
+   template <class Iterator>
+   typename BST <T, A, Ranked> ::BNode* BST <T, A, Ranked> ::buildBalanced(Iterator& it, size_t num,
+      size_t depth, size_t depthRed, BNode*& pPrev, bool keepUnique)
+   {
+      if (num == 0)
+         return nullptr;
+
+      size_t numLeft = (num - 1) / 2;
+      BNode* pLeft = buildBalanced(it, numLeft, depth + 1, depthRed, pPrev, keepUnique);
+
+      // skip over the duplicates of the last one we kept
+      if (keepUnique && pPrev)
+         while (!(pPrev->data < *it))
+            ++it;
+
+      BNode* pNode = nullptr;
+      try
+      {
+         pNode = createNode(*it);
+         ++it;
+         pNode->isRed = (depth == depthRed);
+         pNode->pLeft = pLeft;
+         if (pLeft)
+            pLeft->pParent = pNode;
+         pPrev = pNode;
+
+         pNode->pRight = buildBalanced(it, num - 1 - numLeft, depth + 1, depthRed, pPrev, keepUnique);
+      }
+      catch (...)
+      {
+         deleteSubtree(pNode ? pNode : pLeft);
+         throw;
+      }
+      if (pNode->pRight)
+         pNode->pRight->pParent = pNode;
+      pNode->setCount(num);
+      return pNode;
+   }
+
+#ifdef DEBUG
+   /****************************************************
+    * BST :: IS RED BLACK
+    * Debug check of every red-black invariant: the root
+    * is black, no red node has a red child, every path
+    * has the same number of black nodes, and the parent
+    * pointers and ordering agree with the shape.
+    ****************************************************/
+   template <typename T, typename A, bool Ranked>
+   bool BST <T, A, Ranked> ::isRedBlack() const
+   {
+      if (root == nullptr)
+         return numElements == 0;
+      if (root->isRed || root->pParent != nullptr)
+         return false;
+      return blackHeight(root) >= 0;
+   }
+
+   /****************************************************
+    * BST :: BLACK HEIGHT
+    * Number of black nodes on every path down from pNode,
+    * or -1 if the subtree breaks an invariant
+    ****************************************************/
+   template <typename T, typename A, bool Ranked>
+   int BST <T, A, Ranked> ::blackHeight(const BNode* pNode)
+   {
+      if (pNode == nullptr)
+         return 0;
+
+      for (const BNode* pChild : { pNode->pLeft, pNode->pRight })
+         if (pChild && (pChild->pParent != pNode || (pNode->isRed && pChild->isRed)))
+            return -1;
+      if (pNode->pLeft && pNode->data < pNode->pLeft->data)
+         return -1;
+      if (pNode->pRight && pNode->pRight->data < pNode->data)
+         return -1;
+
+      int heightLeft = blackHeight(pNode->pLeft);
+      int heightRight = blackHeight(pNode->pRight);
+      if (heightLeft < 0 || heightLeft != heightRight)
+         return -1;
+      return heightLeft + (pNode->isRed ? 0 : 1);
+   }
+#endif // DEBUG
+
    /******************************************************
     ******************************************************
     ******************************************************
@@ -827,8 +2978,8 @@ namespace custom
      * BINARY NODE :: ADD LEFT
      * Add a node to the left of the current node
      ******************************************************/
-   template <typename T>
-   void BST <T> ::BNode::addLeft(BNode* pNode)
+   template <typename T, typename A, bool Ranked>
+   void BST <T, A, Ranked> ::BNode::addLeft(BNode* pNode)
    {
 
    }
@@ -837,8 +2988,8 @@ namespace custom
     * BINARY NODE :: ADD RIGHT
     * Add a node to the right of the current node
     ******************************************************/
-   template <typename T>
-   void BST <T> ::BNode::addRight(BNode* pNode)
+   template <typename T, typename A, bool Ranked>
+   void BST <T, A, Ranked> ::BNode::addRight(BNode* pNode)
    {
 
    }
@@ -847,8 +2998,8 @@ namespace custom
     * BINARY NODE :: ADD LEFT
     * Add a node to the left of the current node
     ******************************************************/
-   template <typename T>
-   void BST<T> ::BNode::addLeft(const T& t)
+   template <typename T, typename A, bool Ranked>
+   void BST <T, A, Ranked> ::BNode::addLeft(const T& t)
    {
 
    }
@@ -857,8 +3008,8 @@ namespace custom
     * BINARY NODE :: ADD LEFT
     * Add a node to the left of the current node
     ******************************************************/
-   template <typename T>
-   void BST<T> ::BNode::addLeft(T&& t)
+   template <typename T, typename A, bool Ranked>
+   void BST <T, A, Ranked> ::BNode::addLeft(T&& t)
    {
 
    }
@@ -867,8 +3018,8 @@ namespace custom
     * BINARY NODE :: ADD RIGHT
     * Add a node to the right of the current node
     ******************************************************/
-   template <typename T>
-   void BST <T> ::BNode::addRight(const T& t)
+   template <typename T, typename A, bool Ranked>
+   void BST <T, A, Ranked> ::BNode::addRight(const T& t)
    {
 
    }
@@ -877,8 +3028,8 @@ namespace custom
     * BINARY NODE :: ADD RIGHT
     * Add a node to the right of the current node
     ******************************************************/
-   template <typename T>
-   void BST <T> ::BNode::addRight(T&& t)
+   template <typename T, typename A, bool Ranked>
+   void BST <T, A, Ranked> ::BNode::addRight(T&& t)
    {
 
    }
@@ -897,8 +3048,8 @@ namespace custom
      * BST ITERATOR :: INCREMENT PREFIX
      * advance by one
      *************************************************/
-   template <typename T>
-   typename BST <T> ::iterator& BST <T> ::iterator :: operator ++ ()
+   template <typename T, typename A, bool Ranked>
+   typename BST <T, A, Ranked> ::iterator& BST <T, A, Ranked> ::iterator :: operator ++ ()
    {
       if (pNode == nullptr)
          return *this;
@@ -939,8 +3090,8 @@ namespace custom
     * BST ITERATOR :: DECREMENT PREFIX
     * advance by one
     *************************************************/
-   template <typename T>
-   typename BST <T> ::iterator& BST <T> ::iterator :: operator -- ()
+   template <typename T, typename A, bool Ranked>
+   typename BST <T, A, Ranked> ::iterator& BST <T, A, Ranked> ::iterator :: operator -- ()
    {
       if (pNode == nullptr)
          return *this;
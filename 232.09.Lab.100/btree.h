@@ -0,0 +1,982 @@
+/***********************************************************************
+ * Header:
+ *    B-TREE
+ * Summary:
+ *    Ordered containers built on a B+ tree. Each node holds many
+ *    sorted elements in a block a few cache lines long, so a search
+ *    touches one block per level instead of one node per comparison
+ *    the way a BST does, and there are far fewer levels. Every
+ *    element lives in a leaf and the leaves are linked in order, so
+ *    iteration just walks the leaf blocks.
+ *
+ *    Inserts split full nodes on the way down and erases top up thin
+ *    nodes on the way down, so neither has to climb back up the tree.
+ *
+ *    This will contain the class definition of:
+ *        btree               : The engine shared by the containers
+ *        btree::iterator     : An iterator through the leaves
+ *        btree_set           : An ordered set of unique values
+ *        btree_map           : An ordered map of unique keys
+ * Author
+ *    Gabe Lytle, M. Scott O'Connor
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>
+#include <functional>        // for std::less
+#include <initializer_list>
+#include <new>               // for placement new
+#include <type_traits>       // for std::aligned_storage
+#include <utility>           // for std::pair
+#include "pair.h"            // for custom::pair
+
+class TestBTree;    // forward declaration for unit tests
+
+namespace custom
+{
+
+   /*****************************************************************
+    * B-TREE
+    * The engine behind the B-tree containers. T is the stored value,
+    * KeyOf pulls the key K out of a T, and C orders keys.
+    *****************************************************************/
+   template <class T, class K, class KeyOf, class C>
+   class btree
+   {
+      friend class ::TestBTree; // give unit tests access to the privates
+   public:
+      typedef K key_type;
+      typedef T value_type;
+
+      //
+      // Construct
+      //
+
+      btree(const C& compare = C()) : root(nullptr), pFirst(nullptr), pLast(nullptr),
+                                      numElements(0), compare(compare) {}
+      btree(const btree& rhs);
+      btree(btree&& rhs);
+      ~btree() { clear(); }
+
+      //
+      // Assign
+      //
+
+      btree& operator = (const btree& rhs);
+      btree& operator = (btree&& rhs);
+      void swap(btree& rhs);
+
+      //
+      // Iterator
+      //
+
+      class iterator;
+      iterator begin() const { return iterator(pFirst, 0); }
+      iterator end()   const { return iterator(nullptr, 0); }
+
+      //
+      // Access
+      //
+
+      iterator find(const K& k) const;
+      iterator lower_bound(const K& k) const;
+      iterator upper_bound(const K& k) const;
+      size_t count(const K& k) const { return find(k) == end() ? 0 : 1; }
+
+      //
+      // Insert
+      //
+
+      std::pair<iterator, bool> insert(const T& t) { return emplaceUnique(KeyOf()(t), t); }
+      std::pair<iterator, bool> insert(T&& t)
+      {
+         // the key is only read before t is moved into the tree
+         const K& k = KeyOf()(t);
+         return emplaceUnique(k, std::move(t));
+      }
+      template <class Iterator>
+      void insert(Iterator first, Iterator last)
+      {
+         for (Iterator it = first; it != last; ++it)
+            insert(*it);
+      }
+
+      //
+      // Remove
+      //
+
+      size_t erase(const K& k);
+      iterator erase(iterator it);
+      void clear() noexcept;
+
+      //
+      // Status
+      //
+
+      bool   empty() const noexcept { return numElements == 0; }
+      size_t size()  const noexcept { return numElements; }
+
+   protected:
+      struct Node;
+      struct Leaf;
+      struct Inner;
+
+      // size each node's array to about four cache lines
+      static const int NODE_BYTES = 256;
+      static const int LEAF_MAX  = NODE_BYTES / sizeof(T) < 8 ? 8 : NODE_BYTES / sizeof(T);
+      static const int LEAF_MIN  = LEAF_MAX / 2;
+      static const int INNER_MAX = NODE_BYTES / sizeof(K) < 8 ? 8 : NODE_BYTES / sizeof(K);
+      static const int INNER_MIN = (INNER_MAX - 1) / 2;
+
+      template <class ... Args>
+      std::pair<iterator, bool> emplaceUnique(const K& k, Args&& ... args);
+
+      // searching within one node
+      int childIndex(const Inner* pInner, const K& k) const;
+      int leafLowerBound(const Leaf* pLeaf, const K& k) const;
+      int leafUpperBound(const Leaf* pLeaf, const K& k) const;
+      Leaf* findLeaf(const K& k) const;
+      static iterator normalize(Leaf* pLeaf, int i);
+
+      // keeping the nodes between half and completely full
+      static bool isFull(const Node* pNode)
+      {
+         return pNode->num == (pNode->isLeaf ? LEAF_MAX : INNER_MAX);
+      }
+      static bool isThin(const Node* pNode)
+      {
+         return pNode->num <= (pNode->isLeaf ? LEAF_MIN : INNER_MIN);
+      }
+      void splitChild(Inner* pParent, int i);
+      int  fillChild(Inner* pParent, int i);
+      void borrowFromLeft(Inner* pParent, int i);
+      void borrowFromRight(Inner* pParent, int i);
+      void mergeChildren(Inner* pParent, int i);
+
+      Node* clone(const Node* pSrc, Leaf*& pPrev);
+      static void destroy(Node* pNode);
+
+      Node*  root;          // top of the tree
+      Leaf*  pFirst;        // leftmost leaf
+      Leaf*  pLast;         // rightmost leaf
+      size_t numElements;   // number of elements in all the leaves
+      C compare;            // orders the keys
+   };
+
+   /*****************************************************************
+    * B-TREE NODE
+    * What leaves and inner nodes have in common
+    *****************************************************************/
+   template <class T, class K, class KeyOf, class C>
+   struct btree <T, K, KeyOf, C> ::Node
+   {
+      Node(bool isLeaf) : isLeaf(isLeaf), num(0) {}
+      bool isLeaf;   // leaf or inner node?
+      int  num;      // values in a leaf, keys in an inner node
+   };
+
+   /*****************************************************************
+    * B-TREE LEAF
+    * Up to LEAF_MAX values in order, linked to the leaves on either
+    * side. Slots past num hold no object.
+    *****************************************************************/
+   template <class T, class K, class KeyOf, class C>
+   struct btree <T, K, KeyOf, C> ::Leaf : public btree <T, K, KeyOf, C> ::Node
+   {
+      Leaf() : Node(true), pPrev(nullptr), pNext(nullptr) {}
+      ~Leaf()
+      {
+         for (int i = 0; i < this->num; i++)
+            value(i).~T();
+      }
+
+      T&       value(int i)       { return *reinterpret_cast<T*>(&slots[i]); }
+      const T& value(int i) const { return *reinterpret_cast<const T*>(&slots[i]); }
+
+      // build a value at i, sliding the rest over to make room
+      template <class ... Args>
+      void insertAt(int i, Args&& ... args)
+      {
+         T t(std::forward<Args>(args)...);
+         for (int j = this->num; j > i; j--)
+         {
+            new (&slots[j]) T(std::move(value(j - 1)));
+            value(j - 1).~T();
+         }
+         new (&slots[i]) T(std::move(t));
+         this->num++;
+      }
+
+      // destroy the value at i and close the gap
+      void removeAt(int i)
+      {
+         value(i).~T();
+         for (int j = i + 1; j < this->num; j++)
+         {
+            new (&slots[j - 1]) T(std::move(value(j)));
+            value(j).~T();
+         }
+         this->num--;
+      }
+
+      // move values [iFrom, num) onto the end of pDest
+      void moveTail(int iFrom, Leaf* pDest)
+      {
+         for (int j = iFrom; j < this->num; j++)
+         {
+            new (&pDest->slots[pDest->num++]) T(std::move(value(j)));
+            value(j).~T();
+         }
+         this->num = iFrom;
+      }
+
+      Leaf* pPrev;   // leaf with the smaller values
+      Leaf* pNext;   // leaf with the larger values
+      typename std::aligned_storage<sizeof(T), alignof(T)>::type slots[LEAF_MAX];
+   };
+
+   /*****************************************************************
+    * B-TREE INNER NODE
+    * num keys separating num + 1 children. Everything in children[i]
+    * is less than key(i), and everything in children[i + 1] is not.
+    *****************************************************************/
+   template <class T, class K, class KeyOf, class C>
+   struct btree <T, K, KeyOf, C> ::Inner : public btree <T, K, KeyOf, C> ::Node
+   {
+      Inner() : Node(false) {}
+      ~Inner()
+      {
+         for (int i = 0; i < this->num; i++)
+            key(i).~K();
+      }
+
+      K&       key(int i)       { return *reinterpret_cast<K*>(&slots[i]); }
+      const K& key(int i) const { return *reinterpret_cast<const K*>(&slots[i]); }
+
+      // put k at i with pChild just to its right
+      template <class KK>
+      void insertKey(int i, KK&& k, Node* pChild)
+      {
+         for (int j = this->num; j > i; j--)
+         {
+            new (&slots[j]) K(std::move(key(j - 1)));
+            key(j - 1).~K();
+            children[j + 1] = children[j];
+         }
+         new (&slots[i]) K(std::forward<KK>(k));
+         children[i + 1] = pChild;
+         this->num++;
+      }
+
+      // put k in front with pChild just to its left
+      template <class KK>
+      void pushFront(KK&& k, Node* pChild)
+      {
+         children[this->num + 1] = children[this->num];
+         for (int j = this->num; j > 0; j--)
+         {
+            new (&slots[j]) K(std::move(key(j - 1)));
+            key(j - 1).~K();
+            children[j] = children[j - 1];
+         }
+         new (&slots[0]) K(std::forward<KK>(k));
+         children[0] = pChild;
+         this->num++;
+      }
+
+      // remove the key at i and the child just to its right
+      void removeKey(int i)
+      {
+         key(i).~K();
+         for (int j = i + 1; j < this->num; j++)
+         {
+            new (&slots[j - 1]) K(std::move(key(j)));
+            key(j).~K();
+            children[j] = children[j + 1];
+         }
+         this->num--;
+      }
+
+      // remove the first key and the first child
+      void popFront()
+      {
+         key(0).~K();
+         children[0] = children[1];
+         for (int j = 1; j < this->num; j++)
+         {
+            new (&slots[j - 1]) K(std::move(key(j)));
+            key(j).~K();
+            children[j] = children[j + 1];
+         }
+         this->num--;
+      }
+
+      typename std::aligned_storage<sizeof(K), alignof(K)>::type slots[INNER_MAX];
+      Node* children[INNER_MAX + 1];
+   };
+
+   /**********************************************************
+    * B-TREE ITERATOR
+    * A leaf and a position in it
+    *********************************************************/
+   template <class T, class K, class KeyOf, class C>
+   class btree <T, K, KeyOf, C> ::iterator
+   {
+      friend class ::TestBTree; // give unit tests access to the privates
+      template <class TT, class KK, class KO, class CC>
+      friend class btree;
+   public:
+      // a set cannot change its values; a map can change the mapped part
+      typedef typename std::conditional<std::is_same<T, K>::value, const T&, T&>::type reference;
+      typedef typename std::conditional<std::is_same<T, K>::value, const T*, T*>::type pointer;
+
+      // constructors and assignment
+      iterator(Leaf* pLeaf = nullptr, int i = 0) : pLeaf(pLeaf), i(i) {}
+      iterator(const iterator& rhs) : pLeaf(rhs.pLeaf), i(rhs.i) {}
+      iterator& operator = (const iterator& rhs)
+      {
+         pLeaf = rhs.pLeaf;
+         i = rhs.i;
+         return *this;
+      }
+
+      // compare
+      bool operator == (const iterator& rhs) const { return pLeaf == rhs.pLeaf && i == rhs.i; }
+      bool operator != (const iterator& rhs) const { return !(*this == rhs); }
+
+      // de-reference
+      reference operator * () const { return pLeaf->value(i); }
+      pointer operator -> () const { return &pLeaf->value(i); }
+
+      // increment and decrement
+      iterator& operator ++ ()
+      {
+         if (pLeaf && ++i == pLeaf->num)
+         {
+            pLeaf = pLeaf->pNext;
+            i = 0;
+         }
+         return *this;
+      }
+      iterator operator ++ (int postfix)
+      {
+         iterator itReturn = *this;
+         ++(*this);
+         return itReturn;
+      }
+      iterator& operator -- ()
+      {
+         if (pLeaf == nullptr)
+            return *this;
+         if (i > 0)
+            i--;
+         else
+         {
+            pLeaf = pLeaf->pPrev;
+            i = pLeaf ? pLeaf->num - 1 : 0;
+         }
+         return *this;
+      }
+      iterator operator -- (int postfix)
+      {
+         iterator itReturn = *this;
+         --(*this);
+         return itReturn;
+      }
+
+   private:
+      Leaf* pLeaf;
+      int i;
+   };
+
+
+   /*********************************************
+    * B-TREE :: COPY CONSTRUCTOR
+    ********************************************/
+   template <class T, class K, class KeyOf, class C>
+   btree <T, K, KeyOf, C> ::btree(const btree& rhs) : btree(rhs.compare)
+   {
+      *this = rhs;
+   }
+
+   /*********************************************
+    * B-TREE :: MOVE CONSTRUCTOR
+    ********************************************/
+   template <class T, class K, class KeyOf, class C>
+   btree <T, K, KeyOf, C> ::btree(btree&& rhs) : btree(rhs.compare)
+   {
+      swap(rhs);
+   }
+
+   /*********************************************
+    * B-TREE :: ASSIGNMENT OPERATOR
+    * Copy the shape node for node; no searching
+    ********************************************/
+   template <class T, class K, class KeyOf, class C>
+   btree <T, K, KeyOf, C>& btree <T, K, KeyOf, C> :: operator = (const btree& rhs)
+   {
+      if (this == &rhs)
+         return *this;
+      clear();
+      compare = rhs.compare;
+      if (rhs.root)
+      {
+         Leaf* pPrev = nullptr;
+         root = clone(rhs.root, pPrev);
+         pLast = pPrev;
+      }
+      numElements = rhs.numElements;
+      return *this;
+   }
+
+   /*********************************************
+    * B-TREE :: ASSIGN-MOVE OPERATOR
+    ********************************************/
+   template <class T, class K, class KeyOf, class C>
+   btree <T, K, KeyOf, C>& btree <T, K, KeyOf, C> :: operator = (btree&& rhs)
+   {
+      clear();
+      swap(rhs);
+      return *this;
+   }
+
+   /*********************************************
+    * B-TREE :: SWAP
+    ********************************************/
+   template <class T, class K, class KeyOf, class C>
+   void btree <T, K, KeyOf, C> ::swap(btree& rhs)
+   {
+      std::swap(root, rhs.root);
+      std::swap(pFirst, rhs.pFirst);
+      std::swap(pLast, rhs.pLast);
+      std::swap(numElements, rhs.numElements);
+      std::swap(compare, rhs.compare);
+   }
+
+   /*********************************************
+    * B-TREE :: CLONE
+    * Copy a subtree, linking each new leaf after
+    * pPrev, the last leaf copied so far
+    ********************************************/
+   template <class T, class K, class KeyOf, class C>
+   typename btree <T, K, KeyOf, C> ::Node* btree <T, K, KeyOf, C> ::clone(const Node* pSrc, Leaf*& pPrev)
+   {
+      if (pSrc->isLeaf)
+      {
+         const Leaf* pSrcLeaf = static_cast<const Leaf*>(pSrc);
+         Leaf* pLeaf = new Leaf;
+         for (int i = 0; i < pSrcLeaf->num; i++)
+            new (&pLeaf->slots[pLeaf->num++]) T(pSrcLeaf->value(i));
+
+         pLeaf->pPrev = pPrev;
+         if (pPrev)
+            pPrev->pNext = pLeaf;
+         else
+            pFirst = pLeaf;
+         pPrev = pLeaf;
+         return pLeaf;
+      }
+
+      const Inner* pSrcInner = static_cast<const Inner*>(pSrc);
+      Inner* pInner = new Inner;
+      for (int i = 0; i <= pSrcInner->num; i++)
+      {
+         pInner->children[i] = clone(pSrcInner->children[i], pPrev);
+         if (i < pSrcInner->num)
+            new (&pInner->slots[pInner->num++]) K(pSrcInner->key(i));
+      }
+      return pInner;
+   }
+
+   /*********************************************
+    * B-TREE :: DESTROY
+    * Free a subtree
+    ********************************************/
+   template <class T, class K, class KeyOf, class C>
+   void btree <T, K, KeyOf, C> ::destroy(Node* pNode)
+   {
+      if (pNode->isLeaf)
+      {
+         delete static_cast<Leaf*>(pNode);
+         return;
+      }
+      Inner* pInner = static_cast<Inner*>(pNode);
+      for (int i = 0; i <= pInner->num; i++)
+         destroy(pInner->children[i]);
+      delete pInner;
+   }
+
+   /*********************************************
+    * B-TREE :: CLEAR
+    ********************************************/
+   template <class T, class K, class KeyOf, class C>
+   void btree <T, K, KeyOf, C> ::clear() noexcept
+   {
+      if (root)
+         destroy(root);
+      root = nullptr;
+      pFirst = pLast = nullptr;
+      numElements = 0;
+   }
+
+   /*********************************************
+    * B-TREE :: CHILD INDEX
+    * Which child of an inner node holds k: the
+    * first whose separator is greater than k.
+    * The searches within a node halve the range
+    * without branching on the comparison; a node
+    * is small enough that a mispredicted branch at
+    * every step costs more than the comparisons.
+    ********************************************/
+   template <class T, class K, class KeyOf, class C>
+   int btree <T, K, KeyOf, C> ::childIndex(const Inner* pInner, const K& k) const
+   {
+      int iLow = 0;
+      int num = pInner->num;
+      while (num > 1)
+      {
+         int half = num / 2;
+         iLow = compare(k, pInner->key(iLow + half)) ? iLow : iLow + half;
+         num -= half;
+      }
+      return iLow + (num == 1 && !compare(k, pInner->key(iLow)));
+   }
+
+   /*********************************************
+    * B-TREE :: LEAF LOWER BOUND
+    * First value in the leaf not less than k
+    ********************************************/
+   template <class T, class K, class KeyOf, class C>
+   int btree <T, K, KeyOf, C> ::leafLowerBound(const Leaf* pLeaf, const K& k) const
+   {
+      int iLow = 0;
+      int num = pLeaf->num;
+      while (num > 1)
+      {
+         int half = num / 2;
+         iLow = compare(KeyOf()(pLeaf->value(iLow + half - 1)), k) ? iLow + half : iLow;
+         num -= half;
+      }
+      return iLow + (num == 1 && compare(KeyOf()(pLeaf->value(iLow)), k));
+   }
+
+   /*********************************************
+    * B-TREE :: LEAF UPPER BOUND
+    * First value in the leaf greater than k
+    ********************************************/
+   template <class T, class K, class KeyOf, class C>
+   int btree <T, K, KeyOf, C> ::leafUpperBound(const Leaf* pLeaf, const K& k) const
+   {
+      int iLow = 0;
+      int num = pLeaf->num;
+      while (num > 1)
+      {
+         int half = num / 2;
+         iLow = compare(k, KeyOf()(pLeaf->value(iLow + half))) ? iLow : iLow + half;
+         num -= half;
+      }
+      return iLow + (num == 1 && !compare(k, KeyOf()(pLeaf->value(iLow))));
+   }
+
+   /*********************************************
+    * B-TREE :: FIND LEAF
+    * The leaf whose range covers k
+    ********************************************/
+   template <class T, class K, class KeyOf, class C>
+   typename btree <T, K, KeyOf, C> ::Leaf* btree <T, K, KeyOf, C> ::findLeaf(const K& k) const
+   {
+      Node* pNode = root;
+      while (pNode && !pNode->isLeaf)
+      {
+         const Inner* pInner = static_cast<const Inner*>(pNode);
+         pNode = pInner->children[childIndex(pInner, k)];
+      }
+      return static_cast<Leaf*>(pNode);
+   }
+
+   /*********************************************
+    * B-TREE :: NORMALIZE
+    * One past the end of a leaf is the start of
+    * the next one
+    ********************************************/
+   template <class T, class K, class KeyOf, class C>
+   typename btree <T, K, KeyOf, C> ::iterator btree <T, K, KeyOf, C> ::normalize(Leaf* pLeaf, int i)
+   {
+      if (pLeaf && i == pLeaf->num)
+         return iterator(pLeaf->pNext, 0);
+      return iterator(pLeaf, i);
+   }
+
+   /*********************************************
+    * B-TREE :: FIND, LOWER BOUND, UPPER BOUND
+    ********************************************/
+   template <class T, class K, class KeyOf, class C>
+   typename btree <T, K, KeyOf, C> ::iterator btree <T, K, KeyOf, C> ::find(const K& k) const
+   {
+      Leaf* pLeaf = findLeaf(k);
+      if (pLeaf == nullptr)
+         return end();
+      int i = leafLowerBound(pLeaf, k);
+      if (i < pLeaf->num && !compare(k, KeyOf()(pLeaf->value(i))))
+         return iterator(pLeaf, i);
+      return end();
+   }
+
+   template <class T, class K, class KeyOf, class C>
+   typename btree <T, K, KeyOf, C> ::iterator btree <T, K, KeyOf, C> ::lower_bound(const K& k) const
+   {
+      Leaf* pLeaf = findLeaf(k);
+      if (pLeaf == nullptr)
+         return end();
+      return normalize(pLeaf, leafLowerBound(pLeaf, k));
+   }
+
+   template <class T, class K, class KeyOf, class C>
+   typename btree <T, K, KeyOf, C> ::iterator btree <T, K, KeyOf, C> ::upper_bound(const K& k) const
+   {
+      Leaf* pLeaf = findLeaf(k);
+      if (pLeaf == nullptr)
+         return end();
+      return normalize(pLeaf, leafUpperBound(pLeaf, k));
+   }
+
+   /*****************************************************
+    * B-TREE :: EMPLACE UNIQUE
+    * Insert a value with the key k unless there is one
+    * already. Any full node met on the way down is split
+    * first, so the leaf always has room and no split ever
+    * has to travel back up.
+    ****************************************************/
+   template <class T, class K, class KeyOf, class C>
+   template <class ... Args>
+   std::pair<typename btree <T, K, KeyOf, C> ::iterator, bool>
+      btree <T, K, KeyOf, C> ::emplaceUnique(const K& k, Args&& ... args)
+   {
+      if (root == nullptr)
+         root = pFirst = pLast = new Leaf;
+
+      // a full root grows the tree by one level
+      if (isFull(root))
+      {
+         Inner* pRoot = new Inner;
+         pRoot->children[0] = root;
+         root = pRoot;
+         splitChild(pRoot, 0);
+      }
+
+      Node* pNode = root;
+      while (!pNode->isLeaf)
+      {
+         Inner* pInner = static_cast<Inner*>(pNode);
+         int i = childIndex(pInner, k);
+         if (isFull(pInner->children[i]))
+         {
+            splitChild(pInner, i);
+            if (!compare(k, pInner->key(i)))
+               i++;
+         }
+         pNode = pInner->children[i];
+      }
+
+      Leaf* pLeaf = static_cast<Leaf*>(pNode);
+      int i = leafLowerBound(pLeaf, k);
+      if (i < pLeaf->num && !compare(k, KeyOf()(pLeaf->value(i))))
+         return std::pair<iterator, bool>(iterator(pLeaf, i), false);
+
+      pLeaf->insertAt(i, std::forward<Args>(args)...);
+      numElements++;
+      return std::pair<iterator, bool>(iterator(pLeaf, i), true);
+   }
+
+   /*****************************************************
+    * B-TREE :: SPLIT CHILD
+    * Split the full children[i] in half. A leaf copies
+    * its new right half's first key up; an inner node
+    * moves its middle key up.
+    ****************************************************/
+   template <class T, class K, class KeyOf, class C>
+   void btree <T, K, KeyOf, C> ::splitChild(Inner* pParent, int i)
+   {
+      Node* pChild = pParent->children[i];
+      if (pChild->isLeaf)
+      {
+         Leaf* pLeft = static_cast<Leaf*>(pChild);
+         Leaf* pRight = new Leaf;
+         pLeft->moveTail(LEAF_MAX / 2, pRight);
+
+         pRight->pNext = pLeft->pNext;
+         pRight->pPrev = pLeft;
+         if (pLeft->pNext)
+            pLeft->pNext->pPrev = pRight;
+         else
+            pLast = pRight;
+         pLeft->pNext = pRight;
+
+         pParent->insertKey(i, KeyOf()(pRight->value(0)), pRight);
+      }
+      else
+      {
+         Inner* pLeft = static_cast<Inner*>(pChild);
+         Inner* pRight = new Inner;
+         int iMid = INNER_MAX / 2;
+         for (int j = iMid + 1; j < pLeft->num; j++)
+         {
+            new (&pRight->slots[pRight->num]) K(std::move(pLeft->key(j)));
+            pLeft->key(j).~K();
+            pRight->children[pRight->num++] = pLeft->children[j];
+         }
+         pRight->children[pRight->num] = pLeft->children[pLeft->num];
+         pLeft->num = iMid + 1;
+
+         pParent->insertKey(i, std::move(pLeft->key(iMid)), pRight);
+         pLeft->key(iMid).~K();
+         pLeft->num = iMid;
+      }
+   }
+
+   /*************************************************
+    * B-TREE :: ERASE
+    * Remove the element with a given key. Any thin
+    * node met on the way down is topped up from a
+    * sibling or merged with one first, so taking a
+    * value from the leaf never leaves it too empty.
+    ************************************************/
+   template <class T, class K, class KeyOf, class C>
+   size_t btree <T, K, KeyOf, C> ::erase(const K& k)
+   {
+      if (root == nullptr)
+         return 0;
+
+      Node* pNode = root;
+      while (!pNode->isLeaf)
+      {
+         Inner* pInner = static_cast<Inner*>(pNode);
+         int i = childIndex(pInner, k);
+         if (isThin(pInner->children[i]))
+            i = fillChild(pInner, i);
+
+         // merging the root's last two children shrinks the tree
+         if (pInner == root && pInner->num == 0)
+         {
+            root = pInner->children[0];
+            delete pInner;
+            pNode = root;
+         }
+         else
+            pNode = pInner->children[i];
+      }
+
+      Leaf* pLeaf = static_cast<Leaf*>(pNode);
+      int i = leafLowerBound(pLeaf, k);
+      if (i == pLeaf->num || compare(k, KeyOf()(pLeaf->value(i))))
+         return 0;
+
+      pLeaf->removeAt(i);
+      numElements--;
+      if (numElements == 0)
+         clear();
+      return 1;
+   }
+
+   /*************************************************
+    * B-TREE :: ERASE ITERATOR
+    * Remove the element and return the one after it
+    ************************************************/
+   template <class T, class K, class KeyOf, class C>
+   typename btree <T, K, KeyOf, C> ::iterator btree <T, K, KeyOf, C> ::erase(iterator it)
+   {
+      if (it == end())
+         return it;
+      K k = KeyOf()(*it);
+      erase(k);
+      return upper_bound(k);
+   }
+
+   /*************************************************
+    * B-TREE :: FILL CHILD
+    * children[i] is thin: borrow from a sibling with
+    * some to spare, or else merge with a sibling.
+    * Returns where the child's range now lives.
+    ************************************************/
+   template <class T, class K, class KeyOf, class C>
+   int btree <T, K, KeyOf, C> ::fillChild(Inner* pParent, int i)
+   {
+      if (i > 0 && !isThin(pParent->children[i - 1]))
+         borrowFromLeft(pParent, i);
+      else if (i < pParent->num && !isThin(pParent->children[i + 1]))
+         borrowFromRight(pParent, i);
+      else if (i < pParent->num)
+         mergeChildren(pParent, i);
+      else
+         mergeChildren(pParent, --i);
+      return i;
+   }
+
+   /*************************************************
+    * B-TREE :: BORROW FROM LEFT
+    * Move the last entry of children[i - 1] to the
+    * front of children[i]
+    ************************************************/
+   template <class T, class K, class KeyOf, class C>
+   void btree <T, K, KeyOf, C> ::borrowFromLeft(Inner* pParent, int i)
+   {
+      if (pParent->children[i]->isLeaf)
+      {
+         Leaf* pLeft = static_cast<Leaf*>(pParent->children[i - 1]);
+         Leaf* pChild = static_cast<Leaf*>(pParent->children[i]);
+         pChild->insertAt(0, std::move(pLeft->value(pLeft->num - 1)));
+         pLeft->removeAt(pLeft->num - 1);
+         pParent->key(i - 1) = KeyOf()(pChild->value(0));
+      }
+      else
+      {
+         Inner* pLeft = static_cast<Inner*>(pParent->children[i - 1]);
+         Inner* pChild = static_cast<Inner*>(pParent->children[i]);
+         pChild->pushFront(std::move(pParent->key(i - 1)), pLeft->children[pLeft->num]);
+         pParent->key(i - 1) = std::move(pLeft->key(pLeft->num - 1));
+         pLeft->key(pLeft->num - 1).~K();
+         pLeft->num--;
+      }
+   }
+
+   /*************************************************
+    * B-TREE :: BORROW FROM RIGHT
+    * Move the first entry of children[i + 1] to the
+    * end of children[i]
+    ************************************************/
+   template <class T, class K, class KeyOf, class C>
+   void btree <T, K, KeyOf, C> ::borrowFromRight(Inner* pParent, int i)
+   {
+      if (pParent->children[i]->isLeaf)
+      {
+         Leaf* pChild = static_cast<Leaf*>(pParent->children[i]);
+         Leaf* pRight = static_cast<Leaf*>(pParent->children[i + 1]);
+         pChild->insertAt(pChild->num, std::move(pRight->value(0)));
+         pRight->removeAt(0);
+         pParent->key(i) = KeyOf()(pRight->value(0));
+      }
+      else
+      {
+         Inner* pChild = static_cast<Inner*>(pParent->children[i]);
+         Inner* pRight = static_cast<Inner*>(pParent->children[i + 1]);
+         pChild->insertKey(pChild->num, std::move(pParent->key(i)), pRight->children[0]);
+         pParent->key(i) = std::move(pRight->key(0));
+         pRight->popFront();
+      }
+   }
+
+   /*************************************************
+    * B-TREE :: MERGE CHILDREN
+    * Fold children[i + 1] into children[i]
+    ************************************************/
+   template <class T, class K, class KeyOf, class C>
+   void btree <T, K, KeyOf, C> ::mergeChildren(Inner* pParent, int i)
+   {
+      if (pParent->children[i]->isLeaf)
+      {
+         Leaf* pLeft = static_cast<Leaf*>(pParent->children[i]);
+         Leaf* pRight = static_cast<Leaf*>(pParent->children[i + 1]);
+         pRight->moveTail(0, pLeft);
+
+         pLeft->pNext = pRight->pNext;
+         if (pRight->pNext)
+            pRight->pNext->pPrev = pLeft;
+         else
+            pLast = pLeft;
+         delete pRight;
+      }
+      else
+      {
+         Inner* pLeft = static_cast<Inner*>(pParent->children[i]);
+         Inner* pRight = static_cast<Inner*>(pParent->children[i + 1]);
+         pLeft->insertKey(pLeft->num, std::move(pParent->key(i)), pRight->children[0]);
+         for (int j = 0; j < pRight->num; j++)
+            pLeft->insertKey(pLeft->num, std::move(pRight->key(j)), pRight->children[j + 1]);
+         delete pRight;
+      }
+      pParent->removeKey(i);
+   }
+
+
+   /*****************************************************************
+    * KEY EXTRACTORS
+    * How the set and map pull the key out of what they store
+    *****************************************************************/
+   template <class T>
+   struct btreeIdentity
+   {
+      const T& operator () (const T& t) const { return t; }
+   };
+   template <class K, class V>
+   struct btreeFirst
+   {
+      const K& operator () (const custom::pair<K, V>& p) const { return p.first; }
+   };
+
+   /*****************************************************************
+    * B-TREE SET
+    * An ordered set of unique values
+    *****************************************************************/
+   template <class T, class C = std::less<T>>
+   class btree_set : public btree<T, T, btreeIdentity<T>, C>
+   {
+   public:
+      btree_set(const C& compare = C()) : btree<T, T, btreeIdentity<T>, C>(compare) {}
+      btree_set(const std::initializer_list<T>& il)
+      {
+         this->insert(il.begin(), il.end());
+      }
+      template <class Iterator>
+      btree_set(Iterator first, Iterator last)
+      {
+         this->insert(first, last);
+      }
+   };
+
+   /*****************************************************************
+    * B-TREE MAP
+    * An ordered map of unique keys with the interface of map
+    *****************************************************************/
+   template <class K, class V, class C = std::less<K>>
+   class btree_map : public btree<custom::pair<K, V>, K, btreeFirst<K, V>, C>
+   {
+      typedef btree<custom::pair<K, V>, K, btreeFirst<K, V>, C> Base;
+   public:
+      using Pairs = custom::pair<K, V>;
+
+      btree_map(const C& compare = C()) : Base(compare) {}
+      btree_map(const std::initializer_list<Pairs>& il)
+      {
+         this->insert(il.begin(), il.end());
+      }
+      template <class Iterator>
+      btree_map(Iterator first, Iterator last)
+      {
+         this->insert(first, last);
+      }
+
+      //
+      // Access
+      //
+      V& operator [] (const K& k)
+      {
+         return (*this->emplaceUnique(k, k).first).second;
+      }
+      V& at(const K& k)
+      {
+         auto it = this->find(k);
+         if (it == this->end())
+            throw "invalid btree_map<K, V> key";
+         return (*it).second;
+      }
+      const V& at(const K& k) const
+      {
+         auto it = this->find(k);
+         if (it == this->end())
+            throw "invalid btree_map<K, V> key";
+         return (*it).second;
+      }
+   };
+
+} // namespace custom
@@ -0,0 +1,240 @@
+/***********************************************************************
+ * Header:
+ *    CONCURRENT MAP
+ * Summary:
+ *    An ordered map for many reader threads and the occasional
+ *    writer. Each version of the map is a persistent_map, whose nodes
+ *    never change once built, and the current one is reached through
+ *    a single atomic pointer. A lookup loads that pointer and searches
+ *    without a lock; nothing it reads can change under it.
+ *
+ *    A writer copies the current version in O(1), makes its change,
+ *    which copies only the path down to it, and swings the pointer to
+ *    the new version. The lock writers take is held for that O(log n)
+ *    path and nothing else; readers never take it.
+ *
+ *    An old version is freed only once no reader can still be in it
+ *    (epoch-based reclamation). A reader announces the epoch it saw
+ *    in a slot of its own before loading the pointer and clears the
+ *    slot after. A version retired in epoch e is safe to free once
+ *    every slot is clear or newer than e, since a reader that saw
+ *    a newer epoch also sees the newer version.
+ *
+ *    This will contain the class definition of:
+ *        concurrent_map        : An ordered map with lock-free lookups
+ * Author
+ *    Gabe Lytle, M. Scott O'Connor
+ ************************************************************************/
+
+#pragma once
+
+#include <atomic>      // for std::atomic
+#include <cstdint>     // for uint64_t
+#include <functional>  // for std::less
+#include <mutex>       // for std::mutex
+#include <utility>     // for std::declval
+#include <vector>      // for the retired versions
+#include "pair.h"      // for custom::pair
+#include "persistent.h" // for persistent_map
+
+class TestConcurrentMap;    // forward declaration for unit tests
+
+namespace custom
+{
+
+   /*****************************************************************
+    * CONCURRENT MAP
+    * An ordered map of unique keys. Lookups never block and may run
+    * on any number of threads alongside the writers.
+    *****************************************************************/
+   template <class K, class V, class C = std::less<K>>
+   class concurrent_map
+   {
+      friend class ::TestConcurrentMap; // give unit tests access to the privates
+   public:
+      typedef persistent_map<K, V, C> Version;
+      using Pairs = custom::pair<K, V>;
+
+      //
+      // Construct
+      //
+
+      concurrent_map(const C& compare = C()) : pLatest(new Version(compare)), epoch(1)
+      {
+         for (auto& slot : slots)
+            slot.epoch.store(0, std::memory_order_relaxed);
+      }
+      concurrent_map(const concurrent_map& rhs) = delete;
+      concurrent_map& operator = (const concurrent_map& rhs) = delete;
+      ~concurrent_map();
+
+      //
+      // Access: lock-free, and safe alongside writers
+      //
+
+      bool find(const K& k, V& v) const
+      {
+         ReadGuard guard(*this);
+         const Pairs* pPair = guard.pVersion->search(k);
+         if (pPair == nullptr)
+            return false;
+         v = pPair->second;
+         return true;
+      }
+      bool contains(const K& k) const
+      {
+         ReadGuard guard(*this);
+         return guard.pVersion->count(k) != 0;
+      }
+      size_t size() const
+      {
+         ReadGuard guard(*this);
+         return guard.pVersion->size();
+      }
+      bool empty() const { return size() == 0; }
+
+      // the current version, to iterate over or search at leisure
+      Version snapshot() const
+      {
+         ReadGuard guard(*this);
+         return *guard.pVersion;
+      }
+
+      //
+      // Insert and Remove: serialized among writers
+      //
+
+      bool insert(const Pairs& rhs)
+      {
+         return write([&rhs](Version& version) { return version.insert(rhs); });
+      }
+      bool insert_or_assign(const K& k, const V& v)
+      {
+         return write([&](Version& version) { return version.insert_or_assign(k, v); });
+      }
+      size_t erase(const K& k)
+      {
+         return write([&k](Version& version) { return version.erase(k); });
+      }
+
+   private:
+      // enough slots for this many readers at the same instant;
+      // any more wait for one to come free
+      static const int NUM_SLOTS = 128;
+
+      // a slot on a cache line of its own, so readers do not share
+      struct alignas(64) Slot
+      {
+         std::atomic<uint64_t> epoch;   // epoch seen by the reader here, 0 if none
+      };
+
+      // a version replaced by a writer, waiting for its readers
+      struct Retired
+      {
+         Version* pVersion;
+         uint64_t epoch;                // the epoch it was replaced in
+      };
+
+      /**********************************************************
+       * READ GUARD
+       * Holds a slot for the length of one lookup. Each thread
+       * starts at a slot of its own and moves on if it is taken.
+       *********************************************************/
+      class ReadGuard
+      {
+      public:
+         ReadGuard(const concurrent_map& m)
+         {
+            static std::atomic<int> numThreads(0);
+            thread_local int iPreferred = numThreads++ % NUM_SLOTS;
+
+            uint64_t epochNow = m.epoch.load();
+            int i = iPreferred;
+            for (uint64_t none = 0; !m.slots[i].epoch.compare_exchange_weak(none, epochNow); none = 0)
+               i = (i + 1) % NUM_SLOTS;
+            pSlot = &m.slots[i];
+            pVersion = m.pLatest.load();
+         }
+         ~ReadGuard() { pSlot->epoch.store(0, std::memory_order_release); }
+
+         const Version* pVersion;
+      private:
+         Slot* pSlot;
+      };
+
+      template <class Write>
+      auto write(Write w) -> decltype(w(std::declval<Version&>()));
+      void reclaim();
+
+      std::atomic<Version*> pLatest;     // what new readers see
+      mutable std::atomic<uint64_t> epoch;
+      mutable Slot slots[NUM_SLOTS];     // one per reader in a lookup
+      std::mutex mutexWrite;             // one writer at a time
+      std::vector<Retired> retired;      // old versions not yet freed
+   };
+
+   /*********************************************
+    * CONCURRENT MAP :: DESTRUCTOR
+    * No reader may be left by now
+    ********************************************/
+   template <class K, class V, class C>
+   concurrent_map <K, V, C> :: ~concurrent_map()
+   {
+      for (auto& r : retired)
+         delete r.pVersion;
+      delete pLatest.load();
+   }
+
+   /*********************************************
+    * CONCURRENT MAP :: WRITE
+    * Apply w to a copy of the current version and
+    * publish it, unless w changed nothing. The old
+    * version is retired in the epoch that ends
+    * here, and whatever is old enough is freed.
+    ********************************************/
+   template <class K, class V, class C>
+   template <class Write>
+   auto concurrent_map <K, V, C> ::write(Write w) -> decltype(w(std::declval<Version&>()))
+   {
+      std::lock_guard<std::mutex> guard(mutexWrite);
+      Version* pOld = pLatest.load(std::memory_order_relaxed);
+      Version* pNew = new Version(*pOld);
+      auto result = w(*pNew);
+      if (pNew->shares(*pOld))
+      {
+         delete pNew;
+         return result;
+      }
+
+      pLatest.store(pNew);
+      retired.push_back(Retired{ pOld, epoch.fetch_add(1) });
+      reclaim();
+      return result;
+   }
+
+   /*********************************************
+    * CONCURRENT MAP :: RECLAIM
+    * Free the retired versions older than every
+    * reader still in a lookup
+    ********************************************/
+   template <class K, class V, class C>
+   void concurrent_map <K, V, C> ::reclaim()
+   {
+      uint64_t epochOldest = UINT64_MAX;
+      for (auto& slot : slots)
+      {
+         uint64_t epochReader = slot.epoch.load();
+         if (epochReader != 0 && epochReader < epochOldest)
+            epochOldest = epochReader;
+      }
+
+      size_t iKeep = 0;
+      for (auto& r : retired)
+         if (r.epoch < epochOldest)
+            delete r.pVersion;
+         else
+            retired[iKeep++] = r;
+      retired.resize(iKeep);
+   }
+
+} // namespace custom
@@ -0,0 +1,389 @@
+/***********************************************************************
+ * Header:
+ *    FLAT MAP
+ * Summary:
+ *    An ordered map kept as one sorted array of pairs in a
+ *    custom::vector. A lookup is a binary search over contiguous
+ *    memory and a walk through the map is a walk down the array, so
+ *    there are no nodes to allocate and no pointers to chase. The
+ *    price is paid on a single insert or erase, which shifts every
+ *    pair after it.
+ *
+ *    That makes it the one to reach for when a map is small, or is
+ *    filled once and then mostly read, as configuration and lookup
+ *    tables are. Fill it with the range constructor or the range
+ *    insert, which sort the new pairs and merge them in one pass,
+ *    rather than one insert at a time.
+ *
+ *    Any insert or erase invalidates the iterators, as it would with
+ *    a vector.
+ *
+ *    This will contain the class definition of:
+ *        flat_map              : An ordered map in a sorted vector
+ * Author
+ *    Gabe Lytle, M. Scott O'Connor
+ ************************************************************************/
+
+#pragma once
+
+#include <algorithm>         // for std::lower_bound, std::stable_sort, and std::inplace_merge
+#include <initializer_list>
+#include <stdexcept>         // for std::out_of_range
+#include "pair.h"            // for custom::pair
+#include "bst.h"             // for sorted_range
+#include "vector.h"          // for custom::vector
+
+class TestFlatMap;    // forward declaration for unit tests
+
+namespace custom
+{
+
+   /*****************************************************************
+    * FLAT MAP
+    * An ordered map of unique keys with the interface of map. The
+    * pairs are in pairs[0 .. size()) ordered by key, and an iterator
+    * is a pointer into that array.
+    *****************************************************************/
+   template <class K, class V, class A = std::allocator<custom::pair<K, V>>>
+   class flat_map
+   {
+      friend class ::TestFlatMap; // give unit tests access to the privates
+      template <class KK, class VV, class AA>
+      friend void swap(flat_map<KK, VV, AA>& lhs, flat_map<KK, VV, AA>& rhs);
+   public:
+      using Pairs = custom::pair<K, V>;
+      typedef Pairs* iterator;
+      typedef const Pairs* const_iterator;
+
+      //
+      // Construct
+      //
+      flat_map(const A& a = A()) : pairs(a) {}
+      flat_map(const flat_map& rhs) : pairs(rhs.pairs) {}
+      flat_map(flat_map&& rhs) : pairs(std::move(rhs.pairs)) {}
+      template <class Iterator>
+      flat_map(Iterator first, Iterator last, const A& a = A()) : pairs(a)
+      {
+         insert(first, last);
+      }
+      template <class Iterator>
+      flat_map(sorted_range_t, Iterator first, Iterator last, const A& a = A()) : pairs(a)
+      {
+         for (Iterator it = first; it != last; ++it)
+            if (pairs.empty() || pairs.back().first < (*it).first)
+               pairs.push_back(*it);
+      }
+      flat_map(const std::initializer_list <Pairs>& il, const A& a = A()) : pairs(a)
+      {
+         insert(il.begin(), il.end());
+      }
+
+      //
+      // Assign
+      //
+      flat_map& operator = (const flat_map& rhs)
+      {
+         pairs = rhs.pairs;
+         return *this;
+      }
+      flat_map& operator = (flat_map&& rhs)
+      {
+         pairs = std::move(rhs.pairs);
+         return *this;
+      }
+      flat_map& operator = (const std::initializer_list <Pairs>& il)
+      {
+         clear();
+         insert(il.begin(), il.end());
+         return *this;
+      }
+
+      //
+      // Iterator
+      //
+      iterator begin()             { return pairs.empty() ? nullptr : &pairs[0]; }
+      iterator end()               { return begin() + pairs.size(); }
+      const_iterator begin() const { return pairs.empty() ? nullptr : &pairs[0]; }
+      const_iterator end()   const { return begin() + pairs.size(); }
+
+      //
+      // Access: lookups take the key or anything that compares with
+      // it, as they do in map
+      //
+      const V& operator [] (const K& k) const { return at(k); }
+            V& operator [] (const K& k);
+      const V& at(const K& k) const;
+            V& at(const K& k);
+      template <class KK>
+      iterator find(const KK& k)
+      {
+         iterator it = lower_bound(k);
+         return it != end() && !(k < it->first) ? it : end();
+      }
+      template <class KK>
+      const_iterator find(const KK& k) const
+      {
+         const_iterator it = lower_bound(k);
+         return it != end() && !(k < it->first) ? it : end();
+      }
+      template <class KK>
+      iterator lower_bound(const KK& k)
+      {
+         return std::lower_bound(begin(), end(), k,
+            [](const Pairs& p, const KK& k) { return p.first < k; });
+      }
+      template <class KK>
+      const_iterator lower_bound(const KK& k) const
+      {
+         return std::lower_bound(begin(), end(), k,
+            [](const Pairs& p, const KK& k) { return p.first < k; });
+      }
+      template <class KK>
+      iterator upper_bound(const KK& k)
+      {
+         return std::upper_bound(begin(), end(), k,
+            [](const KK& k, const Pairs& p) { return k < p.first; });
+      }
+      template <class KK>
+      const_iterator upper_bound(const KK& k) const
+      {
+         return std::upper_bound(begin(), end(), k,
+            [](const KK& k, const Pairs& p) { return k < p.first; });
+      }
+      template <class KK>
+      custom::pair<iterator, iterator> equal_range(const KK& k)
+      {
+         return custom::pair<iterator, iterator>(lower_bound(k), upper_bound(k));
+      }
+
+      //
+      // Range: every key in [lo, hi)
+      //
+      template <class KK>
+      size_t count_range(const KK& lo, const KK& hi) const
+      {
+         const_iterator itLo = lower_bound(lo);
+         const_iterator itHi = lower_bound(hi);
+         return itLo < itHi ? itHi - itLo : 0;
+      }
+      template <class KK, class Visit>
+      void visit_range(const KK& lo, const KK& hi, Visit visit)
+      {
+         for (iterator it = lower_bound(lo); it != end() && it->first < hi; ++it)
+            visit(*it);
+      }
+
+      //
+      // Scan: visit every element in order
+      //
+      template <class Visit>
+      void for_each(Visit visit)
+      {
+         for (iterator it = begin(); it != end(); ++it)
+            visit(*it);
+      }
+
+      //
+      // Insert
+      //
+      custom::pair<iterator, bool> insert(const Pairs& rhs)
+      {
+         iterator it = lower_bound(rhs.first);
+         if (it != end() && !(rhs.first < it->first))
+            return custom::pair<iterator, bool>(it, false);
+         return custom::pair<iterator, bool>(insertAt(it - begin(), Pairs(rhs)), true);
+      }
+      custom::pair<iterator, bool> insert(Pairs&& rhs)
+      {
+         iterator it = lower_bound(rhs.first);
+         if (it != end() && !(rhs.first < it->first))
+            return custom::pair<iterator, bool>(it, false);
+         return custom::pair<iterator, bool>(insertAt(it - begin(), std::move(rhs)), true);
+      }
+
+      // insert just before hint when the key belongs there, without a
+      // search; end() is the hint for keys that come in increasing order
+      iterator insert(iterator hint, const Pairs& rhs)
+      {
+         if ((hint == begin() || (hint - 1)->first < rhs.first) &&
+             (hint == end()   || rhs.first < hint->first))
+            return insertAt(hint - begin(), Pairs(rhs));
+         return insert(rhs).first;
+      }
+      iterator insert(iterator hint, Pairs&& rhs)
+      {
+         if ((hint == begin() || (hint - 1)->first < rhs.first) &&
+             (hint == end()   || rhs.first < hint->first))
+            return insertAt(hint - begin(), std::move(rhs));
+         return insert(std::move(rhs)).first;
+      }
+
+      template <class Iterator>
+      void insert(Iterator first, Iterator last);
+      void insert(const std::initializer_list <Pairs>& il)
+      {
+         insert(il.begin(), il.end());
+      }
+
+      // room for this many pairs before the array has to grow
+      void reserve(size_t num) { pairs.reserve(num); }
+
+      //
+      // Remove
+      //
+      void clear() noexcept
+      {
+         pairs.clear();
+      }
+      size_t erase(const K& k)
+      {
+         iterator it = find(k);
+         if (it == end())
+            return 0;
+         erase(it);
+         return 1;
+      }
+      iterator erase(iterator it)
+      {
+         return erase(it, it + 1);
+      }
+      iterator erase(iterator first, iterator last);
+
+      //
+      // Status
+      //
+      bool empty() const noexcept { return pairs.empty(); }
+      size_t size() const noexcept { return pairs.size(); }
+
+   private:
+      iterator insertAt(size_t index, Pairs&& rhs);
+
+      custom::vector <Pairs, A> pairs;   // sorted by key, no two alike
+   };
+
+   /*****************************************************
+    * FLAT MAP :: SUBSCRIPT
+    * Retrieve an element, adding it with a default
+    * value if it is not there
+    ****************************************************/
+   template <class K, class V, class A>
+   V& flat_map <K, V, A> :: operator [] (const K& k)
+   {
+      iterator it = lower_bound(k);
+      if (it == end() || k < it->first)
+         it = insertAt(it - begin(), Pairs(k, V()));
+      return it->second;
+   }
+
+   /*****************************************************
+    * FLAT MAP :: AT
+    * Retrieve an element, throwing if the key is not
+    * there
+    ****************************************************/
+   template <class K, class V, class A>
+   V& flat_map <K, V, A> :: at(const K& k)
+   {
+      iterator it = find(k);
+      if (it == end())
+         throw std::out_of_range("invalid flat_map<K, T> key");
+      return it->second;
+   }
+
+   template <class K, class V, class A>
+   const V& flat_map <K, V, A> :: at(const K& k) const
+   {
+      const_iterator it = find(k);
+      if (it == end())
+         throw std::out_of_range("invalid flat_map<K, T> key");
+      return it->second;
+   }
+
+   /*****************************************************
+    * FLAT MAP :: INSERT AT
+    * Put rhs at pairs[index], moving everything from
+    * there on back by one
+    ****************************************************/
+   template <class K, class V, class A>
+   typename flat_map <K, V, A> ::iterator flat_map <K, V, A> ::insertAt(size_t index, Pairs&& rhs)
+   {
+      size_t num = pairs.size();
+      if (index == num)
+      {
+         pairs.push_back(std::move(rhs));
+         return begin() + index;
+      }
+
+      // grow first, as the last pair must not move out from under push_back
+      if (num == pairs.capacity())
+         pairs.reserve(num * 2);
+      pairs.push_back(std::move(pairs[num - 1]));
+      for (size_t i = num - 1; i > index; i--)
+         pairs[i] = std::move(pairs[i - 1]);
+      pairs[index] = std::move(rhs);
+      return begin() + index;
+   }
+
+   /*****************************************************
+    * FLAT MAP :: INSERT RANGE
+    * Append the new pairs, sort them, and merge them
+    * with the old in one pass. A key already present,
+    * or seen earlier in the range, wins, as it would
+    * with one insert after another.
+    ****************************************************/
+   template <class K, class V, class A>
+   template <class Iterator>
+   void flat_map <K, V, A> ::insert(Iterator first, Iterator last)
+   {
+      size_t numOld = pairs.size();
+      for (Iterator it = first; it != last; ++it)
+         pairs.push_back(*it);
+      if (pairs.size() == numOld)
+         return;
+
+      auto byKey = [](const Pairs& lhs, const Pairs& rhs) { return lhs.first < rhs.first; };
+      iterator itNew = begin() + numOld;
+      std::stable_sort(itNew, end(), byKey);
+      if (numOld != 0 && !byKey(*(itNew - 1), *itNew))
+         std::inplace_merge(begin(), itNew, end(), byKey);
+
+      // keep the first of each run of equal keys
+      iterator itKeep = begin();
+      for (iterator it = begin() + 1; it != end(); ++it)
+         if (byKey(*itKeep, *it) && ++itKeep != it)
+            *itKeep = std::move(*it);
+      size_t numKeep = itKeep - begin() + 1;
+      while (pairs.size() > numKeep)
+         pairs.pop_back();
+   }
+
+   /*****************************************************
+    * FLAT MAP :: ERASE
+    * Remove [first, last), moving everything after it
+    * forward
+    ****************************************************/
+   template <class K, class V, class A>
+   typename flat_map <K, V, A> ::iterator flat_map <K, V, A> ::erase(iterator first, iterator last)
+   {
+      size_t index = first - begin();
+      size_t num = last - first;
+      if (num == 0)
+         return first;
+
+      for (iterator it = last; it != end(); ++it)
+         *(it - num) = std::move(*it);
+      for (size_t i = 0; i < num; i++)
+         pairs.pop_back();
+      return begin() + index;
+   }
+
+   /*****************************************************
+    * SWAP
+    * Swap two flat maps
+    ****************************************************/
+   template <class K, class V, class A>
+   void swap(flat_map <K, V, A>& lhs, flat_map <K, V, A>& rhs)
+   {
+      lhs.pairs.swap(rhs.pairs);
+   }
+
+} // namespace custom
@@ -21,6 +21,7 @@
 
 #include "pair.h"     // for pair
 #include "bst.h"      // no nested class necessary for this assignment
+#include <stdexcept>  // for OUT_OF_RANGE
 
 #ifndef debug
 #ifdef DEBUG
@@ -31,6 +32,7 @@
 #endif // !debug
 
 class TestMap; // forward declaration for unit tests
+class TestSlabAllocator;
 
 namespace custom
 {
@@ -39,19 +41,21 @@ namespace custom
  * MAP
  * Create a Map, similar to a Binary Search Tree
  *****************************************************************/
-template <class K, class V>
+template <class K, class V, class A = std::allocator<custom::pair<K, V>>>
 class map
 {
    friend ::TestMap; // give unit tests access to the privates
-   template <class KK, class VV>
-   friend void swap(map<KK, VV>& lhs, map<KK, VV>& rhs);
+   friend ::TestSlabAllocator;
+   template <class KK, class VV, class AA>
+   friend void swap(map<KK, VV, AA>& lhs, map<KK, VV, AA>& rhs);
 public:
    using Pairs = custom::pair<K, V>;
+   typedef typename BST <Pairs, A> ::node_handle node_type;
 
    // 
    // Construct
    //
-   map() 
+   map(const A& a = A()) : bst(a)
    {
    }
    map(const map &  rhs) 
@@ -63,19 +67,18 @@ public:
       bst = std::move(rhs.bst);
    }
    template <class Iterator>
-   map(Iterator first, Iterator last) 
+   map(Iterator first, Iterator last, const A& a = A()) : bst(a)
    {
-      bst = BST<Pairs>();
-      Iterator scanner = first;
-      while (scanner != last)
-      {
-         bst.insert(*scanner);
-         scanner++;
-      }
+      assign(first, last);
+   }
+   template <class Iterator>
+   map(sorted_range_t, Iterator first, Iterator last, const A& a = A()) : bst(a)
+   {
+      bst.buildSorted(first, last, true /* keepUnique */);
    }
-   map(const std::initializer_list <Pairs>& il) 
+   map(const std::initializer_list <Pairs>& il, const A& a = A()) : bst(a)
    {
-      bst = BST<Pairs>(il);
+      assign(il.begin(), il.end());
    }
   ~map()         
    {
@@ -96,7 +99,7 @@ public:
    }
    map & operator = (const std::initializer_list <Pairs> & il)
    {
-      bst = BST<Pairs>(il);
+      assign(il.begin(), il.end());
       return *this;
    }
    
@@ -104,26 +107,61 @@ public:
    // Iterator
    //
    class iterator;
-   iterator begin() 
+   iterator begin() const
    { 
       return bst.begin();
    }
-   iterator end() 
+   iterator end() const
    { 
       return bst.end();
    }
 
-   // 
-   // Access
+   //
+   // Access: lookups take the key or anything that compares with
+   // it, such as a string_view for a string key, and never build
+   // a pair to search with
    //
    const V & operator [] (const K & k) const;
          V & operator [] (const K & k);
    const V & at (const K& k) const;
          V & at (const K& k);
-   iterator    find(const K & k)
+   template <class KK>
+   iterator find(const KK & k) const
    {
-      return bst.find(pair<K, V>(k, NULL));
+      return bst.find(k);
    }
+   template <class KK>
+   iterator lower_bound(const KK & k) const
+   {
+      return bst.lower_bound(k);
+   }
+   template <class KK>
+   iterator upper_bound(const KK & k) const
+   {
+      return bst.upper_bound(k);
+   }
+   template <class KK>
+   custom::pair<iterator, iterator> equal_range(const KK & k) const
+   {
+      return custom::pair<iterator, iterator>(lower_bound(k), upper_bound(k));
+   }
+
+   //
+   // Range: every key in [lo, hi)
+   //
+   template <class KK>
+   size_t count_range(const KK & lo, const KK & hi) const
+   {
+      return bst.count_range(lo, hi);
+   }
+   template <class KK, class Visit>
+   void visit_range(const KK & lo, const KK & hi, Visit visit);
+
+   //
+   // Scan: visit every element in order
+   //
+   template <class Visit>
+   void for_each(Visit visit);
 
    //
    // Insert
@@ -139,6 +177,59 @@ public:
       return make_pair(iterator(i.first), i.second);
    }
 
+   // insert just before hint when the key belongs there, without a
+   // search; end() is the hint for keys that come in increasing order
+   iterator insert(iterator hint, const Pairs & rhs)
+   {
+      return bst.insert(hint.it, rhs, true /* keepUnique */);
+   }
+   iterator insert(iterator hint, Pairs && rhs)
+   {
+      return bst.insert(hint.it, std::move(rhs), true /* keepUnique */);
+   }
+
+   // insert a value built from args unless k is already there. The
+   // tree is searched once, and the value is built in its node only
+   // when k is new; args are left alone if it is not.
+   template <class ... Args>
+   custom::pair<iterator, bool> try_emplace(const K & k, Args && ... args)
+   {
+      auto i = bst.emplace_key(k, std::piecewise_construct, k, std::forward<Args>(args)...);
+      return make_pair(iterator(i.first), i.second);
+   }
+   template <class ... Args>
+   custom::pair<iterator, bool> try_emplace(K && k, Args && ... args)
+   {
+      auto i = bst.emplace_key(k, std::piecewise_construct, std::move(k), std::forward<Args>(args)...);
+      return make_pair(iterator(i.first), i.second);
+   }
+
+   // insert k with v, or give k the value v if it is already there
+   template <class M>
+   custom::pair<iterator, bool> insert_or_assign(const K & k, M && v)
+   {
+      auto i = try_emplace(k, std::forward<M>(v));
+      if (!i.second)
+         (*i.first).second = std::forward<M>(v);
+      return i;
+   }
+   template <class M>
+   custom::pair<iterator, bool> insert_or_assign(K && k, M && v)
+   {
+      auto i = try_emplace(std::move(k), std::forward<M>(v));
+      if (!i.second)
+         (*i.first).second = std::forward<M>(v);
+      return i;
+   }
+
+   // put an extracted node back in a map; if its key is already
+   // there, nh keeps the node
+   custom::pair<iterator, bool> insert(node_type && nh)
+   {
+      auto i = bst.insert(std::move(nh), true /* keepUnique */);
+      return make_pair(iterator(i.first), i.second);
+   }
+
    template <class Iterator>
    void insert(Iterator first, Iterator last)
    {
@@ -168,17 +259,53 @@ public:
    iterator erase(iterator it);
    iterator erase(iterator first, iterator last);
 
+   // take an element out, node and all, to insert elsewhere
+   node_type extract(const K& k)
+   {
+      return bst.extract(k);
+   }
+   node_type extract(iterator it)
+   {
+      return bst.extract(it.it);
+   }
+
+   // move over every element of rhs whose key is not here yet,
+   // relinking the nodes rather than copying them
+   void merge(map & rhs)
+   {
+      bst.merge(rhs.bst);
+   }
+   void merge(map && rhs)
+   {
+      bst.merge(rhs.bst);
+   }
+
    //
    // Status
    //
-   bool empty() const noexcept { return false; }
-   size_t size() const noexcept { return 99; }
+   bool empty() const noexcept { return bst.empty(); }
+   size_t size() const noexcept { return bst.size(); }
 
 
 private:
 
+   // sorted input is built in one pass, anything else is inserted;
+   // a single-pass range is always inserted, as it can be read once
+   template <class Iterator>
+   void assign(Iterator first, Iterator last)
+   {
+      if (BST<Pairs, A>::canBuildSorted(first, last))
+         bst.buildSorted(first, last, true /* keepUnique */);
+      else
+      {
+         bst.clear();
+         for (Iterator it = first; it != last; ++it)
+            bst.insert(*it, true /* keepUnique */);
+      }
+   }
+
    // the students DO NOT need to use a nested class
-   BST < pair <K, V >> bst;
+   BST < pair <K, V >, A > bst;
 };
 
 
@@ -187,23 +314,25 @@ private:
  * Forward and reverse iterator through a Map, just call
  * through to BSTIterator
  *********************************************************/
-template <typename K, typename V>
-class map <K, V> :: iterator
+template <typename K, typename V, typename A>
+class map <K, V, A> :: iterator
 {
    friend class ::TestMap; // give unit tests access to the privates
-   template <class KK, class VV>
+   template <class KK, class VV, class AA>
    friend class custom::map;
+   template <class TT, class AA, class II>
+   friend class custom::multi_tree;
 public:
    //
    // Construct
    //
    iterator()
    {
-      it = custom::BST<Pairs>::iterator();
+      it = typename custom::BST<Pairs, A>::iterator();
    }
-   iterator(const typename BST < pair <K, V> > :: iterator & rhs)
+   iterator(const typename BST < pair <K, V>, A > :: iterator & rhs)
    { 
-      it = custom::BST<Pairs>::iterator(rhs);
+      it = typename custom::BST<Pairs, A>::iterator(rhs);
    }
    iterator(const iterator & rhs) 
    {
@@ -222,8 +351,8 @@ public:
    //
    // Compare
    //
-   bool operator == (const iterator & rhs) const { return false; }
-   bool operator != (const iterator & rhs) const { return false; }
+   bool operator == (const iterator & rhs) const { return it == rhs.it; }
+   bool operator != (const iterator & rhs) const { return it != rhs.it; }
 
    // 
    // Access
@@ -263,62 +392,94 @@ public:
 private:
 
    // Member variable
-   typename BST < pair <K, V >>  :: iterator it;   
+   typename BST < pair <K, V >, A >  :: iterator it;   
 };
 
 
 /*****************************************************
  * MAP :: SUBSCRIPT
- * Retrieve an element from the map
+ * Retrieve an element from the map, adding it with a
+ * default value if it is not there
  ****************************************************/
-template <typename K, typename V>
-V& map <K, V> :: operator [] (const K& key)
+template <typename K, typename V, typename A>
+V& map <K, V, A> :: operator [] (const K& key)
 {
-   iterator it = bst.find(key);
-   if (it == bst.end())
-   {
-      bst.insert(pair<K, V>(key, V()), false);
-      it = bst.find(key);
-   }
-   return (*it).second;
+   return (*try_emplace(key).first).second;
 }
 
 /*****************************************************
  * MAP :: SUBSCRIPT
  * Retrieve an element from the map
  ****************************************************/
-template <typename K, typename V>
-const V& map <K, V> :: operator [] (const K& key) const
+template <typename K, typename V, typename A>
+const V& map <K, V, A> :: operator [] (const K& key) const
 {
    return (*find(key)).second;
 }
 
 /*****************************************************
  * MAP :: AT
- * Retrieve an element from the map
+ * Retrieve an element from the map, throwing if the
+ * key is not there
  ****************************************************/
-template <typename K, typename V>
-V& map <K, V> ::at(const K& key)
+template <typename K, typename V, typename A>
+V& map <K, V, A> ::at(const K& key)
 {
-   return *(new V);
+   iterator it = bst.find(key);
+   if (it == bst.end())
+      throw std::out_of_range("invalid map<K, T> key");
+   return (*it).second;
 }
 
 /*****************************************************
  * MAP :: AT
- * Retrieve an element from the map
+ * Retrieve an element from the map, throwing if the
+ * key is not there
+ ****************************************************/
+template <typename K, typename V, typename A>
+const V& map <K, V, A> ::at(const K& key) const
+{
+   auto it = bst.find(key);
+   if (it == bst.end())
+      throw std::out_of_range("invalid map<K, T> key");
+   return (*it).second;
+}
+
+/*****************************************************
+ * MAP :: VISIT RANGE
+ * Call visit(pair) on each element whose key is in
+ * [lo, hi), in order. The visitor may change the
+ * values but not the keys.
+ ****************************************************/
+template <typename K, typename V, typename A>
+template <class KK, class Visit>
+void map <K, V, A> ::visit_range(const KK& lo, const KK& hi, Visit visit)
+{
+   typename BST <Pairs, A> ::stack_iterator it(bst.root, lo);
+   for (; it != bst.scan_end() && (*it).first < hi; ++it)
+      visit(it.node()->data);
+}
+
+/*****************************************************
+ * MAP :: FOR EACH
+ * Call visit(pair) on every element in order. This
+ * is the fast way to scan the whole map. The visitor
+ * may change the values but not the keys.
  ****************************************************/
-template <typename K, typename V>
-const V& map <K, V> ::at(const K& key) const
+template <typename K, typename V, typename A>
+template <class Visit>
+void map <K, V, A> ::for_each(Visit visit)
 {
-   return *(new V);
+   for (auto it = bst.scan_begin(); it != bst.scan_end(); ++it)
+      visit(it.node()->data);
 }
 
 /*****************************************************
  * SWAP
  * Swap two maps
  ****************************************************/
-template <typename K, typename V>
-void swap(map <K, V>& lhs, map <K, V>& rhs)
+template <typename K, typename V, typename A>
+void swap(map <K, V, A>& lhs, map <K, V, A>& rhs)
 {
    swap(lhs.bst, rhs.bst);
 }
@@ -327,11 +488,11 @@ void swap(map <K, V>& lhs, map <K, V>& rhs)
  * ERASE
  * Erase one element
  ****************************************************/
-template <typename K, typename V>
-size_t map<K, V>::erase(const K& k)
+template <typename K, typename V, typename A>
+size_t map <K, V, A>::erase(const K& k)
 {
    auto item = bst.find(k);
-   if (item == nullptr)
+   if (item == bst.end())
       return 0;
 
    bst.erase(item);
@@ -342,8 +503,8 @@ size_t map<K, V>::erase(const K& k)
  * ERASE
  * Erase several elements
  ****************************************************/
-template <typename K, typename V>
-typename map<K, V>::iterator map<K, V>::erase(map<K, V>::iterator first, map<K, V>::iterator last)
+template <typename K, typename V, typename A>
+typename map <K, V, A>::iterator map <K, V, A>::erase(map <K, V, A>::iterator first, map <K, V, A>::iterator last)
 {
    iterator it = first;
    while (it != last) {
@@ -356,8 +517,8 @@ typename map<K, V>::iterator map<K, V>::erase(map<K, V>::iterator first, map<K,
  * ERASE
  * Erase one element
  ****************************************************/
-template <typename K, typename V>
-typename map<K, V>::iterator map<K, V>::erase(map<K, V>::iterator it)
+template <typename K, typename V, typename A>
+typename map <K, V, A>::iterator map <K, V, A>::erase(map <K, V, A>::iterator it)
 {
    return bst.erase(it.it);
 }
@@ -0,0 +1,267 @@
+/***********************************************************************
+ * Header:
+ *    MULTI MAP
+ * Summary:
+ *    Ordered containers that keep every value inserted, equal keys
+ *    and all, in one BST. Equal keys sit next to each other in the
+ *    order they came in, so everything under a key is a contiguous
+ *    run: equal_range() finds its two ends in two descents and
+ *    count() walks it, O(log n + k) for k equal elements. Each
+ *    element is one node, with no container per key.
+ *
+ *    This will contain the class definition of:
+ *        multi_tree            : The BST shared by the containers
+ *        multiset              : An ordered set that keeps duplicates
+ *        multimap              : An ordered map that keeps duplicate keys
+ * Author
+ *    Gabe Lytle, M. Scott O'Connor
+ ************************************************************************/
+
+#pragma once
+
+#include <initializer_list>
+#include <memory>      // for std::allocator
+#include "pair.h"      // for custom::pair
+#include "bst.h"       // for BST
+#include "map.h"       // for map::iterator
+
+class TestMultiMap;    // forward declaration for unit tests
+
+namespace custom
+{
+
+   /*****************************************************************
+    * MULTI TREE
+    * The BST behind the multi containers, inserting without
+    * keepUnique so a new value goes after any equal to it. Lookups
+    * take a key or anything that compares with it, as they do in
+    * map. Iterator is what the container hands out: the BST's own
+    * iterator, or map's for a multimap so the values can change.
+    *****************************************************************/
+   template <class T, class A, class Iterator>
+   class multi_tree
+   {
+      friend class ::TestMultiMap; // give unit tests access to the privates
+   public:
+      typedef Iterator iterator;
+      typedef typename BST <T, A> ::node_handle node_type;
+
+      //
+      // Construct
+      //
+
+      multi_tree(const A& a) : bst(a) {}
+      template <class It>
+      multi_tree(It first, It last, const A& a) : bst(a)
+      {
+         insert(first, last);
+      }
+
+      //
+      // Assign
+      //
+
+      void swap(multi_tree& rhs) { bst.swap(rhs.bst); }
+
+      //
+      // Iterator
+      //
+
+      iterator begin() const { return bst.begin(); }
+      iterator end()   const { return bst.end(); }
+
+      //
+      // Access: find gives the first of the equal elements
+      //
+
+      template <class K>
+      iterator find(const K& k) const
+      {
+         return bst.find(k);
+      }
+      template <class K>
+      iterator lower_bound(const K& k) const
+      {
+         return bst.lower_bound(k);
+      }
+      template <class K>
+      iterator upper_bound(const K& k) const
+      {
+         return bst.upper_bound(k);
+      }
+      template <class K>
+      custom::pair<iterator, iterator> equal_range(const K& k) const
+      {
+         return custom::pair<iterator, iterator>(lower_bound(k), upper_bound(k));
+      }
+      template <class K>
+      size_t count(const K& k) const;
+
+      //
+      // Insert: always succeeds, after anything equal
+      //
+
+      iterator insert(const T& t)
+      {
+         return bst.insert(t).first;
+      }
+      iterator insert(T&& t)
+      {
+         return bst.insert(std::move(t)).first;
+      }
+      iterator insert(iterator hint, const T& t)
+      {
+         return bst.insert(unwrap(hint), t);
+      }
+      iterator insert(iterator hint, T&& t)
+      {
+         return bst.insert(unwrap(hint), std::move(t));
+      }
+      template <class It>
+      void insert(It first, It last);
+      void insert(const std::initializer_list <T>& il)
+      {
+         insert(il.begin(), il.end());
+      }
+
+      //
+      // Node handles
+      //
+
+      iterator insert(node_type&& nh)
+      {
+         return bst.insert(std::move(nh)).first;
+      }
+      node_type extract(iterator it)
+      {
+         return bst.extract(unwrap(it));
+      }
+      template <class K>
+      node_type extract(const K& k)
+      {
+         return bst.extract(k);
+      }
+
+      //
+      // Remove: erasing a key erases every element with it
+      //
+
+      void clear() noexcept
+      {
+         bst.clear();
+      }
+      template <class K>
+      size_t erase(const K& k);
+      iterator erase(iterator it)
+      {
+         typename BST <T, A> ::iterator itTree = unwrap(it);
+         return bst.erase(itTree);
+      }
+      iterator erase(iterator first, iterator last)
+      {
+         while (first != last)
+            first = erase(first);
+         return first;
+      }
+
+      //
+      // Status
+      //
+
+      bool empty() const noexcept { return bst.empty(); }
+      size_t size() const noexcept { return bst.size(); }
+
+   private:
+      // the BST iterator inside the one handed out
+      static typename BST <T, A> ::iterator unwrap(const typename BST <T, A> ::iterator& it) { return it; }
+      template <class It>
+      static typename BST <T, A> ::iterator unwrap(const It& it) { return it.it; }
+
+      BST <T, A> bst;
+   };
+
+   /*****************************************************
+    * MULTI TREE :: COUNT
+    * Walk the run of elements equal to k
+    ****************************************************/
+   template <class T, class A, class Iterator>
+   template <class K>
+   size_t multi_tree <T, A, Iterator> ::count(const K& k) const
+   {
+      size_t num = 0;
+      auto itEnd = bst.upper_bound(k);
+      for (auto it = bst.lower_bound(k); it != itEnd; ++it)
+         num++;
+      return num;
+   }
+
+   /*****************************************************
+    * MULTI TREE :: INSERT RANGE
+    * Sorted input into an empty tree is built in one
+    * pass, duplicates and all; anything else, and any
+    * range that can only be read once, is inserted one
+    * at a time
+    ****************************************************/
+   template <class T, class A, class Iterator>
+   template <class It>
+   void multi_tree <T, A, Iterator> ::insert(It first, It last)
+   {
+      if (bst.empty() && BST <T, A> ::canBuildSorted(first, last))
+         bst.buildSorted(first, last, false /* keepUnique */);
+      else
+         for (It it = first; it != last; ++it)
+            bst.insert(*it);
+   }
+
+   /*****************************************************
+    * MULTI TREE :: ERASE
+    * Erase every element equal to k
+    ****************************************************/
+   template <class T, class A, class Iterator>
+   template <class K>
+   size_t multi_tree <T, A, Iterator> ::erase(const K& k)
+   {
+      size_t num = 0;
+      auto it = bst.lower_bound(k);
+      while (it != bst.end() && !BST <T, A> ::keyLess(k, *it))
+      {
+         it = bst.erase(it);
+         num++;
+      }
+      return num;
+   }
+
+   /*****************************************************************
+    * MULTISET
+    * An ordered set of values, keeping duplicates
+    *****************************************************************/
+   template <class T, class A = std::allocator<T>>
+   class multiset : public multi_tree <T, A, typename BST <T, A> ::iterator>
+   {
+      typedef multi_tree <T, A, typename BST <T, A> ::iterator> Base;
+   public:
+      multiset(const A& a = A()) : Base(a) {}
+      template <class It>
+      multiset(It first, It last, const A& a = A()) : Base(first, last, a) {}
+      multiset(const std::initializer_list <T>& il, const A& a = A()) : Base(il.begin(), il.end(), a) {}
+   };
+
+   /*****************************************************************
+    * MULTIMAP
+    * An ordered map from keys to values, where a key may have any
+    * number of values
+    *****************************************************************/
+   template <class K, class V, class A = std::allocator<custom::pair<K, V>>>
+   class multimap : public multi_tree <custom::pair <K, V>, A, typename map <K, V, A> ::iterator>
+   {
+      typedef multi_tree <custom::pair <K, V>, A, typename map <K, V, A> ::iterator> Base;
+   public:
+      using Pairs = custom::pair<K, V>;
+
+      multimap(const A& a = A()) : Base(a) {}
+      template <class It>
+      multimap(It first, It last, const A& a = A()) : Base(first, last, a) {}
+      multimap(const std::initializer_list <Pairs>& il, const A& a = A()) : Base(il.begin(), il.end(), a) {}
+   };
+
+} // namespace custom
@@ -9,11 +9,44 @@
 
 #pragma once
 
-#include <iostream>  // for ISTREAM and OSTREAM
+#include <iostream>     // for ISTREAM and OSTREAM
+#include <functional>   // for std::less
+#include <utility>      // for std::piecewise_construct
+#include <type_traits>  // for std::is_empty
 
 namespace custom
 {
 
+template <class T>
+struct keyOf;
+
+/**********************************************
+ * PAIR COMPARE
+ * Holds the comparator of a pair. One with no state, such as
+ * std::less, is an empty base and takes no room in the pair, so
+ * a pair in a map is only its two values and building one copies
+ * nothing more.
+ ***********************************************/
+template <class C, bool IsEmpty = std::is_empty<C>::value>
+class PairCompare
+{
+public:
+   PairCompare(const C& c) : c(c) {}
+   template <class T>
+   bool compare(const T& lhs, const T& rhs) const { return c(lhs, rhs); }
+private:
+   C c;                       // comparision operator
+};
+
+template <class C>
+class PairCompare <C, true> : private C
+{
+public:
+   PairCompare(const C& c) : C(c) {}
+   template <class T>
+   bool compare(const T& lhs, const T& rhs) const { return C::operator () (lhs, rhs); }
+};
+
 /**********************************************
  * PAIR
  * This class couples together a pair of values, which may be of
@@ -24,8 +57,11 @@ namespace custom
  * is a key in a name-value pair.
  ***********************************************/
 template <class T1, class T2, typename C = std::less<T1>>
-class pair
+class pair : private PairCompare<C>
 {
+   using PairCompare<C>::compare;
+   template <class T>
+   friend struct keyOf;       // so a key alone compares by C too
 public:
    //
    // Constructors
@@ -33,23 +69,28 @@ public:
    
    // Default Constructor: call the T1, T2 default constructors
    pair(const C& c = C())
-       : first(     ), second(      ), compare(c) {}
+       : PairCompare<C>(c), first(     ), second(      ) {}
    // Non-Default Constructor: call the T1, T2 copy constructors
    pair(const T1 & first, const T2 & second, const C& c = C())
-       : first(first), second(second), compare(c) {}
+       : PairCompare<C>(c), first(first), second(second) {}
    pair(const T1& first, T2 && second, const C& c = C())
-      : first(first), second(std::move(second)), compare(c) {}
+      : PairCompare<C>(c), first(first), second(std::move(second)) {}
    pair(const T1& first, const C& c = C())
-      : first(first), second(), compare(c) {}
+      : PairCompare<C>(c), first(first), second() {}
    // Copy Constructor: call the T1, T2 copy constructors
    pair(const pair <T1, T2> & rhs, const C& c = C())
-       : first(rhs.first), second(rhs.second), compare(c) {}
+       : PairCompare<C>(c), first(rhs.first), second(rhs.second) {}
    // Non-Default Move Constructor: call the T1, T2 move constructors
    pair(T1 && first, T2 && second, const C& c = C())
-       : first(std::move(first)), second(std::move(second)), compare(c) {}
+       : PairCompare<C>(c), first(std::move(first)), second(std::move(second)) {}
    // Move Constructor: call the T1, T2 move constructors
    pair(pair <T1, T2> && rhs, const C& c = C())
-       : first(std::move(rhs.first)), second(std::move(rhs.second)), compare(c) {}
+       : PairCompare<C>(c), first(std::move(rhs.first)), second(std::move(rhs.second)) {}
+   // Piecewise Constructor: first from k, second from the arguments
+   // of its constructor, so a map can build its value in place
+   template <class K, class ... Args>
+   pair(std::piecewise_construct_t, K && k, Args && ... args)
+       : PairCompare<C>(C()), first(std::forward<K>(k)), second(std::forward<Args>(args)...) {}
 
    //
    // Assignment Operators
@@ -105,9 +146,6 @@ public:
    // Get: retrieve a value
    //
    
-   C    compare;              // comparision operator
-
-   
    // these are public. We cannot validate because we know nothing about T
    T1 first;
    T2 second;
@@ -0,0 +1,638 @@
+/***********************************************************************
+ * Header:
+ *    PERSISTENT
+ * Summary:
+ *    Ordered containers where every version lives on after an update.
+ *    Copying one is O(1): the copy shares the whole tree. Nodes are
+ *    never changed once built, so an update copies only the nodes on
+ *    the path from the root down to the change, O(log n) of them,
+ *    and points the copies at the untouched subtrees it shares with
+ *    the old version. Each node counts the versions and parents that
+ *    point at it and is freed when the last one lets go.
+ *
+ *    Unlike a BST, the nodes have no parent pointer, as a shared node
+ *    has many parents. Iterators keep the way back up on a stack, and
+ *    balance is kept with AVL heights, which a rebuilt path can fix
+ *    with at most two rotations per level.
+ *
+ *    Separate versions may be read, updated, and released on
+ *    different threads at the same time, as the shared nodes never
+ *    change and the counts are atomic. A single version is not safe
+ *    to update while another thread reads it; to hand versions from
+ *    a writer to readers, store them in a published cell.
+ *
+ *    This will contain the class definition of:
+ *        persistent_tree           : The engine shared by the containers
+ *        persistent_tree::iterator : An in-order iterator with a stack
+ *        persistent_set            : An ordered set of unique values
+ *        persistent_map            : An ordered map of unique keys
+ *        published                 : The latest version, for readers
+ * Author
+ *    Gabe Lytle, M. Scott O'Connor
+ ************************************************************************/
+
+#pragma once
+
+#include <atomic>      // for std::atomic
+#include <functional>  // for std::less
+#include <initializer_list>
+#include <mutex>       // for std::mutex
+#include <stdexcept>   // for std::out_of_range
+#include <utility>     // for std::forward
+#include <vector>      // for the iterator stack
+#include "pair.h"      // for custom::pair
+
+class TestPersistent;    // forward declaration for unit tests
+
+namespace custom
+{
+
+   /*****************************************************************
+    * PERSISTENT TREE
+    * The engine behind the persistent containers. T is the stored
+    * value, KeyOf pulls the key K out of a T, and C orders keys.
+    *****************************************************************/
+   template <class T, class K, class KeyOf, class C>
+   class persistent_tree
+   {
+      friend class ::TestPersistent; // give unit tests access to the privates
+   public:
+      //
+      // Construct: a copy shares every node
+      //
+
+      persistent_tree(const C& compare = C()) : root(nullptr), numElements(0), compare(compare) {}
+      persistent_tree(const persistent_tree& rhs) :
+         root(retain(rhs.root)), numElements(rhs.numElements), compare(rhs.compare) {}
+      persistent_tree(persistent_tree&& rhs) :
+         root(rhs.root), numElements(rhs.numElements), compare(rhs.compare)
+      {
+         rhs.root = nullptr;
+         rhs.numElements = 0;
+      }
+      ~persistent_tree() { release(root); }
+
+      //
+      // Assign
+      //
+
+      persistent_tree& operator = (const persistent_tree& rhs)
+      {
+         persistent_tree copy(rhs);
+         swap(copy);
+         return *this;
+      }
+      persistent_tree& operator = (persistent_tree&& rhs)
+      {
+         persistent_tree copy(std::move(rhs));
+         swap(copy);
+         return *this;
+      }
+      void swap(persistent_tree& rhs)
+      {
+         std::swap(root, rhs.root);
+         std::swap(numElements, rhs.numElements);
+         std::swap(compare, rhs.compare);
+      }
+
+      // this version, unaffected by later updates to *this
+      persistent_tree snapshot() const { return *this; }
+
+      //
+      // Iterator: good for as long as the version it came from
+      //
+
+      class iterator;
+      iterator begin() const { return iterator(root); }
+      iterator end()   const { return iterator(); }
+
+      //
+      // Access
+      //
+
+      iterator find(const K& k) const;
+      iterator lower_bound(const K& k) const;
+      iterator upper_bound(const K& k) const;
+      size_t count(const K& k) const { return search(k) ? 1 : 0; }
+
+      // the value with key k, or nullptr: a find() that builds no
+      // iterator and so allocates nothing
+      const T* search(const K& k) const;
+
+      //
+      // Insert: false when the key is already there
+      //
+
+      bool insert(const T& t) { return update(t, false /* replace */); }
+      bool insert(T&& t)      { return update(std::move(t), false /* replace */); }
+      template <class Iterator>
+      void insert(Iterator first, Iterator last)
+      {
+         for (Iterator it = first; it != last; ++it)
+            insert(*it);
+      }
+
+      //
+      // Remove
+      //
+
+      size_t erase(const K& k);
+      void clear() noexcept
+      {
+         release(root);
+         root = nullptr;
+         numElements = 0;
+      }
+
+      //
+      // Status
+      //
+
+      bool   empty() const noexcept { return numElements == 0; }
+      size_t size()  const noexcept { return numElements; }
+
+      // is rhs this very version, not just one with the same values?
+      bool shares(const persistent_tree& rhs) const noexcept { return root == rhs.root; }
+
+   protected:
+      struct Node;
+
+      template <class U>
+      bool update(U&& t, bool replace);
+
+      // counting the references to a node
+      static Node* retain(Node* pNode)
+      {
+         if (pNode)
+            pNode->numRefs.fetch_add(1, std::memory_order_relaxed);
+         return pNode;
+      }
+      static void release(Node* pNode);
+      static int height(const Node* pNode) { return pNode ? pNode->height : 0; }
+
+      // building new nodes along the path; these take over the
+      // references to pLeft and pRight they are handed
+      static Node* balance(const T& t, Node* pLeft, Node* pRight);
+      template <class U>
+      Node* insertNode(const Node* pNode, U&& t, bool replace, bool& isChanged) const;
+      Node* eraseNode(const Node* pNode, const K& k, bool& isFound) const;
+      static Node* eraseMin(const Node* pNode, const T*& pMin);
+
+      Node* root;            // shared with every copy of this version
+      size_t numElements;    // number of elements in this version
+      C compare;             // orders the keys
+   };
+
+   /*****************************************************************
+    * PERSISTENT TREE NODE
+    * Never changed once built. The count starts at one for whoever
+    * asked for the node.
+    *****************************************************************/
+   template <class T, class K, class KeyOf, class C>
+   struct persistent_tree <T, K, KeyOf, C> ::Node
+   {
+      template <class U>
+      Node(U&& t, Node* pLeft, Node* pRight) :
+         data(std::forward<U>(t)), pLeft(pLeft), pRight(pRight),
+         height(1 + (persistent_tree::height(pLeft) > persistent_tree::height(pRight) ?
+                     persistent_tree::height(pLeft) : persistent_tree::height(pRight))),
+         numRefs(1) {}
+
+      T data;
+      Node* pLeft;
+      Node* pRight;
+      int height;                  // levels in this subtree
+      std::atomic<int> numRefs;    // versions and parents pointing here
+   };
+
+   /**********************************************************
+    * PERSISTENT TREE ITERATOR
+    * The ancestors still to visit are kept on a stack, as
+    * there are no parent pointers to climb
+    *********************************************************/
+   template <class T, class K, class KeyOf, class C>
+   class persistent_tree <T, K, KeyOf, C> ::iterator
+   {
+      friend class ::TestPersistent; // give unit tests access to the privates
+      friend class persistent_tree <T, K, KeyOf, C>;
+   public:
+      iterator() {}
+
+      bool operator == (const iterator& rhs) const { return current() == rhs.current(); }
+      bool operator != (const iterator& rhs) const { return current() != rhs.current(); }
+
+      const T& operator * () const { return current()->data; }
+      const T* operator -> () const { return &current()->data; }
+
+      iterator& operator ++ ()
+      {
+         const Node* pNode = current();
+         path.pop_back();
+         pushLeft(pNode->pRight);
+         return *this;
+      }
+      iterator operator ++ (int)
+      {
+         iterator itReturn = *this;
+         ++*this;
+         return itReturn;
+      }
+
+   private:
+      explicit iterator(const Node* pRoot) { pushLeft(pRoot); }
+
+      const Node* current() const { return path.empty() ? nullptr : path.back(); }
+      void pushLeft(const Node* pNode)
+      {
+         for (; pNode; pNode = pNode->pLeft)
+            path.push_back(pNode);
+      }
+
+      std::vector <const Node*> path;   // the current node is on top
+   };
+
+   /*********************************************
+    * PERSISTENT TREE :: RELEASE
+    * Let go of one reference. The last one out
+    * frees the node and lets go of its children.
+    ********************************************/
+   template <class T, class K, class KeyOf, class C>
+   void persistent_tree <T, K, KeyOf, C> ::release(Node* pNode)
+   {
+      while (pNode && pNode->numRefs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+      {
+         release(pNode->pLeft);
+         Node* pRight = pNode->pRight;
+         delete pNode;
+         pNode = pRight;
+      }
+   }
+
+   /*********************************************
+    * PERSISTENT TREE :: BALANCE
+    * A new node holding t over pLeft and pRight,
+    * rotated if one side is two levels taller.
+    * A rotation copies the child it lifts; the
+    * grandchildren are shared.
+    ********************************************/
+   template <class T, class K, class KeyOf, class C>
+   typename persistent_tree <T, K, KeyOf, C> ::Node*
+      persistent_tree <T, K, KeyOf, C> ::balance(const T& t, Node* pLeft, Node* pRight)
+   {
+      Node* pNew;
+      if (height(pLeft) > height(pRight) + 1)
+      {
+         Node* pLL = pLeft->pLeft;
+         Node* pLR = pLeft->pRight;
+         if (height(pLL) >= height(pLR))
+            pNew = new Node(pLeft->data, retain(pLL),
+                            new Node(t, retain(pLR), pRight));
+         else
+            pNew = new Node(pLR->data,
+                            new Node(pLeft->data, retain(pLL), retain(pLR->pLeft)),
+                            new Node(t, retain(pLR->pRight), pRight));
+         release(pLeft);
+      }
+      else if (height(pRight) > height(pLeft) + 1)
+      {
+         Node* pRL = pRight->pLeft;
+         Node* pRR = pRight->pRight;
+         if (height(pRR) >= height(pRL))
+            pNew = new Node(pRight->data, new Node(t, pLeft, retain(pRL)),
+                            retain(pRR));
+         else
+            pNew = new Node(pRL->data,
+                            new Node(t, pLeft, retain(pRL->pLeft)),
+                            new Node(pRight->data, retain(pRL->pRight), retain(pRR)));
+         release(pRight);
+      }
+      else
+         pNew = new Node(t, pLeft, pRight);
+      return pNew;
+   }
+
+   /*********************************************
+    * PERSISTENT TREE :: INSERT NODE
+    * A copy of the subtree at pNode with t in it,
+    * or nullptr if nothing changed: the key was
+    * there and is not to be replaced
+    ********************************************/
+   template <class T, class K, class KeyOf, class C>
+   template <class U>
+   typename persistent_tree <T, K, KeyOf, C> ::Node*
+      persistent_tree <T, K, KeyOf, C> ::insertNode(const Node* pNode, U&& t, bool replace,
+                                                     bool& isChanged) const
+   {
+      if (pNode == nullptr)
+      {
+         isChanged = true;
+         return new Node(std::forward<U>(t), nullptr, nullptr);
+      }
+
+      const K& k = KeyOf()(t);
+      const K& kNode = KeyOf()(pNode->data);
+      if (compare(k, kNode))
+      {
+         Node* pLeft = insertNode(pNode->pLeft, std::forward<U>(t), replace, isChanged);
+         return pLeft ? balance(pNode->data, pLeft, retain(pNode->pRight)) : nullptr;
+      }
+      if (compare(kNode, k))
+      {
+         Node* pRight = insertNode(pNode->pRight, std::forward<U>(t), replace, isChanged);
+         return pRight ? balance(pNode->data, retain(pNode->pLeft), pRight) : nullptr;
+      }
+
+      // already there
+      isChanged = false;
+      if (!replace)
+         return nullptr;
+      return new Node(std::forward<U>(t), retain(pNode->pLeft), retain(pNode->pRight));
+   }
+
+   /*********************************************
+    * PERSISTENT TREE :: UPDATE
+    * Build the new path, then let go of the old
+    * version. Returns whether the size grew.
+    ********************************************/
+   template <class T, class K, class KeyOf, class C>
+   template <class U>
+   bool persistent_tree <T, K, KeyOf, C> ::update(U&& t, bool replace)
+   {
+      bool isChanged = false;
+      Node* pNew = insertNode(root, std::forward<U>(t), replace, isChanged);
+      if (pNew == nullptr)
+         return false;
+      release(root);
+      root = pNew;
+      if (isChanged)
+         numElements++;
+      return isChanged;
+   }
+
+   /*********************************************
+    * PERSISTENT TREE :: ERASE MIN
+    * A copy of the subtree without its smallest,
+    * which is left in pMin. The old subtree must
+    * outlive the use of pMin.
+    ********************************************/
+   template <class T, class K, class KeyOf, class C>
+   typename persistent_tree <T, K, KeyOf, C> ::Node*
+      persistent_tree <T, K, KeyOf, C> ::eraseMin(const Node* pNode, const T*& pMin)
+   {
+      if (pNode->pLeft == nullptr)
+      {
+         pMin = &pNode->data;
+         return retain(pNode->pRight);
+      }
+      Node* pLeft = eraseMin(pNode->pLeft, pMin);
+      return balance(pNode->data, pLeft, retain(pNode->pRight));
+   }
+
+   /*********************************************
+    * PERSISTENT TREE :: ERASE NODE
+    * A copy of the subtree at pNode without k. A
+    * node with two children takes the place of
+    * the smallest on its right.
+    ********************************************/
+   template <class T, class K, class KeyOf, class C>
+   typename persistent_tree <T, K, KeyOf, C> ::Node*
+      persistent_tree <T, K, KeyOf, C> ::eraseNode(const Node* pNode, const K& k, bool& isFound) const
+   {
+      if (pNode == nullptr)
+      {
+         isFound = false;
+         return nullptr;
+      }
+
+      const K& kNode = KeyOf()(pNode->data);
+      if (compare(k, kNode))
+      {
+         Node* pLeft = eraseNode(pNode->pLeft, k, isFound);
+         return isFound ? balance(pNode->data, pLeft, retain(pNode->pRight)) : nullptr;
+      }
+      if (compare(kNode, k))
+      {
+         Node* pRight = eraseNode(pNode->pRight, k, isFound);
+         return isFound ? balance(pNode->data, retain(pNode->pLeft), pRight) : nullptr;
+      }
+
+      isFound = true;
+      if (pNode->pLeft == nullptr)
+         return retain(pNode->pRight);
+      if (pNode->pRight == nullptr)
+         return retain(pNode->pLeft);
+      const T* pMin = nullptr;
+      Node* pRight = eraseMin(pNode->pRight, pMin);
+      return balance(*pMin, retain(pNode->pLeft), pRight);
+   }
+
+   /*********************************************
+    * PERSISTENT TREE :: ERASE
+    ********************************************/
+   template <class T, class K, class KeyOf, class C>
+   size_t persistent_tree <T, K, KeyOf, C> ::erase(const K& k)
+   {
+      bool isFound = false;
+      Node* pNew = eraseNode(root, k, isFound);
+      if (!isFound)
+         return 0;
+      release(root);
+      root = pNew;
+      numElements--;
+      return 1;
+   }
+
+   /*********************************************
+    * PERSISTENT TREE :: LOWER BOUND
+    * The path down to the first value not less
+    * than k: every node where the search went
+    * left is still to be visited
+    ********************************************/
+   template <class T, class K, class KeyOf, class C>
+   typename persistent_tree <T, K, KeyOf, C> ::iterator
+      persistent_tree <T, K, KeyOf, C> ::lower_bound(const K& k) const
+   {
+      iterator it;
+      for (const Node* pNode = root; pNode; )
+         if (compare(KeyOf()(pNode->data), k))
+            pNode = pNode->pRight;
+         else
+         {
+            it.path.push_back(pNode);
+            pNode = pNode->pLeft;
+         }
+      return it;
+   }
+
+   /*********************************************
+    * PERSISTENT TREE :: UPPER BOUND
+    * The same, for the first value greater than k
+    ********************************************/
+   template <class T, class K, class KeyOf, class C>
+   typename persistent_tree <T, K, KeyOf, C> ::iterator
+      persistent_tree <T, K, KeyOf, C> ::upper_bound(const K& k) const
+   {
+      iterator it;
+      for (const Node* pNode = root; pNode; )
+         if (compare(k, KeyOf()(pNode->data)))
+         {
+            it.path.push_back(pNode);
+            pNode = pNode->pLeft;
+         }
+         else
+            pNode = pNode->pRight;
+      return it;
+   }
+
+   /*********************************************
+    * PERSISTENT TREE :: SEARCH
+    ********************************************/
+   template <class T, class K, class KeyOf, class C>
+   const T* persistent_tree <T, K, KeyOf, C> ::search(const K& k) const
+   {
+      for (const Node* pNode = root; pNode; )
+         if (compare(k, KeyOf()(pNode->data)))
+            pNode = pNode->pLeft;
+         else if (compare(KeyOf()(pNode->data), k))
+            pNode = pNode->pRight;
+         else
+            return &pNode->data;
+      return nullptr;
+   }
+
+   /*********************************************
+    * PERSISTENT TREE :: FIND
+    ********************************************/
+   template <class T, class K, class KeyOf, class C>
+   typename persistent_tree <T, K, KeyOf, C> ::iterator
+      persistent_tree <T, K, KeyOf, C> ::find(const K& k) const
+   {
+      iterator it = lower_bound(k);
+      if (it != end() && compare(k, KeyOf()(*it)))
+         return end();
+      return it;
+   }
+
+   /*****************************************************************
+    * KEY EXTRACTORS
+    *****************************************************************/
+   template <class T>
+   struct persistentIdentity
+   {
+      const T& operator () (const T& t) const { return t; }
+   };
+   template <class K, class V>
+   struct persistentFirst
+   {
+      const K& operator () (const custom::pair<K, V>& p) const { return p.first; }
+   };
+
+   /*****************************************************************
+    * PERSISTENT SET
+    * An ordered set of unique values
+    *****************************************************************/
+   template <class T, class C = std::less<T>>
+   class persistent_set : public persistent_tree<T, T, persistentIdentity<T>, C>
+   {
+      typedef persistent_tree<T, T, persistentIdentity<T>, C> Base;
+   public:
+      persistent_set(const C& compare = C()) : Base(compare) {}
+      persistent_set(const std::initializer_list<T>& il)
+      {
+         this->insert(il.begin(), il.end());
+      }
+      template <class Iterator>
+      persistent_set(Iterator first, Iterator last)
+      {
+         this->insert(first, last);
+      }
+
+      persistent_set snapshot() const { return *this; }
+   };
+
+   /*****************************************************************
+    * PERSISTENT MAP
+    * An ordered map of unique keys. The values are as read-only as
+    * the keys, since they may be shared with other versions; change
+    * one with insert_or_assign().
+    *****************************************************************/
+   template <class K, class V, class C = std::less<K>>
+   class persistent_map : public persistent_tree<custom::pair<K, V>, K, persistentFirst<K, V>, C>
+   {
+      typedef persistent_tree<custom::pair<K, V>, K, persistentFirst<K, V>, C> Base;
+   public:
+      using Pairs = custom::pair<K, V>;
+
+      persistent_map(const C& compare = C()) : Base(compare) {}
+      persistent_map(const std::initializer_list<Pairs>& il)
+      {
+         this->insert(il.begin(), il.end());
+      }
+      template <class Iterator>
+      persistent_map(Iterator first, Iterator last)
+      {
+         this->insert(first, last);
+      }
+
+      persistent_map snapshot() const { return *this; }
+
+      //
+      // Access
+      //
+      const V& at(const K& k) const
+      {
+         const Pairs* pPair = this->search(k);
+         if (pPair == nullptr)
+            throw std::out_of_range("invalid persistent_map<K, V> key");
+         return pPair->second;
+      }
+
+      //
+      // Insert: true if the key is new, false if its value was replaced
+      //
+      bool insert_or_assign(const K& k, const V& v)
+      {
+         return this->update(Pairs(k, v), true /* replace */);
+      }
+   };
+
+   /*****************************************************************
+    * PUBLISHED
+    * The latest version of a persistent container, handed from a
+    * writer to readers. The lock is held only to copy the root
+    * pointer and count it, never for a search or an update, and a
+    * version replaced by store() is freed outside the lock.
+    *****************************************************************/
+   template <class Tree>
+   class published
+   {
+      friend class ::TestPersistent; // give unit tests access to the privates
+   public:
+      published() {}
+      published(const Tree& tree) : latest(tree) {}
+      published(const published& rhs) = delete;
+      published& operator = (const published& rhs) = delete;
+
+      // a version of its own for a reader to search at leisure
+      Tree load() const
+      {
+         std::lock_guard<std::mutex> guard(mutexLatest);
+         return latest;
+      }
+
+      // make tree the version that later loads see
+      void store(Tree tree)
+      {
+         {
+            std::lock_guard<std::mutex> guard(mutexLatest);
+            latest.swap(tree);
+         }
+         // tree now holds the old version and is released here
+      }
+
+   private:
+      mutable std::mutex mutexLatest;   // guards the latest pointer
+      Tree latest;
+   };
+
+} // namespace custom
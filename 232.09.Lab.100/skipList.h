@@ -0,0 +1,704 @@
+/***********************************************************************
+ * Header:
+ *    SKIP LIST
+ * Summary:
+ *    Ordered containers built from linked nodes, like the ones in
+ *    node.h, where each node also carries a random number of "express"
+ *    links that skip over its neighbors. Searching drops from the
+ *    highest express lane to the lowest, giving O(log n) expected
+ *    find and insert with a plain linked walk for range scans.
+ *
+ *    Links are atomic and every insert publishes a fully built node
+ *    with a single release store per level, so readers never need a
+ *    lock. The concurrent variant adds a writer mutex and defers
+ *    freeing erased nodes so lookups may run alongside updates.
+ *
+ *    This will contain the class definition of:
+ *        skiplist                 : The engine shared by the containers
+ *        skiplist_set             : An ordered set of unique values
+ *        skiplist_map             : An ordered map of unique keys
+ *        concurrent_skiplist_set  : skiplist_set with lock-free readers
+ * Author
+ *    Gabe Lytle, M. Scott O'Connor
+ ************************************************************************/
+
+#pragma once
+
+#include <atomic>      // for std::atomic
+#include <cassert>
+#include <functional>  // for std::less
+#include <initializer_list>
+#include <mutex>       // for std::mutex
+#include <new>         // for placement new
+#include <stdexcept>   // for std::out_of_range
+#include <utility>     // for std::pair
+#include <vector>      // for the retired nodes
+#include "pair.h"      // for custom::pair
+
+class TestSkipList;    // forward declaration for unit tests
+
+namespace custom
+{
+
+   /*****************************************************************
+    * SKIP LIST
+    * The engine behind the skip list containers. T is the stored
+    * value, KeyOf pulls the key K out of a T, and C orders keys.
+    *****************************************************************/
+   template <class T, class K, class KeyOf, class C>
+   class skiplist
+   {
+      friend class ::TestSkipList; // give unit tests access to the privates
+   public:
+      //
+      // Construct
+      //
+
+      skiplist(const C& compare = C());
+      skiplist(const skiplist& rhs);
+      skiplist(skiplist&& rhs);
+      ~skiplist() { clear(); }
+
+      //
+      // Assign
+      //
+
+      skiplist& operator = (const skiplist& rhs);
+      skiplist& operator = (skiplist&& rhs);
+      void swap(skiplist& rhs);
+
+      //
+      // Iterator
+      //
+
+      class iterator;
+      iterator begin() const { return iterator(head[0].load(std::memory_order_acquire)); }
+      iterator end()   const { return iterator(nullptr); }
+
+      //
+      // Access
+      //
+
+      iterator find(const K& k) const;
+      iterator lower_bound(const K& k) const { return iterator(lowerBound(k)); }
+      iterator upper_bound(const K& k) const { return iterator(upperBound(k)); }
+      bool contains(const K& k) const { return find(k) != end(); }
+
+      //
+      // Insert
+      //
+
+      std::pair<iterator, bool> insert(const T& t) { return emplaceUnique(KeyOf()(t), t); }
+      std::pair<iterator, bool> insert(T&& t)
+      {
+         K k = KeyOf()(t);
+         return emplaceUnique(k, std::move(t));
+      }
+
+      //
+      // Remove
+      //
+
+      size_t erase(const K& k);
+      iterator erase(iterator it);
+      void clear() noexcept;
+
+      //
+      // Status
+      //
+
+      bool   empty() const noexcept { return size() == 0; }
+      size_t size()  const noexcept { return numElements.load(std::memory_order_relaxed); }
+
+   protected:
+      class Node;
+      typedef std::atomic<Node*> Link;
+
+      static const int MAX_LEVEL = 24;   // enough for 4^24 elements
+
+      Node* lowerBound(const K& k) const;
+      Node* upperBound(const K& k) const;
+      void findPrevious(const K& k, Link** update) const;
+      template <class ... Args>
+      std::pair<iterator, bool> emplaceUnique(const K& k, Args&& ... args);
+      Node* unlink(const K& k);
+      int randomLevel();
+
+      Link head[MAX_LEVEL];              // the first node on each level
+      std::atomic<int> numLevels;        // number of levels in use
+      std::atomic<size_t> numElements;   // number of elements currently in the list
+      unsigned int seed;                 // state for choosing node heights
+      C compare;                         // orders the keys
+   };
+
+   /*****************************************************************
+    * SKIP LIST NODE
+    * A node with one forward link per level. The links are a tower
+    * of Links built in the same allocation right after the node, so
+    * a node is a single allocation no matter how tall it is.
+    *****************************************************************/
+   template <class T, class K, class KeyOf, class C>
+   class skiplist <T, K, KeyOf, C> ::Node
+   {
+   public:
+      //
+      // Construct: use create() and destroy() since nodes vary in size
+      //
+      template <class ... Args>
+      static Node* create(int height, Args&& ... args)
+      {
+         void* p = ::operator new(tower() + sizeof(Link) * height);
+         Node* pNode;
+         try
+         {
+            pNode = new (p) Node(height, std::forward<Args>(args)...);
+         }
+         catch (...)
+         {
+            ::operator delete(p);
+            throw;
+         }
+         for (int i = 0; i < height; i++)
+            new (&pNode->links()[i]) Link(nullptr);
+         return pNode;
+      }
+      static void destroy(Node* pNode)
+      {
+         for (int i = 0; i < pNode->height; i++)
+            pNode->links()[i].~Link();
+         pNode->~Node();
+         ::operator delete(pNode);
+      }
+
+      // pointer to next node, one per level
+      Link* links()
+      {
+         return reinterpret_cast<Link*>(reinterpret_cast<char*>(this) + tower());
+      }
+      const Link* links() const
+      {
+         return reinterpret_cast<const Link*>(reinterpret_cast<const char*>(this) + tower());
+      }
+
+      //
+      // Data
+      //
+      T data;            // user data
+      int height;        // number of levels this node is linked on
+
+   private:
+      // where the tower starts: the end of the node, rounded up for a Link
+      static constexpr size_t tower()
+      {
+         return (sizeof(Node) + alignof(Link) - 1) / alignof(Link) * alignof(Link);
+      }
+
+      template <class ... Args>
+      Node(int height, Args&& ... args) : data(std::forward<Args>(args)...), height(height) {}
+   };
+
+   /**********************************************************
+    * SKIP LIST ITERATOR
+    * Forward iterator along the bottom level of a skip list
+    *********************************************************/
+   template <class T, class K, class KeyOf, class C>
+   class skiplist <T, K, KeyOf, C> ::iterator
+   {
+      friend class ::TestSkipList; // give unit tests access to the privates
+      template <class TT, class KK, class KO, class CC>
+      friend class skiplist;
+      template <class KK, class VV, class CC>
+      friend class skiplist_map;
+   public:
+      // constructors and assignment
+      iterator(Node* p = nullptr) : pNode(p) {}
+      iterator(const iterator& rhs) : pNode(rhs.pNode) {}
+      iterator& operator = (const iterator& rhs)
+      {
+         pNode = rhs.pNode;
+         return *this;
+      }
+
+      // compare
+      bool operator == (const iterator& rhs) const { return pNode == rhs.pNode; }
+      bool operator != (const iterator& rhs) const { return pNode != rhs.pNode; }
+
+      // de-reference. Cannot change because it will invalidate the order
+      const T& operator * () const { return pNode->data; }
+      const T* operator -> () const { return &pNode->data; }
+
+      // increment
+      iterator& operator ++ ()
+      {
+         if (pNode)
+            pNode = pNode->links()[0].load(std::memory_order_acquire);
+         return *this;
+      }
+      iterator operator ++ (int postfix)
+      {
+         iterator itReturn = *this;
+         ++(*this);
+         return itReturn;
+      }
+
+   private:
+      Node* pNode;
+   };
+
+
+   /*********************************************
+    * SKIP LIST :: DEFAULT CONSTRUCTOR
+    ********************************************/
+   template <class T, class K, class KeyOf, class C>
+   skiplist <T, K, KeyOf, C> ::skiplist(const C& compare) :
+      numLevels(1), numElements(0), seed(0x2545F491), compare(compare)
+   {
+      for (int i = 0; i < MAX_LEVEL; i++)
+         head[i].store(nullptr, std::memory_order_relaxed);
+   }
+
+   /*********************************************
+    * SKIP LIST :: COPY CONSTRUCTOR
+    ********************************************/
+   template <class T, class K, class KeyOf, class C>
+   skiplist <T, K, KeyOf, C> ::skiplist(const skiplist& rhs) : skiplist(rhs.compare)
+   {
+      *this = rhs;
+   }
+
+   /*********************************************
+    * SKIP LIST :: MOVE CONSTRUCTOR
+    ********************************************/
+   template <class T, class K, class KeyOf, class C>
+   skiplist <T, K, KeyOf, C> ::skiplist(skiplist&& rhs) : skiplist(rhs.compare)
+   {
+      swap(rhs);
+   }
+
+   /*********************************************
+    * SKIP LIST :: ASSIGNMENT OPERATOR
+    * The source is already sorted, so each node is
+    * linked after the last one on every level it reaches
+    * without searching: O(n).
+    ********************************************/
+   template <class T, class K, class KeyOf, class C>
+   skiplist <T, K, KeyOf, C>& skiplist <T, K, KeyOf, C> :: operator = (const skiplist& rhs)
+   {
+      if (this == &rhs)
+         return *this;
+      clear();
+      compare = rhs.compare;
+
+      Link* last[MAX_LEVEL];
+      for (int i = 0; i < MAX_LEVEL; i++)
+         last[i] = head;
+
+      for (Node* p = rhs.head[0].load(std::memory_order_acquire); p; p = p->links()[0].load(std::memory_order_acquire))
+      {
+         Node* pNew = Node::create(p->height, p->data);
+         for (int i = 0; i < pNew->height; i++)
+         {
+            last[i][i].store(pNew, std::memory_order_release);
+            last[i] = pNew->links();
+         }
+      }
+      numLevels.store(rhs.numLevels.load(std::memory_order_relaxed), std::memory_order_relaxed);
+      numElements.store(rhs.size(), std::memory_order_relaxed);
+      return *this;
+   }
+
+   /*********************************************
+    * SKIP LIST :: ASSIGN-MOVE OPERATOR
+    ********************************************/
+   template <class T, class K, class KeyOf, class C>
+   skiplist <T, K, KeyOf, C>& skiplist <T, K, KeyOf, C> :: operator = (skiplist&& rhs)
+   {
+      clear();
+      swap(rhs);
+      return *this;
+   }
+
+   /*********************************************
+    * SKIP LIST :: SWAP
+    * Not safe with concurrent readers
+    ********************************************/
+   template <class T, class K, class KeyOf, class C>
+   void skiplist <T, K, KeyOf, C> ::swap(skiplist& rhs)
+   {
+      for (int i = 0; i < MAX_LEVEL; i++)
+      {
+         Node* p = head[i].load(std::memory_order_relaxed);
+         head[i].store(rhs.head[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+         rhs.head[i].store(p, std::memory_order_relaxed);
+      }
+      int levels = numLevels.load(std::memory_order_relaxed);
+      numLevels.store(rhs.numLevels.load(std::memory_order_relaxed), std::memory_order_relaxed);
+      rhs.numLevels.store(levels, std::memory_order_relaxed);
+      size_t num = numElements.load(std::memory_order_relaxed);
+      numElements.store(rhs.numElements.load(std::memory_order_relaxed), std::memory_order_relaxed);
+      rhs.numElements.store(num, std::memory_order_relaxed);
+      std::swap(seed, rhs.seed);
+      std::swap(compare, rhs.compare);
+   }
+
+   /*********************************************
+    * SKIP LIST :: LOWER BOUND
+    * The first node whose key is not less than k.
+    * Drop a level each time the next node overshoots.
+    ********************************************/
+   template <class T, class K, class KeyOf, class C>
+   typename skiplist <T, K, KeyOf, C> ::Node* skiplist <T, K, KeyOf, C> ::lowerBound(const K& k) const
+   {
+      const Link* links = head;
+      Node* pNext = nullptr;
+      for (int level = numLevels.load(std::memory_order_acquire) - 1; level >= 0; level--)
+      {
+         pNext = links[level].load(std::memory_order_acquire);
+         while (pNext && compare(KeyOf()(pNext->data), k))
+         {
+            links = pNext->links();
+            pNext = links[level].load(std::memory_order_acquire);
+         }
+      }
+      return pNext;
+   }
+
+   /*********************************************
+    * SKIP LIST :: UPPER BOUND
+    * The first node whose key is greater than k
+    ********************************************/
+   template <class T, class K, class KeyOf, class C>
+   typename skiplist <T, K, KeyOf, C> ::Node* skiplist <T, K, KeyOf, C> ::upperBound(const K& k) const
+   {
+      const Link* links = head;
+      Node* pNext = nullptr;
+      for (int level = numLevels.load(std::memory_order_acquire) - 1; level >= 0; level--)
+      {
+         pNext = links[level].load(std::memory_order_acquire);
+         while (pNext && !compare(k, KeyOf()(pNext->data)))
+         {
+            links = pNext->links();
+            pNext = links[level].load(std::memory_order_acquire);
+         }
+      }
+      return pNext;
+   }
+
+   /*********************************************
+    * SKIP LIST :: FIND PREVIOUS
+    * For every level, the links of the last node whose
+    * key is less than k (the head if there is none)
+    ********************************************/
+   template <class T, class K, class KeyOf, class C>
+   void skiplist <T, K, KeyOf, C> ::findPrevious(const K& k, Link** update) const
+   {
+      Link* links = const_cast<Link*>(head);
+      for (int level = MAX_LEVEL - 1; level >= 0; level--)
+      {
+         Node* pNext = links[level].load(std::memory_order_relaxed);
+         while (pNext && compare(KeyOf()(pNext->data), k))
+         {
+            links = pNext->links();
+            pNext = links[level].load(std::memory_order_relaxed);
+         }
+         update[level] = links;
+      }
+   }
+
+   /*********************************************
+    * SKIP LIST :: FIND
+    * Return the node with the key k
+    ********************************************/
+   template <class T, class K, class KeyOf, class C>
+   typename skiplist <T, K, KeyOf, C> ::iterator skiplist <T, K, KeyOf, C> ::find(const K& k) const
+   {
+      Node* p = lowerBound(k);
+      if (p && !compare(k, KeyOf()(p->data)))
+         return iterator(p);
+      return end();
+   }
+
+   /*********************************************
+    * SKIP LIST :: RANDOM LEVEL
+    * Each level up is a quarter as likely as the last
+    ********************************************/
+   template <class T, class K, class KeyOf, class C>
+   int skiplist <T, K, KeyOf, C> ::randomLevel()
+   {
+      // xorshift32
+      seed ^= seed << 13;
+      seed ^= seed >> 17;
+      seed ^= seed << 5;
+
+      int height = 1;
+      for (unsigned int bits = seed; height < MAX_LEVEL && (bits & 3) == 0; bits >>= 2)
+         height++;
+      return height;
+   }
+
+   /*****************************************************
+    * SKIP LIST :: EMPLACE UNIQUE
+    * Insert a value with the key k unless there is one
+    * already. The value is only built from args when it
+    * is actually inserted. The node is fully linked before
+    * it is published on each level, bottom first, so a
+    * concurrent reader sees either the old list or a
+    * consistent new one.
+    ****************************************************/
+   template <class T, class K, class KeyOf, class C>
+   template <class ... Args>
+   std::pair<typename skiplist <T, K, KeyOf, C> ::iterator, bool>
+      skiplist <T, K, KeyOf, C> ::emplaceUnique(const K& k, Args&& ... args)
+   {
+      Link* update[MAX_LEVEL];
+      findPrevious(k, update);
+
+      Node* pNext = update[0][0].load(std::memory_order_relaxed);
+      if (pNext && !compare(k, KeyOf()(pNext->data)))
+         return std::pair<iterator, bool>(iterator(pNext), false);
+
+      Node* pNew = Node::create(randomLevel(), std::forward<Args>(args)...);
+      for (int i = 0; i < pNew->height; i++)
+      {
+         pNew->links()[i].store(update[i][i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+         update[i][i].store(pNew, std::memory_order_release);
+      }
+
+      if (pNew->height > numLevels.load(std::memory_order_relaxed))
+         numLevels.store(pNew->height, std::memory_order_release);
+      numElements.fetch_add(1, std::memory_order_relaxed);
+      return std::pair<iterator, bool>(iterator(pNew), true);
+   }
+
+   /*************************************************
+    * SKIP LIST :: UNLINK
+    * Take the node with the key k out of every level,
+    * top first, without freeing it
+    ************************************************/
+   template <class T, class K, class KeyOf, class C>
+   typename skiplist <T, K, KeyOf, C> ::Node* skiplist <T, K, KeyOf, C> ::unlink(const K& k)
+   {
+      Link* update[MAX_LEVEL];
+      findPrevious(k, update);
+
+      Node* pErase = update[0][0].load(std::memory_order_relaxed);
+      if (pErase == nullptr || compare(k, KeyOf()(pErase->data)))
+         return nullptr;
+
+      for (int i = pErase->height - 1; i >= 0; i--)
+         update[i][i].store(pErase->links()[i].load(std::memory_order_relaxed), std::memory_order_release);
+
+      numElements.fetch_sub(1, std::memory_order_relaxed);
+      return pErase;
+   }
+
+   /*************************************************
+    * SKIP LIST :: ERASE
+    * Remove the element with a given key
+    ************************************************/
+   template <class T, class K, class KeyOf, class C>
+   size_t skiplist <T, K, KeyOf, C> ::erase(const K& k)
+   {
+      Node* pErase = unlink(k);
+      if (pErase == nullptr)
+         return 0;
+      Node::destroy(pErase);
+      return 1;
+   }
+
+   template <class T, class K, class KeyOf, class C>
+   typename skiplist <T, K, KeyOf, C> ::iterator skiplist <T, K, KeyOf, C> ::erase(iterator it)
+   {
+      if (it == end())
+         return it;
+      iterator itNext = it;
+      ++itNext;
+      erase(KeyOf()(*it));
+      return itNext;
+   }
+
+   /*****************************************************
+    * SKIP LIST :: CLEAR
+    * Walk the bottom level freeing every node
+    ****************************************************/
+   template <class T, class K, class KeyOf, class C>
+   void skiplist <T, K, KeyOf, C> ::clear() noexcept
+   {
+      Node* p = head[0].load(std::memory_order_relaxed);
+      while (p)
+      {
+         Node* pDelete = p;
+         p = p->links()[0].load(std::memory_order_relaxed);
+         Node::destroy(pDelete);
+      }
+
+      for (int i = 0; i < MAX_LEVEL; i++)
+         head[i].store(nullptr, std::memory_order_relaxed);
+      numLevels.store(1, std::memory_order_relaxed);
+      numElements.store(0, std::memory_order_relaxed);
+   }
+
+
+   /*****************************************************************
+    * KEY EXTRACTORS
+    * How the set and map pull the key out of what they store
+    *****************************************************************/
+   template <class T>
+   struct skiplistIdentity
+   {
+      const T& operator () (const T& t) const { return t; }
+   };
+   template <class K, class V>
+   struct skiplistFirst
+   {
+      const K& operator () (const custom::pair<K, V>& p) const { return p.first; }
+   };
+
+   /*****************************************************************
+    * SKIP LIST SET
+    * An ordered set of unique values
+    *****************************************************************/
+   template <class T, class C = std::less<T>>
+   class skiplist_set : public skiplist<T, T, skiplistIdentity<T>, C>
+   {
+   public:
+      skiplist_set(const C& compare = C()) : skiplist<T, T, skiplistIdentity<T>, C>(compare) {}
+      skiplist_set(const std::initializer_list<T>& il)
+      {
+         for (auto it = il.begin(); it != il.end(); it++)
+            this->insert(*it);
+      }
+      template <class Iterator>
+      skiplist_set(Iterator first, Iterator last)
+      {
+         for (auto it = first; it != last; it++)
+            this->insert(*it);
+      }
+   };
+
+   /*****************************************************************
+    * SKIP LIST MAP
+    * An ordered map of unique keys. Lookups go by key alone
+    * so no pair is built unless one is inserted.
+    *****************************************************************/
+   template <class K, class V, class C = std::less<K>>
+   class skiplist_map : public skiplist<custom::pair<K, V>, K, skiplistFirst<K, V>, C>
+   {
+      typedef skiplist<custom::pair<K, V>, K, skiplistFirst<K, V>, C> Base;
+   public:
+      using Pairs = custom::pair<K, V>;
+
+      skiplist_map(const C& compare = C()) : Base(compare) {}
+      skiplist_map(const std::initializer_list<Pairs>& il)
+      {
+         for (auto it = il.begin(); it != il.end(); it++)
+            this->insert(*it);
+      }
+      template <class Iterator>
+      skiplist_map(Iterator first, Iterator last)
+      {
+         for (auto it = first; it != last; it++)
+            this->insert(*it);
+      }
+
+      //
+      // Access
+      //
+      V& operator [] (const K& k)
+      {
+         return this->emplaceUnique(k, k).first.pNode->data.second;
+      }
+      V& at(const K& k)
+      {
+         auto it = this->find(k);
+         if (it == this->end())
+            throw std::out_of_range("invalid skiplist_map<K, V> key");
+         return it.pNode->data.second;
+      }
+      const V& at(const K& k) const
+      {
+         auto it = this->find(k);
+         if (it == this->end())
+            throw std::out_of_range("invalid skiplist_map<K, V> key");
+         return it.pNode->data.second;
+      }
+   };
+
+   /*****************************************************************
+    * CONCURRENT SKIP LIST SET
+    * A skip list set whose lookups (find, contains, lower_bound,
+    * upper_bound and iteration) take no lock and may run on any
+    * number of threads while one writer at a time inserts or erases.
+    * Erased nodes are not freed until reclaim() is called at a point
+    * where no reader can still be holding one, or until the set is
+    * destroyed.
+    *
+    * The skip list is inherited privately so that only the lookups
+    * are reachable without the lock; the mutators it has that free
+    * nodes in place (clear, swap, erase by iterator, assignment) are
+    * not offered.
+    *****************************************************************/
+   template <class T, class C = std::less<T>>
+   class concurrent_skiplist_set : private skiplist<T, T, skiplistIdentity<T>, C>
+   {
+      friend class ::TestSkipList; // give unit tests access to the privates
+      typedef skiplist<T, T, skiplistIdentity<T>, C> Base;
+   public:
+      //
+      // Access: lock-free, from any thread
+      //
+      using typename Base::iterator;
+      using Base::begin;
+      using Base::end;
+      using Base::find;
+      using Base::lower_bound;
+      using Base::upper_bound;
+      using Base::contains;
+      using Base::empty;
+      using Base::size;
+
+      concurrent_skiplist_set(const C& compare = C()) : Base(compare) {}
+      concurrent_skiplist_set(const concurrent_skiplist_set& rhs) = delete;
+      concurrent_skiplist_set& operator = (const concurrent_skiplist_set& rhs) = delete;
+      ~concurrent_skiplist_set() { reclaim(); }
+
+      //
+      // Insert and Remove: serialized among writers
+      //
+      std::pair<typename Base::iterator, bool> insert(const T& t)
+      {
+         std::lock_guard<std::mutex> guard(mutexWrite);
+         return Base::insert(t);
+      }
+      std::pair<typename Base::iterator, bool> insert(T&& t)
+      {
+         std::lock_guard<std::mutex> guard(mutexWrite);
+         return Base::insert(std::move(t));
+      }
+      size_t erase(const T& t)
+      {
+         std::lock_guard<std::mutex> guard(mutexWrite);
+         typename Base::Node* pErase = Base::unlink(t);
+         if (pErase == nullptr)
+            return 0;
+         retired.push_back(pErase);
+         return 1;
+      }
+
+      //
+      // Reclaim: free erased nodes once no reader can see them
+      //
+      void reclaim()
+      {
+         std::lock_guard<std::mutex> guard(mutexWrite);
+         for (auto pNode : retired)
+            Base::Node::destroy(pNode);
+         retired.clear();
+      }
+
+   private:
+      std::mutex mutexWrite;                          // one writer at a time
+      std::vector<typename Base::Node*> retired;      // erased but maybe still read
+   };
+
+} // namespace custom
@@ -0,0 +1,237 @@
+/***********************************************************************
+ * Header:
+ *    SLAB ALLOCATOR
+ * Summary:
+ *    An allocator for node-based containers like BST and map. Rather
+ *    than going to the heap for every node, it carves nodes out of
+ *    large slabs, so nodes made one after another sit next to each
+ *    other in memory. Freed nodes go on a free list to be reused,
+ *    and when the container is done with all of them every slab is
+ *    handed back at once.
+ *
+ *    This will contain the class definition of:
+ *        slab_pool           : The slabs shared by an allocator and its rebinds
+ *        slab_allocator      : A pooling allocator for one node at a time
+ * Author
+ *    Gabe Lytle, M. Scott O'Connor
+ ************************************************************************/
+
+#pragma once
+
+#include <cstddef>      // for size_t
+#include <memory>       // for std::shared_ptr
+#include <new>          // for ::operator new
+#include <type_traits>  // for std::true_type
+#include <vector>       // for the list of slabs
+
+class TestSlabAllocator; // forward declaration for unit tests
+
+namespace custom
+{
+
+   /*****************************************************************
+    * SLAB POOL
+    * The slabs behind a slab_allocator and every allocator rebound
+    * from it. Each slot size gets its own slabs and free list, so a
+    * map's node allocator and the pair allocator it was built from
+    * draw on one pool without mixing their slots.
+    *****************************************************************/
+   class slab_pool
+   {
+      friend class ::TestSlabAllocator; // give unit tests access to the privates
+   public:
+      /**************************************************
+       * SLABS
+       * The slabs for one slot size. Each slot holds one
+       * object or, while it is free, the link to the next
+       * free slot.
+       **************************************************/
+      struct Slabs
+      {
+         struct Slot { Slot* pNext; };
+
+         static const size_t MIN_SLAB = 32;     // slots in the first slab
+         static const size_t MAX_SLAB = 4096;   // slabs stop doubling here
+
+         Slabs(size_t sizeSlot) : pFree(nullptr), pUnused(nullptr), pEnd(nullptr),
+                                  numCapacity(0), sizeSlot(sizeSlot), pNext(nullptr) {}
+         ~Slabs() { release(); }
+
+         // a free slot if there is one, otherwise the next unused one
+         void* take()
+         {
+            if (pFree)
+            {
+               Slot* pSlot = pFree;
+               pFree = pSlot->pNext;
+               return pSlot;
+            }
+            if (pUnused == pEnd)
+               grow();
+            void* p = pUnused;
+            pUnused += sizeSlot;
+            return p;
+         }
+
+         // put a slot on the free list
+         void give(void* p)
+         {
+            Slot* pSlot = static_cast<Slot*>(p);
+            pSlot->pNext = pFree;
+            pFree = pSlot;
+         }
+
+         // add a slab twice as big as the last one
+         void grow()
+         {
+            size_t numSlots = slabs.empty() ? MIN_SLAB : numCapacity;
+            if (numSlots > MAX_SLAB)
+               numSlots = MAX_SLAB;
+            char* pSlab = static_cast<char*>(::operator new(numSlots * sizeSlot));
+            slabs.push_back(pSlab);
+            pUnused = pSlab;
+            pEnd = pSlab + numSlots * sizeSlot;
+            numCapacity += numSlots;
+         }
+
+         // free every slab
+         void release()
+         {
+            for (char* pSlab : slabs)
+               ::operator delete(pSlab);
+            slabs.clear();
+            pFree = nullptr;
+            pUnused = pEnd = nullptr;
+            numCapacity = 0;
+         }
+
+         std::vector<char*> slabs;  // every slab we have allocated
+         Slot* pFree;               // slots given back, most recent first
+         char* pUnused;             // next never-used slot in the last slab
+         char* pEnd;                // end of the last slab
+         size_t numCapacity;        // slots in all the slabs
+         size_t sizeSlot;           // bytes in each slot
+         Slabs* pNext;              // the slabs for the next slot size
+      };
+
+      slab_pool() : pHead(nullptr) {}
+      slab_pool(const slab_pool& rhs) = delete;
+      slab_pool& operator = (const slab_pool& rhs) = delete;
+      ~slab_pool()
+      {
+         while (pHead)
+         {
+            Slabs* pDelete = pHead;
+            pHead = pHead->pNext;
+            delete pDelete;
+         }
+      }
+
+      // the slabs for slots of sizeSlot bytes, made on first use
+      Slabs* slabsFor(size_t sizeSlot)
+      {
+         for (Slabs* p = pHead; p; p = p->pNext)
+            if (p->sizeSlot == sizeSlot)
+               return p;
+         Slabs* pNew = new Slabs(sizeSlot);
+         pNew->pNext = pHead;
+         pHead = pNew;
+         return pNew;
+      }
+
+      // free every slab of every size
+      void release()
+      {
+         for (Slabs* p = pHead; p; p = p->pNext)
+            p->release();
+      }
+
+   private:
+      Slabs* pHead;   // one per slot size in use; there are rarely more than two
+   };
+
+   /*****************************************************************
+    * SLAB ALLOCATOR
+    * Copies of an allocator, and allocators rebound from it, share
+    * one pool, so they compare equal and a node made by one can be
+    * freed by another. Containers copied with
+    * select_on_container_copy_construction() get a pool of their own
+    * so that one can release its slabs without disturbing another.
+    *****************************************************************/
+   template <class T>
+   class slab_allocator
+   {
+      friend class ::TestSlabAllocator; // give unit tests access to the privates
+      template <class U>
+      friend class slab_allocator;
+   public:
+      typedef T value_type;
+      typedef std::true_type propagate_on_container_move_assignment;
+      typedef std::true_type propagate_on_container_swap;
+
+      //
+      // Construct
+      //
+
+      slab_allocator() : pPool(std::make_shared<slab_pool>()), pSlabs(pPool->slabsFor(SIZE_SLOT)) {}
+      slab_allocator(const slab_allocator& rhs) = default;
+      template <class U>
+      slab_allocator(const slab_allocator<U>& rhs) : pPool(rhs.pPool), pSlabs(pPool->slabsFor(SIZE_SLOT)) {}
+      slab_allocator& operator = (const slab_allocator& rhs) = default;
+      slab_allocator select_on_container_copy_construction() const { return slab_allocator(); }
+
+      //
+      // Allocate: single objects come from the pool, arrays from the heap
+      //
+
+      T* allocate(size_t num)
+      {
+         if (num == 1)
+            return static_cast<T*>(pSlabs->take());
+         return static_cast<T*>(::operator new(num * sizeof(T)));
+      }
+      void deallocate(T* p, size_t num)
+      {
+         if (num == 1)
+            pSlabs->give(p);
+         else
+            ::operator delete(p);
+      }
+
+      //
+      // Release: free every slab at once. Only done when no other
+      // allocator shares the pool; the caller must already have
+      // destroyed every object. Returns whether the slabs were freed.
+      //
+
+      bool release()
+      {
+         if (pPool.use_count() != 1)
+            return false;
+         pPool->release();
+         return true;
+      }
+
+      //
+      // Status
+      //
+
+      size_t capacity() const { return pSlabs->numCapacity; }
+
+      template <class U>
+      bool operator == (const slab_allocator<U>& rhs) const { return pPool == rhs.pPool; }
+      template <class U>
+      bool operator != (const slab_allocator<U>& rhs) const { return pPool != rhs.pPool; }
+
+   private:
+      // a slot fits a T or a free-list link, rounded up to keep either aligned
+      static const size_t ALIGN = alignof(T) > alignof(slab_pool::Slabs::Slot) ?
+                                  alignof(T) : alignof(slab_pool::Slabs::Slot);
+      static const size_t SIZE_SLOT =
+         ((sizeof(T) > sizeof(slab_pool::Slabs::Slot) ? sizeof(T) : sizeof(slab_pool::Slabs::Slot)) + ALIGN - 1) / ALIGN * ALIGN;
+
+      std::shared_ptr<slab_pool> pPool;   // shared with copies and rebinds
+      slab_pool::Slabs* pSlabs;           // the part of the pool for a T
+   };
+
+} // namespace custom
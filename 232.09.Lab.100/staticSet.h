@@ -0,0 +1,414 @@
+/***********************************************************************
+ * Header:
+ *    STATIC SET
+ * Summary:
+ *    Read-only ordered containers for lookup tables that are built
+ *    once and searched many times. The values sit in one array in
+ *    the order a breadth-first walk of a balanced tree would visit
+ *    them (the Eytzinger layout): the root first, then both of its
+ *    children, then all four grandchildren, and so on. The children
+ *    of the value at position k are at 2k and 2k + 1, so there are
+ *    no pointers to chase, and the first few levels that every
+ *    search passes through share a handful of cache lines.
+ *
+ *    A search goes down one level per comparison and the comparison
+ *    only picks the next index, so there is no branch to mispredict.
+ *    Since the next four levels below a value are contiguous, the
+ *    search asks for them from memory four levels ahead of time.
+ *
+ *    freeze() turns a BST, a map, or a sorted vector into one of
+ *    these.
+ *
+ *    This will contain the class definition of:
+ *        static_tree           : The array shared by the containers
+ *        static_tree::iterator : An in-order iterator through the array
+ *        static_set            : A read-only ordered set
+ *        static_map            : A read-only ordered map
+ * Author
+ *    Gabe Lytle, M. Scott O'Connor
+ ************************************************************************/
+
+#pragma once
+
+#include <algorithm>         // for std::sort and std::min
+#include <initializer_list>
+#include <stdexcept>         // for std::out_of_range
+#include <vector>
+#include "pair.h"            // for custom::pair
+#include "bst.h"             // for BST, keyOf, and sorted_range
+#include "map.h"             // for map
+
+class TestStaticSet;    // forward declaration for unit tests
+
+namespace custom
+{
+
+   /*****************************************************************
+    * STATIC TREE
+    * The array behind the static containers. Position k of the
+    * implicit tree, counting the root as 1, is stored at
+    * values[k - 1]; an index of 0 means none. Values compare on
+    * keyOf<T>, as they do in a BST.
+    *****************************************************************/
+   template <class T>
+   class static_tree
+   {
+      friend class ::TestStaticSet; // give unit tests access to the privates
+   public:
+      typedef T value_type;
+
+      //
+      // Construct
+      //
+
+      static_tree() {}
+      template <class Iterator>
+      static_tree(sorted_range_t, Iterator first, Iterator last)
+      {
+         build(first, last);
+      }
+
+      //
+      // Iterator
+      //
+
+      class iterator;
+      iterator begin() const { return iterator(this, leftmost(1, size())); }
+      iterator end()   const { return iterator(this, 0); }
+
+      //
+      // Access: lookups take the key or anything that compares with it
+      //
+
+      template <class K>
+      iterator find(const K& k) const
+      {
+         size_t i = lowerBound(k);
+         return (i != 0 && !keyLess(k, values[i - 1])) ? iterator(this, i) : end();
+      }
+      template <class K>
+      iterator lower_bound(const K& k) const { return iterator(this, lowerBound(k)); }
+      template <class K>
+      iterator upper_bound(const K& k) const { return iterator(this, upperBound(k)); }
+      template <class K>
+      size_t count(const K& k) const { return find(k) == end() ? 0 : 1; }
+
+      //
+      // Status
+      //
+
+      bool   empty() const noexcept { return values.empty(); }
+      size_t size()  const noexcept { return values.size(); }
+
+   protected:
+      // how many positions four levels down are in one 64 byte line
+      static const size_t BLOCK = sizeof(T) <= 4 ? 16 : sizeof(T) <= 8 ? 8 :
+                                  sizeof(T) <= 16 ? 4 : sizeof(T) <= 32 ? 2 : 1;
+
+      template <class K>
+      static bool valueLess(const T& t, const K& k) { return keyOf<T>::before(t, k); }
+      template <class K>
+      static bool keyLess(const K& k, const T& t) { return keyOf<T>::after(t, k); }
+
+      template <class Iterator>
+      void build(Iterator first, Iterator last);
+      template <class K>
+      size_t lowerBound(const K& k) const;
+      template <class K>
+      size_t upperBound(const K& k) const;
+      void prefetch(size_t i) const;
+      static size_t climbRight(size_t i);
+
+      // walking an implicit tree of num positions in order
+      static size_t leftmost(size_t i, size_t num)
+      {
+         if (i > num)
+            return 0;
+         while (2 * i <= num)
+            i = 2 * i;
+         return i;
+      }
+      static size_t rightmost(size_t i, size_t num)
+      {
+         if (i > num)
+            return 0;
+         while (2 * i + 1 <= num)
+            i = 2 * i + 1;
+         return i;
+      }
+      static size_t next(size_t i, size_t num);
+      static size_t prev(size_t i, size_t num);
+
+      std::vector <T> values;   // in breadth-first order
+   };
+
+   /**********************************************************
+    * STATIC TREE ITERATOR
+    * A position in the implicit tree, moving in order
+    *********************************************************/
+   template <class T>
+   class static_tree <T> ::iterator
+   {
+      friend class ::TestStaticSet; // give unit tests access to the privates
+      friend class static_tree <T>;
+   public:
+      iterator() : pTree(nullptr), i(0) {}
+
+      bool operator == (const iterator& rhs) const { return i == rhs.i; }
+      bool operator != (const iterator& rhs) const { return i != rhs.i; }
+
+      const T& operator * () const { return pTree->values[i - 1]; }
+      const T* operator -> () const { return &pTree->values[i - 1]; }
+
+      iterator& operator ++ ()
+      {
+         i = next(i, pTree->size());
+         return *this;
+      }
+      iterator operator ++ (int)
+      {
+         iterator itReturn = *this;
+         ++*this;
+         return itReturn;
+      }
+      iterator& operator -- ()
+      {
+         i = prev(i, pTree->size());
+         return *this;
+      }
+      iterator operator -- (int)
+      {
+         iterator itReturn = *this;
+         --*this;
+         return itReturn;
+      }
+
+   private:
+      iterator(const static_tree* pTree, size_t i) : pTree(pTree), i(i) {}
+
+      const static_tree* pTree;
+      size_t i;
+   };
+
+   /*********************************************
+    * STATIC TREE :: BUILD
+    * Lay out a sorted range. Equal neighbors are
+    * dropped, keeping the first. A walk of the
+    * empty shape in order gives each position its
+    * rank, and the values are then copied in
+    * position order so the array is filled front
+    * to back. The values are held by address
+    * until then, so the range must be stored in
+    * a container rather than read from a stream.
+    ********************************************/
+   template <class T>
+   template <class Iterator>
+   void static_tree <T> ::build(Iterator first, Iterator last)
+   {
+      std::vector <const T*> sorted;
+      for (Iterator it = first; it != last; ++it)
+         if (sorted.empty() || valueLess(*sorted.back(), keyOf<T>()(*it)))
+            sorted.push_back(&*it);
+
+      size_t num = sorted.size();
+      std::vector <size_t> rank(num + 1);
+      size_t r = 0;
+      for (size_t i = leftmost(1, num); i != 0; i = next(i, num))
+         rank[i] = r++;
+
+      values.clear();
+      values.reserve(num);
+      for (size_t i = 1; i <= num; i++)
+         values.push_back(*sorted[rank[i]]);
+   }
+
+   /*********************************************
+    * STATIC TREE :: PREFETCH
+    * Ask for the four levels below position i:
+    * the BLOCK positions starting at BLOCK * i.
+    * The array is not aligned to a cache line, so
+    * they may straddle two and both ends are
+    * fetched. Positions past the end are clamped
+    * to the last so that no branch is needed.
+    ********************************************/
+   template <class T>
+   void static_tree <T> ::prefetch(size_t i) const
+   {
+#if defined(__GNUC__)
+      size_t num = values.size();
+      __builtin_prefetch(&values[std::min(BLOCK * i, num) - 1]);
+      __builtin_prefetch(&values[std::min(BLOCK * i + BLOCK - 1, num) - 1]);
+#endif
+   }
+
+   /*********************************************
+    * STATIC TREE :: CLIMB RIGHT
+    * A search that fell off the bottom at i went
+    * left at the answer and then only right, so
+    * the answer is i with those trailing right
+    * turns (1 bits) and the left turn removed. A
+    * search that never went left leaves 0: end().
+    ********************************************/
+   template <class T>
+   size_t static_tree <T> ::climbRight(size_t i)
+   {
+#if defined(__GNUC__)
+      return i >> (__builtin_ctzll(~(unsigned long long)i) + 1);
+#else
+      while (i & 1)
+         i >>= 1;
+      return i >> 1;
+#endif
+   }
+
+   /*********************************************
+    * STATIC TREE :: LOWER BOUND, UPPER BOUND
+    * Position of the first value not less than
+    * (greater than) k. Each step goes to the left
+    * child 2i or the right child 2i + 1 depending
+    * only on the comparison.
+    ********************************************/
+   template <class T>
+   template <class K>
+   size_t static_tree <T> ::lowerBound(const K& k) const
+   {
+      size_t i = 1;
+      while (i <= values.size())
+      {
+         prefetch(i);
+         i = 2 * i + valueLess(values[i - 1], k);
+      }
+      return climbRight(i);
+   }
+
+   template <class T>
+   template <class K>
+   size_t static_tree <T> ::upperBound(const K& k) const
+   {
+      size_t i = 1;
+      while (i <= values.size())
+      {
+         prefetch(i);
+         i = 2 * i + !keyLess(k, values[i - 1]);
+      }
+      return climbRight(i);
+   }
+
+   /*********************************************
+    * STATIC TREE :: NEXT
+    * The leftmost of the right subtree, or else
+    * the first ancestor reached from its left
+    ********************************************/
+   template <class T>
+   size_t static_tree <T> ::next(size_t i, size_t num)
+   {
+      if (2 * i + 1 <= num)
+         return leftmost(2 * i + 1, num);
+      while (i & 1)
+         i >>= 1;
+      return i >> 1;
+   }
+
+   /*********************************************
+    * STATIC TREE :: PREV
+    * The rightmost of the left subtree, or else
+    * the first ancestor reached from its right.
+    * Before end() is the largest.
+    ********************************************/
+   template <class T>
+   size_t static_tree <T> ::prev(size_t i, size_t num)
+   {
+      if (i == 0)
+         return rightmost(1, num);
+      if (2 * i <= num)
+         return rightmost(2 * i, num);
+      while (i != 0 && !(i & 1))
+         i >>= 1;
+      return i >> 1;
+   }
+
+   /*****************************************************************
+    * STATIC SET
+    * A read-only ordered set of unique values
+    *****************************************************************/
+   template <class T>
+   class static_set : public static_tree <T>
+   {
+   public:
+      static_set() {}
+      template <class Iterator>
+      static_set(sorted_range_t, Iterator first, Iterator last) :
+         static_tree <T>(sorted_range, first, last) {}
+      template <class Iterator>
+      static_set(Iterator first, Iterator last)
+      {
+         std::vector <T> sorted(first, last);
+         std::sort(sorted.begin(), sorted.end());
+         this->build(sorted.begin(), sorted.end());
+      }
+      static_set(const std::initializer_list <T>& il) : static_set(il.begin(), il.end()) {}
+   };
+
+   /*****************************************************************
+    * STATIC MAP
+    * A read-only ordered map of unique keys
+    *****************************************************************/
+   template <class K, class V>
+   class static_map : public static_tree <custom::pair <K, V>>
+   {
+   public:
+      using Pairs = custom::pair <K, V>;
+
+      static_map() {}
+      template <class Iterator>
+      static_map(sorted_range_t, Iterator first, Iterator last) :
+         static_tree <Pairs>(sorted_range, first, last) {}
+      template <class Iterator>
+      static_map(Iterator first, Iterator last)
+      {
+         std::vector <Pairs> sorted(first, last);
+         std::stable_sort(sorted.begin(), sorted.end(),
+            [](const Pairs& lhs, const Pairs& rhs) { return lhs.first < rhs.first; });
+         this->build(sorted.begin(), sorted.end());
+      }
+      static_map(const std::initializer_list <Pairs>& il) : static_map(il.begin(), il.end()) {}
+
+      //
+      // Access
+      //
+
+      template <class KK>
+      const V& at(const KK& k) const
+      {
+         auto it = this->find(k);
+         if (it == this->end())
+            throw std::out_of_range("invalid static_map<K, V> key");
+         return it->second;
+      }
+   };
+
+   /*****************************************************************
+    * FREEZE
+    * A read-only copy of a BST, a map, or a sorted vector, laid out
+    * for searching. The BST and map are already in order, so this
+    * is O(n).
+    *****************************************************************/
+   template <class T, class A, bool Ranked>
+   static_set <T> freeze(const BST <T, A, Ranked>& bst)
+   {
+      return static_set <T>(sorted_range, bst.begin(), bst.end());
+   }
+
+   template <class K, class V, class A>
+   static_map <K, V> freeze(const map <K, V, A>& m)
+   {
+      return static_map <K, V>(sorted_range, m.begin(), m.end());
+   }
+
+   template <class T>
+   static_set <T> freeze(sorted_range_t, const std::vector <T>& v)
+   {
+      return static_set <T>(sorted_range, v.begin(), v.end());
+   }
+
+} // namespace custom
@@ -12,13 +12,16 @@
 #ifdef DEBUG
 
 #include "bst.h"
+#include "pair.h"
 #include "unitTest.h"
 #include "spy.h"
 
 #include <cassert>
 #include <memory>
 #include <iostream>
+#include <stdexcept>
 #include <string>
+#include <vector>
 #include <functional> // for std::less and std::greater
 
  /***********************************************
@@ -43,6 +46,10 @@ public:
       test_constructMove_standard();
       test_constructInitializer_empty();
       test_constructInitializer_standard();
+      test_constructSorted_empty();
+      test_constructSorted_standard();
+      test_constructSorted_large();
+      test_constructSorted_copyThrows();
 
       // Assign
       test_assign_emptyToEmpty();
@@ -75,6 +82,11 @@ public:
       test_iterator_increment_standardToDone();
       test_iterator_increment_standardEnd();
       test_iterator_dereference_standardRead();
+      test_stackIterator_empty();
+      test_stackIterator_standard();
+      test_stackIterator_lowerBound();
+      test_stackIterator_large();
+      test_forEach_standard();
 
       // Find
       test_find_empty();
@@ -82,6 +94,47 @@ public:
       test_find_standardLast();
       test_find_standardMissing();
 
+      // Bounds and ranges
+      test_lowerBound_empty();
+      test_lowerBound_standardPresent();
+      test_lowerBound_standardMissing();
+      test_lowerBound_standardPastEnd();
+      test_upperBound_standardPresent();
+      test_equalRange_standardMissing();
+      test_countRange_standard();
+      test_visitRange_standard();
+      test_find_heterogeneous();
+      test_lowerBound_heterogeneous();
+      test_find_keyByComparator();
+
+      // Order statistics
+      test_ranked_nodeSize();
+      test_node_colorInPadding();
+      test_node_colorInParent();
+      test_node_colorParentApart();
+      test_nthElement_standard();
+      test_rank_standard();
+      test_ranked_insertErase();
+      test_ranked_constructSorted();
+      test_ranked_constructCopy();
+      test_countRange_ranked();
+      test_countRange_rankedCString();
+
+      // Split, join, and set algebra
+      test_split_standard();
+      test_split_ranked();
+      test_join_standard();
+      test_join_differentHeights();
+      test_join_outOfOrder();
+      test_extract_relinks();
+      test_insertNode_duplicateKeepsNode();
+      test_merge_standard();
+      test_unite_standard();
+      test_intersect_standard();
+      test_subtract_standard();
+      test_unite_spyDropsDuplicates();
+      test_unite_parallel();
+
       // Insert
       test_insert_oneLeft();
       test_insert_oneRight();
@@ -91,6 +144,14 @@ public:
       test_insertMove_oneRight();
       test_insertMove_duplicate();
       test_insertMove_keepUnique();
+      test_insert_rotate();
+      test_insert_sortedBalanced();
+      test_constructCopy_keepColors();
+      test_insert_ascendingAppends();
+      test_insert_hintEnd();
+      test_insert_hintFits();
+      test_insert_hintWrong();
+      test_erase_largestThenAppend();
 
       // Remove
       test_erase_empty();
@@ -98,6 +159,7 @@ public:
       test_erase_noChildren();
       test_erase_oneChild();
       test_erase_twoChildren();
+      test_erase_balanced();
       test_clear_empty();
       test_clear_standard();
 
@@ -405,12 +467,120 @@ public:
       assertUnit(Spy::numAssign() == 0);
       assertUnit(Spy::numAssignMove() == 0);
       assertUnit(Spy::numEquals() == 0);
-      assertUnit(Spy::numLessthan() == 10);
+      assertUnit(Spy::numLessthan() == 11);   // 80 first checks the largest
       assertStandardFixture(bstDest);
       // teardown
       teardownStandardFixture(bstDest);
    }
 
+   // an empty sorted range makes an empty tree
+   void test_constructSorted_empty()
+   {  // setup
+      std::vector<Spy> vSrc;
+      Spy::reset();
+      // exercise
+      custom::BST <Spy> bstDest(custom::sorted_range, vSrc.begin(), vSrc.end());
+      // verify
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertEmptyFixture(bstDest);
+   }  // teardown
+
+   // a sorted range is built into the standard fixture without comparing
+   void test_constructSorted_standard()
+   {  // setup
+      //                (50b)
+      //          +-------+-------+
+      //        (30b)           (70b)
+      //     +----+----+     +----+----+
+      //   (20r)     (40r) (60r)     (80r)
+      std::vector<Spy> vSrc{ Spy(20), Spy(30), Spy(40), Spy(50), Spy(60), Spy(70), Spy(80) };
+      Spy::reset();
+      // exercise
+      custom::BST <Spy> bstDest(custom::sorted_range, vSrc.begin(), vSrc.end());
+      // verify
+      assertUnit(Spy::numCopy() == 7);
+      assertUnit(Spy::numAlloc() == 7);
+      assertUnit(Spy::numLessthan() == 0);
+      assertUnit(Spy::numEquals() == 0);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(Spy::numDefault() == 0);
+      assertUnit(bstDest.isRedBlack());
+      assertStandardFixture(bstDest);
+      // teardown
+      teardownStandardFixture(bstDest);
+   }  // teardown
+
+   // a large sorted range is balanced and red-black
+   void test_constructSorted_large()
+   {  // setup
+      std::vector<int> vSrc;
+      for (int i = 0; i < 1000; i++)
+         vSrc.push_back(i);
+      // exercise
+      custom::BST <int> bstDest(custom::sorted_range, vSrc.begin(), vSrc.end());
+      // verify
+      assertUnit(bstDest.numElements == 1000);
+      assertUnit(bstDest.isRedBlack());
+      assertUnit(height(bstDest.root) == 10);   // ceil(log2(1001))
+      int expect = 0;
+      for (auto it = bstDest.begin(); it != bstDest.end(); ++it, ++expect)
+         if (*it != expect)
+            break;
+      assertUnit(expect == 1000);
+   }  // teardown
+
+   // a copy that throws partway through frees the nodes already built
+   // and leaves the tree empty
+   void test_constructSorted_copyThrows()
+   {  // setup
+      struct Fragile
+      {
+         Fragile(int value, int* pNumCopies, int* pNumLive) :
+            value(value), pNumCopies(pNumCopies), pNumLive(pNumLive) { (*pNumLive)++; }
+         Fragile(const Fragile& rhs) :
+            value(rhs.value), pNumCopies(rhs.pNumCopies), pNumLive(rhs.pNumLive)
+         {
+            if ((*pNumCopies)-- == 0)
+               throw value;
+            (*pNumLive)++;
+         }
+         ~Fragile() { (*pNumLive)--; }
+         bool operator == (const Fragile& rhs) const { return value == rhs.value; }
+         bool operator <  (const Fragile& rhs) const { return value <  rhs.value; }
+
+         int value;
+         int* pNumCopies;   // how many more copies may be made
+         int* pNumLive;     // how many are alive
+      };
+      int numCopies = 1;
+      int numLive = 0;
+      std::vector<Fragile> vSrc;
+      vSrc.reserve(7);
+      for (int i = 0; i < 7; i++)
+         vSrc.emplace_back(i * 10 + 20, &numCopies, &numLive);
+      custom::BST <Fragile> bst;
+      bst.insert(Fragile(99, &numCopies, &numLive));
+      numCopies = 4;                                   // [20]..[50] copy, [60] throws
+      int thrown = 0;
+      // exercise
+      try
+      {
+         bst.buildSorted(vSrc.begin(), vSrc.end());
+      }
+      catch (int value)
+      {
+         thrown = value;
+      }
+      // verify
+      assertUnit(thrown == 60);
+      assertUnit(numLive == 7);     // just the source
+      assertUnit(bst.root == nullptr);
+      assertUnit(bst.numElements == 0);
+      assertUnit(bst.pMax == nullptr);
+      assertUnit(bst.begin() == bst.end());
+   }  // teardown
+
    /***************************************
     * EMPTY and SIZE
     ***************************************/
@@ -1041,7 +1211,7 @@ public:
       assertUnit(Spy::numAssign() == 0);
       assertUnit(Spy::numAssignMove() == 0);
       assertUnit(Spy::numEquals() == 0);
-      assertUnit(Spy::numLessthan() == 10);
+      assertUnit(Spy::numLessthan() == 11);   // 80 first checks the largest
       //                (50) = bstDest
       //          +-------+-------+
       //        (30)            (70)
@@ -1779,6 +1949,799 @@ public:
 
 
 
+   /***************************************
+    * STACK ITERATOR
+    *    BST::scan_begin()
+    *    BST::stack_iterator::operator ++ ()
+    *    BST::for_each(Visit)
+    ***************************************/
+
+   // an empty tree's scan is over before it starts
+   void test_stackIterator_empty()
+   {  // setup
+      custom::BST <Spy> bst;
+      // exercise
+      auto it = bst.scan_begin();
+      // verify
+      assertUnit(it == bst.scan_end());
+      assertUnit(it.numStack == 0);
+      assertEmptyFixture(bst);
+   }  // teardown
+
+   // the scan visits in order and only the left spine starts on the stack
+   void test_stackIterator_standard()
+   {  // setup
+      //                 50 
+      //          +-------+-------+
+      //         30              70  
+      //     +----+----+     +----+----+
+      //    20        40    60        80  
+      custom::BST <Spy> bst;
+      setupStandardFixture(bst);
+      std::vector<int> visited;
+      Spy::reset();
+      // exercise
+      auto it = bst.scan_begin();
+      int numStackFirst = it.numStack;
+      for (; it != bst.scan_end(); ++it)
+         visited.push_back((*it).get());
+      // verify
+      assertUnit(numStackFirst == 3);         // [50][30][20]
+      assertUnit(visited == std::vector<int>({ 20, 30, 40, 50, 60, 70, 80 }));
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numLessthan() == 0);
+      assertStandardFixture(bst);
+      // teardown
+      teardownStandardFixture(bst);
+   }
+
+   // a scan can start at a lower bound
+   void test_stackIterator_lowerBound()
+   {  // setup
+      custom::BST <Spy> bst;
+      setupStandardFixture(bst);
+      std::vector<int> visited;
+      // exercise
+      custom::BST <Spy> ::stack_iterator it(bst.root, Spy(45));
+      for (; it != bst.scan_end(); ++it)
+         visited.push_back((*it).get());
+      // verify
+      assertUnit(visited == std::vector<int>({ 50, 60, 70, 80 }));
+      assertStandardFixture(bst);
+      // teardown
+      teardownStandardFixture(bst);
+   }
+
+   // the scan and the iterator agree on a big tree
+   void test_stackIterator_large()
+   {  // setup
+      custom::BST <int> bst;
+      for (int i = 0; i < 5000; i++)
+         bst.insert((i * 7919) % 5000);
+      // exercise
+      auto itScan = bst.scan_begin();
+      auto it = bst.begin();
+      int num = 0;
+      for (; it != bst.end() && itScan != bst.scan_end(); ++it, ++itScan, ++num)
+         if (*it != *itScan)
+            break;
+      // verify
+      assertUnit(num == 5000);
+      assertUnit(it == bst.end());
+      assertUnit(itScan == bst.scan_end());
+   }  // teardown
+
+   // for_each visits everything in order
+   void test_forEach_standard()
+   {  // setup
+      custom::BST <Spy> bst;
+      setupStandardFixture(bst);
+      std::vector<int> visited;
+      // exercise
+      bst.for_each([&visited](const Spy& s) { visited.push_back(s.get()); });
+      // verify
+      assertUnit(visited == std::vector<int>({ 20, 30, 40, 50, 60, 70, 80 }));
+      assertStandardFixture(bst);
+      // teardown
+      teardownStandardFixture(bst);
+   }
+
+   /***************************************
+    * BOUNDS AND RANGES
+    *    BST::lower_bound(const T &)
+    *    BST::upper_bound(const T &)
+    *    BST::equal_range(const T &)
+    *    BST::count_range(const T &, const T &)
+    *    BST::visit_range(const T &, const T &, Visit)
+    ***************************************/
+
+   // no bound in an empty tree
+   void test_lowerBound_empty()
+   {  // setup
+      custom::BST <Spy> bst;
+      Spy s(50);
+      Spy::reset();
+      // exercise
+      auto it = bst.lower_bound(s);
+      // verify
+      assertUnit(Spy::numLessthan() == 0);
+      assertUnit(it == bst.end());
+      assertEmptyFixture(bst);
+   }  // teardown
+
+   // the lower bound of a value in the tree is that value
+   void test_lowerBound_standardPresent()
+   {  // setup
+      //                 50 
+      //          +-------+-------+
+      //         30              70  
+      //     +----+----+     +----+----+
+      //    20        40    60        80  
+      custom::BST <Spy> bst;
+      setupStandardFixture(bst);
+      Spy s(40);
+      Spy::reset();
+      // exercise
+      auto it = bst.lower_bound(s);
+      // verify
+      assertUnit(Spy::numLessthan() == 3);    // compare [50][30][40]
+      assertUnit(Spy::numEquals() == 0);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(it.pNode != nullptr);
+      if (it.pNode)
+         assertUnit(*it == Spy(40));
+      assertStandardFixture(bst);
+      // teardown
+      teardownStandardFixture(bst);
+   }
+
+   // find takes anything that compares with a T, without making a T
+   void test_find_heterogeneous()
+   {  // setup
+      custom::BST <std::string> bst;
+      bst.insert(std::string("bravo"));
+      bst.insert(std::string("alpha"));
+      bst.insert(std::string("charlie"));
+      // exercise
+      auto itFound = bst.find("charlie");
+      auto itMissing = bst.find("beta");
+      // verify
+      assertUnit(itFound != bst.end());
+      assertUnit(*itFound == std::string("charlie"));
+      assertUnit(itMissing == bst.end());
+   }  // teardown
+
+   // lower_bound and upper_bound take anything that compares with a T
+   void test_lowerBound_heterogeneous()
+   {  // setup
+      custom::BST <std::string> bst;
+      bst.insert(std::string("bravo"));
+      bst.insert(std::string("alpha"));
+      bst.insert(std::string("charlie"));
+      // exercise
+      auto itLower = bst.lower_bound("b");
+      auto itUpper = bst.upper_bound("bravo");
+      size_t num = bst.count_range("a", "c");
+      // verify
+      assertUnit(*itLower == std::string("bravo"));
+      assertUnit(*itUpper == std::string("charlie"));
+      assertUnit(num == 2);
+   }  // teardown
+
+   // a key alone sorts by the pair's comparator, as the pairs do
+   void test_find_keyByComparator()
+   {  // setup
+      typedef custom::pair <int, int, std::greater <int>> Pairs;
+      custom::BST <Pairs> bst;
+      for (int key : { 5, 1, 3, 7 })
+         bst.insert(Pairs(key, key * 10));
+      // exercise
+      auto itKey = bst.find(3);
+      auto itPair = bst.find(Pairs(3, 0));
+      auto itLower = bst.lower_bound(4);
+      size_t num = bst.count_range(7, 2);
+      // verify
+      assertUnit(itKey != bst.end());
+      assertUnit(itKey == itPair);
+      assertUnit(itKey != bst.end() && (*itKey).second == 30);
+      assertUnit(itLower != bst.end() && (*itLower).first == 3);
+      assertUnit(num == 3);
+      assertUnit(bst.find(4) == bst.end());
+   }  // teardown
+
+   // the lower bound of a missing value is the next one up
+   void test_lowerBound_standardMissing()
+   {  // setup
+      //                 50 
+      //          +-------+-------+
+      //         30              70  
+      //     +----+----+     +----+----+
+      //    20        40    60        80  
+      custom::BST <Spy> bst;
+      setupStandardFixture(bst);
+      Spy s(45);
+      Spy::reset();
+      // exercise
+      auto it = bst.lower_bound(s);
+      // verify
+      assertUnit(Spy::numLessthan() == 3);    // compare [50][30][40]
+      assertUnit(it.pNode == bst.root);
+      assertStandardFixture(bst);
+      // teardown
+      teardownStandardFixture(bst);
+   }
+
+   // nothing is at least a value bigger than everything
+   void test_lowerBound_standardPastEnd()
+   {  // setup
+      custom::BST <Spy> bst;
+      setupStandardFixture(bst);
+      Spy s(85);
+      Spy::reset();
+      // exercise
+      auto it = bst.lower_bound(s);
+      // verify
+      assertUnit(Spy::numLessthan() == 3);    // compare [50][70][80]
+      assertUnit(it == bst.end());
+      assertStandardFixture(bst);
+      // teardown
+      teardownStandardFixture(bst);
+   }
+
+   // the upper bound of a value in the tree is the one after it
+   void test_upperBound_standardPresent()
+   {  // setup
+      //                 50 
+      //          +-------+-------+
+      //         30              70  
+      //     +----+----+     +----+----+
+      //    20        40    60        80  
+      custom::BST <Spy> bst;
+      setupStandardFixture(bst);
+      Spy s(40);
+      Spy::reset();
+      // exercise
+      auto it = bst.upper_bound(s);
+      // verify
+      assertUnit(Spy::numLessthan() == 3);    // compare [50][30][40]
+      assertUnit(it.pNode == bst.root);
+      assertStandardFixture(bst);
+      // teardown
+      teardownStandardFixture(bst);
+   }
+
+   // a missing value has an empty range where it would go
+   void test_equalRange_standardMissing()
+   {  // setup
+      custom::BST <Spy> bst;
+      setupStandardFixture(bst);
+      Spy s(65);
+      // exercise
+      auto range = bst.equal_range(s);
+      // verify
+      assertUnit(range.first == range.second);
+      assertUnit(range.first.pNode != nullptr);
+      if (range.first.pNode)
+         assertUnit(*range.first == Spy(70));
+      assertStandardFixture(bst);
+      // teardown
+      teardownStandardFixture(bst);
+   }
+
+   // count includes lo but not hi
+   void test_countRange_standard()
+   {  // setup
+      custom::BST <Spy> bst;
+      setupStandardFixture(bst);
+      // exercise
+      size_t numMiddle = bst.count_range(Spy(30), Spy(70));
+      size_t numGap = bst.count_range(Spy(41), Spy(49));
+      size_t numAll = bst.count_range(Spy(0), Spy(99));
+      // verify
+      assertUnit(numMiddle == 4);             // [30][40][50][60]
+      assertUnit(numGap == 0);
+      assertUnit(numAll == 7);
+      assertStandardFixture(bst);
+      // teardown
+      teardownStandardFixture(bst);
+   }
+
+   // the visitor sees the range in order and nothing else
+   void test_visitRange_standard()
+   {  // setup
+      custom::BST <Spy> bst;
+      setupStandardFixture(bst);
+      std::vector<int> visited;
+      // exercise
+      bst.visit_range(Spy(25), Spy(65), [&visited](const Spy& s) { visited.push_back(s.get()); });
+      // verify
+      assertUnit(visited == std::vector<int>({ 30, 40, 50, 60 }));
+      assertStandardFixture(bst);
+      // teardown
+      teardownStandardFixture(bst);
+   }
+
+   /***************************************
+    * ORDER STATISTICS
+    *    BST <T, A, true> ::nth_element(size_t)
+    *    BST <T, A, true> ::rank(const T &)
+    ***************************************/
+
+   // only a ranked tree pays for the count in each node
+   void test_ranked_nodeSize()
+   {  // setup
+      // exercise
+      size_t sizePlain = sizeof(custom::BST <int> ::BNode);
+      size_t sizeRanked = sizeof(custom::BST <int, std::allocator<int>, true> ::BNode);
+      // verify
+      assertUnit(sizeRanked == sizePlain + sizeof(size_t));
+   }  // teardown
+
+   // a small value leaves room after it for the color
+   void test_node_colorInPadding()
+   {  // setup
+      // exercise
+      size_t size = sizeof(custom::BST <int> ::BNode);
+      // verify
+      assertUnit(size == 2 * sizeof(int) + 3 * sizeof(void*));
+   }  // teardown
+
+   // a value with no room after it keeps the color in the parent pointer
+   void test_node_colorInParent()
+   {  // setup
+      // exercise
+      size_t sizeLong = sizeof(custom::BST <long> ::BNode);
+      size_t sizeString = sizeof(custom::BST <std::string> ::BNode);
+      // verify
+      assertUnit(sizeLong == sizeof(long) + 3 * sizeof(void*));
+      assertUnit(sizeString == sizeof(std::string) + 3 * sizeof(void*));
+   }  // teardown
+
+   // setting the color leaves the parent alone, and the other way around
+   void test_node_colorParentApart()
+   {  // setup
+      custom::BST <long> ::BNode parent(26L);
+      custom::BST <long> ::BNode child(11L);
+      // exercise
+      child.pParent = &parent;
+      bool isRedNew = child.isRed;
+      child.isRed = false;
+      custom::BST <long> ::BNode* pParentBlack = child.pParent;
+      child.pParent = nullptr;
+      bool isRedOrphan = child.isRed;
+      child.isRed = true;
+      // verify
+      assertUnit(isRedNew == true);
+      assertUnit(pParentBlack == &parent);
+      assertUnit(isRedOrphan == false);
+      assertUnit(child.pParent == nullptr);
+      assertUnit(child.isRed == true);
+      assertUnit(child.data == 11L);
+   }  // teardown
+
+   // the k-th element counts from zero
+   void test_nthElement_standard()
+   {  // setup
+      //                 50 
+      //          +-------+-------+
+      //         30              70  
+      //     +----+----+     +----+----+
+      //    20        40    60        80  
+      custom::BST <int, std::allocator<int>, true> bst;
+      for (int value : { 50, 30, 70, 20, 40, 60, 80 })
+         bst.insert(value);
+      // exercise
+      auto itFirst = bst.nth_element(0);
+      auto itMiddle = bst.nth_element(3);
+      auto itLast = bst.nth_element(6);
+      auto itPast = bst.nth_element(7);
+      // verify
+      assertUnit(bst.root->count() == 7);
+      assertUnit(itFirst != bst.end() && *itFirst == 20);
+      assertUnit(itMiddle != bst.end() && *itMiddle == 50);
+      assertUnit(itLast != bst.end() && *itLast == 80);
+      assertUnit(itPast == bst.end());
+   }  // teardown
+
+   // rank is how many are less, whether or not the value is there
+   void test_rank_standard()
+   {  // setup
+      custom::BST <int, std::allocator<int>, true> bst;
+      for (int value : { 50, 30, 70, 20, 40, 60, 80 })
+         bst.insert(value);
+      // exercise
+      size_t rankFirst = bst.rank(20);
+      size_t rankGap = bst.rank(45);
+      size_t rankPast = bst.rank(99);
+      size_t rankBefore = bst.rank(0);
+      // verify
+      assertUnit(rankFirst == 0);
+      assertUnit(rankGap == 3);
+      assertUnit(rankPast == 7);
+      assertUnit(rankBefore == 0);
+   }  // teardown
+
+   // counts survive the rotations of insert and erase
+   void test_ranked_insertErase()
+   {  // setup
+      custom::BST <int, std::allocator<int>, true> bst;
+      for (int i = 0; i < 1000; i++)
+         bst.insert((i * 7919) % 1000);
+      // exercise
+      for (int i = 0; i < 1000; i += 2)
+      {
+         auto it = bst.find((i * 7919) % 1000);
+         bst.erase(it);
+      }
+      // verify
+      assertUnit(bst.size() == 500);
+      assertUnit(bst.isRedBlack());
+      assertUnit(isCounted(bst.root));
+      bool allMatch = true;
+      size_t k = 0;
+      for (auto it = bst.begin(); it != bst.end(); ++it, ++k)
+         allMatch = allMatch && bst.nth_element(k) == it && bst.rank(*it) == k;
+      assertUnit(allMatch);
+      assertUnit(k == 500);
+   }  // teardown
+
+   // a tree built from a sorted range is counted as it is built
+   void test_ranked_constructSorted()
+   {  // setup
+      std::vector<int> v;
+      for (int i = 0; i < 100; i++)
+         v.push_back(i * 2);
+      // exercise
+      custom::BST <int, std::allocator<int>, true> bst(custom::sorted_range, v.begin(), v.end());
+      // verify
+      assertUnit(isCounted(bst.root));
+      assertUnit(*bst.nth_element(42) == 84);
+      assertUnit(bst.rank(85) == 43);
+   }  // teardown
+
+   // a copy has the same counts
+   void test_ranked_constructCopy()
+   {  // setup
+      custom::BST <int, std::allocator<int>, true> bstSrc;
+      for (int i = 0; i < 100; i++)
+         bstSrc.insert(i);
+      // exercise
+      custom::BST <int, std::allocator<int>, true> bstDes(bstSrc);
+      custom::BST <int, std::allocator<int>, true> bstAssign;
+      bstAssign.insert(5);
+      bstAssign = bstSrc;
+      // verify
+      assertUnit(isCounted(bstDes.root));
+      assertUnit(isCounted(bstAssign.root));
+      assertUnit(*bstDes.nth_element(99) == 99);
+      assertUnit(*bstAssign.nth_element(0) == 0);
+   }  // teardown
+
+   // a ranked tree counts a range in two descents
+   void test_countRange_ranked()
+   {  // setup
+      custom::BST <Spy, std::allocator<Spy>, true> bst;
+      for (int value : { 50, 30, 70, 20, 40, 60, 80 })
+         bst.insert(Spy(value));
+      Spy::reset();
+      // exercise
+      size_t numMiddle = bst.count_range(Spy(30), Spy(70));
+      // verify
+      assertUnit(numMiddle == 4);             // [30][40][50][60]
+      assertUnit(Spy::numLessthan() == 6);    // two descents of 3
+   }  // teardown
+
+   // string literal bounds are compared as keys, not as addresses
+   void test_countRange_rankedCString()
+   {  // setup
+      custom::BST <std::string, std::allocator<std::string>, true> bst;
+      for (const char* value : { "bravo", "alpha", "charlie", "delta" })
+         bst.insert(std::string(value));
+      // exercise
+      size_t num = bst.count_range("a", "c");
+      size_t numBackward = bst.count_range("c", "a");
+      // verify
+      assertUnit(num == 2);                   // [alpha][bravo]
+      assertUnit(numBackward == 0);
+   }  // teardown
+
+   /***************************************
+    * Split, join, and set algebra
+    *    BST::split(k)     BST::join(rhs)
+    *    BST::unite(rhs)   BST::intersect(rhs)
+    *    BST::subtract(rhs)
+    ***************************************/
+
+   // split keeps what is less and hands back the rest
+   void test_split_standard()
+   {  // setup
+      custom::BST <int> bst;
+      for (int i = 0; i < 100; i++)
+         bst.insert(i);
+      // exercise
+      custom::BST <int> bstMore = bst.split(37);
+      // verify
+      assertUnit(bst.numElements == 37);
+      assertUnit(bstMore.numElements == 63);
+      assertUnit(bst.isRedBlack());
+      assertUnit(bstMore.isRedBlack());
+      assertUnit(contents(bst) == range(0, 37));
+      assertUnit(contents(bstMore) == range(37, 100));
+      assertUnit(bst.pMax->data == 36);
+      assertUnit(bstMore.pMax->data == 99);
+   }  // teardown
+
+   // a ranked tree keeps its counts through a split
+   void test_split_ranked()
+   {  // setup
+      custom::BST <int, std::allocator<int>, true> bst;
+      for (int i = 0; i < 100; i++)
+         bst.insert(i);
+      // exercise
+      auto bstMore = bst.split(60);
+      // verify
+      assertUnit(bst.numElements == 60);
+      assertUnit(bstMore.numElements == 40);
+      assertUnit(isCounted(bst.root));
+      assertUnit(isCounted(bstMore.root));
+      assertUnit(*bstMore.nth_element(0) == 60);
+      assertUnit(bst.rank(59) == 59);
+   }  // teardown
+
+   // joining two trees of about the same size
+   void test_join_standard()
+   {  // setup
+      custom::BST <int> bst;
+      custom::BST <int> bstMore;
+      for (int i = 0; i < 50; i++)
+      {
+         bst.insert(i);
+         bstMore.insert(i + 50);
+      }
+      // exercise
+      bst.join(bstMore);
+      // verify
+      assertUnit(bst.numElements == 100);
+      assertUnit(bstMore.numElements == 0);
+      assertUnit(bstMore.root == nullptr);
+      assertUnit(bst.isRedBlack());
+      assertUnit(contents(bst) == range(0, 100));
+      assertUnit(bst.pMax->data == 99);
+   }  // teardown
+
+   // a short tree joins part way down the side of a tall one
+   void test_join_differentHeights()
+   {  // setup
+      custom::BST <int> bstSmall;
+      custom::BST <int> bstLarge;
+      custom::BST <int> bstTail;
+      for (int i = 0; i < 3; i++)
+         bstSmall.insert(i);
+      for (int i = 3; i < 1000; i++)
+         bstLarge.insert(i);
+      bstTail.insert(1000);
+      // exercise
+      bstSmall.join(bstLarge);
+      bstSmall.join(bstTail);
+      // verify
+      assertUnit(bstSmall.numElements == 1001);
+      assertUnit(bstSmall.isRedBlack());
+      assertUnit(contents(bstSmall) == range(0, 1001));
+   }  // teardown
+
+   // join will not put a tree out of order
+   void test_join_outOfOrder()
+   {  // setup
+      custom::BST <int> bst;
+      custom::BST <int> bstBefore;
+      bst.insert(50);
+      bstBefore.insert(10);
+      // exercise
+      try
+      {
+         bst.join(bstBefore);
+         assertUnit(false);
+      }
+      catch (const std::invalid_argument& error)
+      {
+         assertUnit(std::string(error.what()) == std::string("invalid BST<T> join"));
+      }
+      // verify
+      assertUnit(bst.numElements == 1);
+      assertUnit(bstBefore.numElements == 1);
+   }  // teardown
+
+   // an extracted node goes into another tree as it is
+   void test_extract_relinks()
+   {  // setup
+      custom::BST <int, std::allocator<int>, true> bst;
+      custom::BST <int, std::allocator<int>, true> bstOther;
+      for (int i = 0; i < 100; i++)
+         bst.insert(i);
+      bstOther.insert(10);
+      bstOther.insert(90);
+      auto pNode = bst.find(50).pNode;
+      // exercise
+      auto nh = bst.extract(50);
+      bool isFull = !nh.empty();
+      auto pReturn = bstOther.insert(std::move(nh));
+      // verify
+      assertUnit(isFull);
+      assertUnit(nh.empty());
+      assertUnit(pReturn.second);
+      assertUnit(pReturn.first.pNode == pNode);
+      assertUnit(bst.numElements == 99);
+      assertUnit(bst.find(50) == bst.end());
+      assertUnit(bst.rank(51) == 50);
+      assertUnit(bst.isRedBlack());
+      assertUnit(contents(bstOther) == std::vector<int>({ 10, 50, 90 }));
+      assertUnit(bstOther.rank(90) == 2);
+      assertUnit(bstOther.isRedBlack());
+   }  // teardown
+
+   // a value already in a unique tree is refused and the handle keeps it
+   void test_insertNode_duplicateKeepsNode()
+   {  // setup
+      custom::BST <int> bst;
+      custom::BST <int> bstOther;
+      bst.insert(50);
+      bstOther.insert(50);
+      auto nh = bstOther.extract(bstOther.begin());
+      // exercise
+      auto pReturn = bst.insert(std::move(nh), true /* keepUnique */);
+      auto nhMissing = bst.extract(26);
+      // verify
+      assertUnit(!pReturn.second);
+      assertUnit(pReturn.first == bst.begin());
+      assertUnit(!nh.empty() && nh.value() == 50);
+      assertUnit(nhMissing.empty());
+      assertUnit(bst.numElements == 1);
+      assertUnit(bstOther.numElements == 0);
+   }  // teardown
+
+   // merge moves over the nodes not already here and leaves the rest
+   void test_merge_standard()
+   {  // setup
+      custom::BST <int> bst;
+      custom::BST <int> bstRhs;
+      for (int i = 0; i < 100; i += 2)
+         bst.insert(i);
+      for (int i = 0; i < 100; i += 3)
+         bstRhs.insert(i);
+      auto pNode = bstRhs.find(3).pNode;
+      std::vector<int> both;
+      std::vector<int> either;
+      for (int i = 0; i < 100; i++)
+      {
+         if (i % 6 == 0)
+            both.push_back(i);
+         if (i % 2 == 0 || i % 3 == 0)
+            either.push_back(i);
+      }
+      // exercise
+      bst.merge(bstRhs);
+      // verify
+      assertUnit(contents(bst) == either);
+      assertUnit(contents(bstRhs) == both);
+      assertUnit(bst.numElements == either.size());
+      assertUnit(bstRhs.numElements == both.size());
+      assertUnit(bst.find(3).pNode == pNode);
+      assertUnit(bst.isRedBlack());
+      assertUnit(bstRhs.isRedBlack());
+      assertUnit(bst.pMax->data == 99);
+   }  // teardown
+
+   // the union has everything from both once
+   void test_unite_standard()
+   {  // setup
+      custom::BST <int> bst;
+      custom::BST <int> bstRhs;
+      for (int i = 0; i < 200; i += 2)
+         bst.insert(i);
+      for (int i = 0; i < 200; i += 3)
+         bstRhs.insert(i);
+      // exercise
+      bst.unite(bstRhs);
+      // verify
+      std::vector <int> expect;
+      for (int i = 0; i < 200; i++)
+         if (i % 2 == 0 || i % 3 == 0)
+            expect.push_back(i);
+      assertUnit(contents(bst) == expect);
+      assertUnit(bst.numElements == expect.size());
+      assertUnit(bstRhs.numElements == 0);
+      assertUnit(bstRhs.root == nullptr);
+      assertUnit(bst.isRedBlack());
+   }  // teardown
+
+   // the intersection has what is in both
+   void test_intersect_standard()
+   {  // setup
+      custom::BST <int> bst;
+      custom::BST <int> bstRhs;
+      for (int i = 0; i < 200; i += 2)
+         bst.insert(i);
+      for (int i = 0; i < 200; i += 3)
+         bstRhs.insert(i);
+      // exercise
+      bst.intersect(bstRhs);
+      // verify
+      std::vector <int> expect;
+      for (int i = 0; i < 200; i += 6)
+         expect.push_back(i);
+      assertUnit(contents(bst) == expect);
+      assertUnit(bst.numElements == expect.size());
+      assertUnit(bstRhs.numElements == 0);
+      assertUnit(bst.isRedBlack());
+   }  // teardown
+
+   // the difference has what is only in this tree
+   void test_subtract_standard()
+   {  // setup
+      custom::BST <int> bst;
+      custom::BST <int> bstRhs;
+      for (int i = 0; i < 200; i += 2)
+         bst.insert(i);
+      for (int i = 0; i < 200; i += 3)
+         bstRhs.insert(i);
+      // exercise
+      bst.subtract(bstRhs);
+      // verify
+      std::vector <int> expect;
+      for (int i = 0; i < 200; i += 2)
+         if (i % 3 != 0)
+            expect.push_back(i);
+      assertUnit(contents(bst) == expect);
+      assertUnit(bst.numElements == expect.size());
+      assertUnit(bstRhs.numElements == 0);
+      assertUnit(bst.isRedBlack());
+   }  // teardown
+
+   // nothing is copied; only the duplicates in rhs are destroyed
+   void test_unite_spyDropsDuplicates()
+   {  // setup
+      custom::BST <Spy> bst;
+      custom::BST <Spy> bstRhs;
+      for (int i = 0; i < 20; i++)
+      {
+         bst.insert(Spy(i));
+         bstRhs.insert(Spy(i + 15));
+      }
+      Spy::reset();
+      // exercise
+      bst.unite(bstRhs);
+      // verify
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(Spy::numDestructor() == 5);  // [15] through [19] from rhs
+      assertUnit(bst.numElements == 35);
+      assertUnit(bst.isRedBlack());
+   }  // teardown
+
+   // big trees are united on several threads
+   void test_unite_parallel()
+   {  // setup
+      custom::BST <int, std::allocator<int>, true> bst;
+      custom::BST <int, std::allocator<int>, true> bstRhs;
+      for (int i = 0; i < 40000; i++)
+      {
+         bst.insert(i * 2);
+         bstRhs.insert(i * 5);
+      }
+      // exercise
+      bst.unite(bstRhs);
+      // verify
+      std::vector <int> expect;
+      for (int i = 0; i < 200000; i++)
+         if ((i % 2 == 0 && i < 80000) || i % 5 == 0)
+            expect.push_back(i);
+      assertUnit(contents(bst) == expect);
+      assertUnit(bst.numElements == expect.size());
+      assertUnit(bst.isRedBlack());
+      assertUnit(isCounted(bst.root));
+   }  // teardown
+
    /***************************************
     * Insert
     *    BST::insert(const T &)
@@ -2239,6 +3202,174 @@ public:
       teardownStandardFixture(bst);
    }
 
+   // three in a row rotate into a balanced tree
+   void test_insert_rotate()
+   {  // setup
+      custom::BST <int> bst;
+      // exercise
+      bst.insert(10);
+      bst.insert(20);
+      bst.insert(30);
+      // verify
+      //           (20b)
+      //        +----+----+
+      //     (10r)      (30r)
+      assertUnit(bst.numElements == 3);
+      assertUnit(bst.root != nullptr);
+      if (bst.root && bst.root->pLeft && bst.root->pRight)
+      {
+         assertUnit(bst.root->data == 20);
+         assertUnit(bst.root->isRed == false);
+         assertUnit(bst.root->pParent == nullptr);
+         assertUnit(bst.root->pLeft->data == 10);
+         assertUnit(bst.root->pLeft->isRed == true);
+         assertUnit(bst.root->pLeft->pParent == bst.root);
+         assertUnit(bst.root->pRight->data == 30);
+         assertUnit(bst.root->pRight->isRed == true);
+         assertUnit(bst.root->pRight->pParent == bst.root);
+      }
+      assertUnit(bst.isRedBlack());
+   }  // teardown
+
+   // sorted input no longer makes a linked list
+   void test_insert_sortedBalanced()
+   {  // setup
+      custom::BST <int> bst;
+      // exercise
+      for (int i = 0; i < 1023; i++)
+         bst.insert(i);
+      // verify
+      assertUnit(bst.numElements == 1023);
+      assertUnit(bst.isRedBlack());
+      assertUnit(height(bst.root) <= 20);   // 2 log2(n + 1)
+      int expect = 0;
+      for (auto it = bst.begin(); it != bst.end(); ++it, ++expect)
+         if (*it != expect)
+            break;
+      assertUnit(expect == 1023);
+   }  // teardown
+
+   // a copy has the same colors as the original
+   void test_constructCopy_keepColors()
+   {  // setup
+      custom::BST <int> bstSrc;
+      for (int i = 0; i < 100; i++)
+         bstSrc.insert(i);
+      // exercise
+      custom::BST <int> bstDes(bstSrc);
+      // verify
+      assertUnit(bstDes.isRedBlack());
+      bool same = true;
+      auto itSrc = bstSrc.begin();
+      for (auto itDes = bstDes.begin(); itDes != bstDes.end(); ++itDes, ++itSrc)
+         same = same && itDes.pNode->isRed == itSrc.pNode->isRed;
+      assertUnit(same);
+   }  // teardown
+
+   // values in order go after the largest with one compare each
+   void test_insert_ascendingAppends()
+   {  // setup
+      custom::BST <Spy> bst;
+      bst.insert(Spy(0));
+      bst.insert(Spy(1));
+      Spy::reset();
+      // exercise
+      for (int i = 2; i < 100; i++)
+         bst.insert(Spy(i));
+      // verify
+      assertUnit(Spy::numLessthan() == 98);
+      assertUnit(bst.numElements == 100);
+      assertUnit(bst.isRedBlack());
+      assertUnit(bst.pMax == bst.rightmost(bst.root));
+      int expect = 0;
+      for (auto it = bst.begin(); it != bst.end(); ++it, ++expect)
+         if ((*it).get() != expect)
+            break;
+      assertUnit(expect == 100);
+   }  // teardown
+
+   // a hint of end() appends without a search
+   void test_insert_hintEnd()
+   {  // setup
+      //                 50 
+      //          +-------+-------+
+      //         30              70  
+      //     +----+----+     +----+----+
+      //    20        40    60        80  
+      custom::BST <Spy> bst;
+      setupStandardFixture(bst);
+      bst.pMax = bst.root->pRight->pRight;
+      Spy s(90);
+      Spy::reset();
+      // exercise
+      auto it = bst.insert(bst.end(), s);
+      // verify
+      assertUnit(Spy::numLessthan() == 1);    // compare [80]
+      assertUnit(it.pNode == bst.root->pRight->pRight->pRight);
+      assertUnit((*it).get() == 90);
+      assertUnit(bst.pMax == it.pNode);
+      assertUnit(bst.numElements == 8);
+   }  // teardown
+
+   // a hint that fits puts the value right before it
+   void test_insert_hintFits()
+   {  // setup
+      //                 50 
+      //          +-------+-------+
+      //         30              70  
+      //     +----+----+     +----+----+
+      //    20        40    60        80  
+      //              +----+
+      //                  45
+      custom::BST <Spy> bst;
+      setupStandardFixture(bst);
+      Spy s(45);
+      Spy::reset();
+      // exercise
+      auto it = bst.insert(custom::BST <Spy>::iterator(bst.root), s);
+      // verify
+      assertUnit(Spy::numLessthan() == 2);    // compare [50][40]
+      assertUnit(it.pNode == bst.root->pLeft->pRight->pRight);
+      assertUnit((*it).get() == 45);
+      assertUnit(bst.numElements == 8);
+   }  // teardown
+
+   // a hint that does not fit still puts the value in order
+   void test_insert_hintWrong()
+   {  // setup
+      custom::BST <int> bst;
+      for (int i = 0; i < 100; i += 2)
+         bst.insert(i);
+      // exercise
+      auto it = bst.insert(bst.begin(), 51);
+      bst.insert(bst.end(), 13);
+      // verify
+      assertUnit(*it == 51);
+      assertUnit(bst.numElements == 52);
+      assertUnit(bst.isRedBlack());
+      bool ordered = true;
+      for (auto itPrev = bst.begin(), itNext = ++bst.begin(); itNext != bst.end(); itPrev = itNext, ++itNext)
+         ordered = ordered && *itPrev <= *itNext;
+      assertUnit(ordered);
+   }  // teardown
+
+   // erasing the largest makes the one before it the largest
+   void test_erase_largestThenAppend()
+   {  // setup
+      custom::BST <int> bst;
+      for (int i = 0; i < 10; i++)
+         bst.insert(i);
+      // exercise
+      auto it = bst.find(9);
+      bst.erase(it);
+      bst.insert(bst.end(), 20);
+      // verify
+      assertUnit(bst.numElements == 10);
+      assertUnit(bst.pMax->data == 20);
+      assertUnit(bst.pMax == bst.rightmost(bst.root));
+      assertUnit(bst.isRedBlack());
+   }  // teardown
+
 
    /***************************************
     * Erase
@@ -2475,6 +3606,89 @@ public:
       bst.root = nullptr;
    }
 
+   // the tree stays red-black while nodes of every color come out
+   void test_erase_balanced()
+   {  // setup
+      custom::BST <int> bst;
+      for (int i = 0; i < 500; i++)
+         bst.insert((i * 37) % 500);
+      bool alwaysRedBlack = true;
+      // exercise
+      for (int i = 0; i < 500; i += 2)
+      {
+         auto it = bst.find((i * 53) % 500);
+         bst.erase(it);
+         alwaysRedBlack = alwaysRedBlack && bst.isRedBlack();
+      }
+      // verify
+      assertUnit(alwaysRedBlack);
+      assertUnit(bst.numElements == 250);
+      while (bst.root)
+      {
+         auto it = custom::BST <int> ::iterator(bst.root);
+         bst.erase(it);
+         alwaysRedBlack = alwaysRedBlack && bst.isRedBlack();
+      }
+      assertUnit(alwaysRedBlack);
+      assertUnit(bst.numElements == 0);
+   }  // teardown
+
+   /**************************************************************
+    * CONTENTS
+    * Everything in the tree, in order
+    *************************************************************/
+   template <class BST>
+   std::vector <int> contents(BST& bst)
+   {
+      std::vector <int> values;
+      for (auto it = bst.begin(); it != bst.end(); ++it)
+         values.push_back(*it);
+      return values;
+   }
+   std::vector <int> range(int first, int last)
+   {
+      std::vector <int> values;
+      for (int i = first; i < last; i++)
+         values.push_back(i);
+      return values;
+   }
+
+   /**************************************************************
+    * IS COUNTED
+    * Every node's count is the size of its subtree
+    *************************************************************/
+   template <class BNode>
+   bool isCounted(const BNode* pNode)
+   {
+      return countNodes(pNode) != (size_t)-1;
+   }
+   template <class BNode>
+   size_t countNodes(const BNode* pNode)
+   {
+      if (pNode == nullptr)
+         return 0;
+      size_t numLeft = countNodes(pNode->pLeft);
+      size_t numRight = countNodes(pNode->pRight);
+      if (numLeft == (size_t)-1 || numRight == (size_t)-1 ||
+          pNode->count() != numLeft + numRight + 1)
+         return (size_t)-1;
+      return pNode->count();
+   }
+
+   /**************************************************************
+    * HEIGHT
+    * Number of levels in the tree below pNode
+    *************************************************************/
+   template <class BNode>
+   int height(const BNode* pNode)
+   {
+      if (pNode == nullptr)
+         return 0;
+      int heightLeft = height(pNode->pLeft);
+      int heightRight = height(pNode->pRight);
+      return 1 + (heightLeft > heightRight ? heightLeft : heightRight);
+   }
+
    /**************************************************************
     * SETUP STANDARD FIXTURE
     *                (50) 
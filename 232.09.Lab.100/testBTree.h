@@ -0,0 +1,466 @@
+/***********************************************************************
+ * Header:
+ *    TEST B-TREE
+ * Summary:
+ *    Unit tests for btree_set and btree_map
+ * Author
+ *    Gabe Lytle, M. Scott O'Connor
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "btree.h"
+#include "unitTest.h"
+#include "spy.h"
+
+#include <string>
+
+class TestBTree : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Set
+      test_construct_default();
+      test_insert_sorted();
+      test_insert_duplicate();
+      test_insert_split();
+      test_insert_many();
+      test_find_standard();
+      test_lowerBound_acrossLeaves();
+      test_upperBound_acrossLeaves();
+      test_iterate_backward();
+      test_erase_standard();
+      test_erase_many();
+      test_eraseIterator_standard();
+      test_constructCopy_standard();
+      test_clear_standard();
+
+      // Map
+      test_map_squareBracket();
+      test_map_at();
+      test_map_squareBracketSpy();
+
+      report("BTree");
+   }
+
+   /***************************************
+    * SET
+    ***************************************/
+
+   // an empty set has no nodes at all
+   void test_construct_default()
+   {  // setup
+      // exercise
+      custom::btree_set <int> s;
+      // verify
+      assertUnit(s.empty());
+      assertUnit(s.root == nullptr);
+      assertUnit(s.pFirst == nullptr);
+      assertUnit(s.begin() == s.end());
+   }  // teardown
+
+   // a few values sit in order in a single leaf
+   void test_insert_sorted()
+   {  // setup
+      custom::btree_set <int> s;
+      // exercise
+      s.insert(31);
+      s.insert(11);
+      s.insert(26);
+      // verify
+      assertStandardFixture(s);
+   }  // teardown
+
+   // inserting a value already there changes nothing
+   void test_insert_duplicate()
+   {  // setup
+      custom::btree_set <int> s{ 11, 26, 31 };
+      // exercise
+      auto result = s.insert(26);
+      // verify
+      assertUnit(result.second == false);
+      assertUnit(*result.first == 26);
+      assertStandardFixture(s);
+   }  // teardown
+
+   // one more value than a leaf holds splits it under a new root
+   void test_insert_split()
+   {  // setup
+      typedef custom::btree_set <int> Set;
+      const int numMax = Set::LEAF_MAX;
+      Set s;
+      for (int i = 0; i < numMax; i++)
+         s.insert(i);
+      assertUnit(s.root->isLeaf);
+      // exercise
+      s.insert(numMax);
+      // verify
+      assertUnit(!s.root->isLeaf);
+      assertUnit(s.root->num == 1);
+      assertUnit(s.pFirst != s.pLast);
+      assertUnit(s.pFirst->pNext == s.pLast);
+      assertUnit(s.pLast->pPrev == s.pFirst);
+      assertUnit(s.pFirst->num + s.pLast->num == numMax + 1);
+      assertUnit(isValid(s));
+   }  // teardown
+
+   // enough values for a few levels, in a scrambled order
+   void test_insert_many()
+   {  // setup
+      custom::btree_set <int> s;
+      // exercise
+      for (int i = 0; i < 20000; i++)
+         s.insert((i * 7919) % 20000);
+      // verify
+      assertUnit(s.size() == 20000);
+      assertUnit(depth(s) >= 3);
+      assertUnit(isValid(s));
+      int expect = 0;
+      for (auto it = s.begin(); it != s.end(); ++it, ++expect)
+         if (*it != expect)
+            break;
+      assertUnit(expect == 20000);
+   }  // teardown
+
+   // find what is there and only what is there
+   void test_find_standard()
+   {  // setup
+      custom::btree_set <int> s;
+      for (int i = 0; i < 1000; i += 2)
+         s.insert(i);
+      // exercise
+      auto it500 = s.find(500);
+      auto it501 = s.find(501);
+      // verify
+      assertUnit(it500 != s.end() && *it500 == 500);
+      assertUnit(it501 == s.end());
+      assertUnit(s.count(998) == 1);
+      assertUnit(s.count(-1) == 0);
+   }  // teardown
+
+   // lower_bound past the end of one leaf lands on the next
+   void test_lowerBound_acrossLeaves()
+   {  // setup
+      custom::btree_set <int> s;
+      for (int i = 0; i < 1000; i += 2)
+         s.insert(i);
+      int lastOfFirst = s.pFirst->value(s.pFirst->num - 1);
+      // exercise
+      auto itBefore = s.lower_bound(-5);
+      auto itExact  = s.lower_bound(500);
+      auto itGap    = s.lower_bound(lastOfFirst + 1);
+      auto itAfter  = s.lower_bound(999);
+      // verify
+      assertUnit(*itBefore == 0);
+      assertUnit(*itExact == 500);
+      assertUnit(*itGap == lastOfFirst + 2);
+      assertUnit(itGap.pLeaf == s.pFirst->pNext);
+      assertUnit(itAfter == s.end());
+   }  // teardown
+
+   // upper_bound is the first value greater than the key
+   void test_upperBound_acrossLeaves()
+   {  // setup
+      custom::btree_set <int> s;
+      for (int i = 0; i < 1000; i += 2)
+         s.insert(i);
+      int lastOfFirst = s.pFirst->value(s.pFirst->num - 1);
+      // exercise
+      auto itExact = s.upper_bound(500);
+      auto itEdge  = s.upper_bound(lastOfFirst);
+      auto itLast  = s.upper_bound(998);
+      // verify
+      assertUnit(*itExact == 502);
+      assertUnit(*itEdge == lastOfFirst + 2);
+      assertUnit(itLast == s.end());
+   }  // teardown
+
+   // -- walks back through the leaves
+   void test_iterate_backward()
+   {  // setup
+      custom::btree_set <int> s;
+      for (int i = 0; i < 1000; i++)
+         s.insert(i);
+      auto it = s.find(999);
+      int expect = 999;
+      // exercise
+      for (; it != s.end(); --it, --expect)
+         if (*it != expect)
+            break;
+      // verify
+      assertUnit(expect == -1);
+   }  // teardown
+
+   // erase by key
+   void test_erase_standard()
+   {  // setup
+      custom::btree_set <int> s{ 11, 26, 99, 31 };
+      // exercise
+      size_t numErased = s.erase(99);
+      size_t numMissing = s.erase(42);
+      // verify
+      assertUnit(numErased == 1);
+      assertUnit(numMissing == 0);
+      assertStandardFixture(s);
+   }  // teardown
+
+   // erasing most of a big tree borrows, merges, and shrinks it
+   void test_erase_many()
+   {  // setup
+      custom::btree_set <int> s;
+      for (int i = 0; i < 20000; i++)
+         s.insert(i);
+      int depthBefore = depth(s);
+      // exercise
+      for (int i = 0; i < 20000; i++)
+         if (i % 100 != 0)
+            s.erase((i * 7919) % 20000);
+      // verify
+      assertUnit(s.size() == 200);
+      assertUnit(depth(s) < depthBefore);
+      assertUnit(isValid(s));
+      bool allThere = true;
+      for (int i = 0; i < 20000; i += 100)
+         allThere = allThere && s.count((i * 7919) % 20000) == 1;
+      assertUnit(allThere);
+   }  // teardown
+
+   // erase by iterator returns the next one
+   void test_eraseIterator_standard()
+   {  // setup
+      custom::btree_set <int> s{ 11, 26, 28, 31 };
+      auto it = s.find(28);
+      // exercise
+      auto itNext = s.erase(it);
+      // verify
+      assertUnit(*itNext == 31);
+      assertStandardFixture(s);
+   }  // teardown
+
+   // a copy has the same shape in nodes of its own
+   void test_constructCopy_standard()
+   {  // setup
+      custom::btree_set <int> sSrc;
+      for (int i = 0; i < 500; i++)
+         sSrc.insert(i);
+      // exercise
+      custom::btree_set <int> sDes(sSrc);
+      sSrc.erase(250);
+      // verify
+      assertUnit(sDes.size() == 500);
+      assertUnit(depth(sDes) == depth(sSrc));
+      assertUnit(isValid(sDes));
+      assertUnit(sDes.pFirst != sSrc.pFirst);
+      assertUnit(sDes.count(250) == 1);
+      int expect = 0;
+      for (auto it = sDes.begin(); it != sDes.end(); ++it, ++expect)
+         if (*it != expect)
+            break;
+      assertUnit(expect == 500);
+   }  // teardown
+
+   // clear destroys every value and separator and frees every node
+   void test_clear_standard()
+   {  // setup
+      custom::btree_set <Spy> s;
+      for (int i = 0; i < 100; i++)
+         s.insert(Spy(i));
+      int numSeparators = numKeys(s, s.root);
+      assertUnit(numSeparators > 0);
+      Spy::reset();
+      // exercise
+      s.clear();
+      // verify
+      assertUnit(Spy::numDestructor() == 100 + numSeparators);
+      assertUnit(s.empty());
+      assertUnit(s.root == nullptr);
+      assertUnit(s.pFirst == nullptr);
+      assertUnit(s.pLast == nullptr);
+   }  // teardown
+
+   /***************************************
+    * MAP
+    ***************************************/
+
+   // operator [] adds missing keys and finds existing ones
+   void test_map_squareBracket()
+   {  // setup
+      custom::btree_map <std::string, int> m;
+      // exercise
+      m["twenty-six"] = 26;
+      m["eleven"] = 11;
+      m["twenty-six"] += 1;
+      // verify
+      assertUnit(m.size() == 2);
+      assertUnit(m["eleven"] == 11);
+      assertUnit(m["twenty-six"] == 27);
+      assertUnit(m.begin()->first == std::string("eleven"));
+      assertUnit(m.lower_bound("f")->first == std::string("twenty-six"));
+   }  // teardown
+
+   // at() throws for a missing key
+   void test_map_at()
+   {  // setup
+      custom::btree_map <int, int> m{ custom::pair <int, int>(11, 110) };
+      bool thrown = false;
+      // exercise
+      int value = m.at(11);
+      try
+      {
+         m.at(26);
+      }
+      catch (const char* error)
+      {
+         thrown = true;
+      }
+      // verify
+      assertUnit(value == 110);
+      assertUnit(thrown);
+   }  // teardown
+
+   // looking up an existing key builds nothing
+   void test_map_squareBracketSpy()
+   {  // setup
+      custom::btree_map <int, Spy> m;
+      m[11] = Spy(110);
+      Spy::reset();
+      // exercise
+      Spy& s = m[11];
+      // verify
+      assertUnit(s == Spy(110));
+      assertUnit(Spy::numDefault() == 0);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+   }  // teardown
+
+   /****************************************************************
+    * DEPTH
+    * Levels from the root down to the leaves
+    ****************************************************************/
+   template <class Tree>
+   int depth(const Tree& t)
+   {
+      int levels = 0;
+      for (auto pNode = t.root; pNode; levels++)
+         pNode = pNode->isLeaf ? nullptr :
+            static_cast<const typename Tree::Inner*>(pNode)->children[0];
+      return levels;
+   }
+
+   /****************************************************************
+    * NUM KEYS
+    * Separator keys in the inner nodes of a subtree
+    ****************************************************************/
+   template <class Tree, class Node>
+   int numKeys(const Tree& t, const Node* pNode)
+   {
+      if (pNode->isLeaf)
+         return 0;
+      auto pInner = static_cast<const typename Tree::Inner*>(pNode);
+      int num = pInner->num;
+      for (int i = 0; i <= pInner->num; i++)
+         num += numKeys(t, pInner->children[i]);
+      return num;
+   }
+
+   /****************************************************************
+    * IS VALID
+    * Every leaf is at the same depth, every node but the root is at
+    * least half full, the separators bound their children, and the
+    * leaf list visits every value in order
+    ****************************************************************/
+   template <class Tree>
+   bool isValid(const Tree& t)
+   {
+      if (t.root == nullptr)
+         return t.numElements == 0 && t.pFirst == nullptr && t.pLast == nullptr;
+
+      int depthLeaves = -1;
+      size_t numValues = 0;
+      typedef typename Tree::key_type K;
+      if (!isValidNode(t, t.root, 0, depthLeaves, numValues, (const K*)nullptr, (const K*)nullptr))
+         return false;
+      if (numValues != t.numElements)
+         return false;
+
+      // the leaf list is sorted both ways and has every value
+      size_t numLinked = 0;
+      const typename Tree::Leaf* pPrev = nullptr;
+      for (auto pLeaf = t.pFirst; pLeaf; pPrev = pLeaf, pLeaf = pLeaf->pNext)
+      {
+         if (pLeaf->pPrev != pPrev)
+            return false;
+         for (int i = 0; i < pLeaf->num; i++, numLinked++)
+            if (numLinked > 0 &&
+                !(i == 0 ? pPrev->value(pPrev->num - 1) < pLeaf->value(0)
+                         : pLeaf->value(i - 1) < pLeaf->value(i)))
+               return false;
+      }
+      return pPrev == t.pLast && numLinked == t.numElements;
+   }
+
+   template <class Tree, class Node, class K>
+   bool isValidNode(const Tree& t, const Node* pNode, int level, int& depthLeaves,
+                    size_t& numValues, const K* pLow, const K* pHigh)
+   {
+      bool isRoot = pNode == t.root;
+      if (pNode->isLeaf)
+      {
+         auto pLeaf = static_cast<const typename Tree::Leaf*>(pNode);
+         if (depthLeaves == -1)
+            depthLeaves = level;
+         if (level != depthLeaves || pLeaf->num > Tree::LEAF_MAX ||
+             (!isRoot && pLeaf->num < Tree::LEAF_MIN))
+            return false;
+         for (int i = 0; i < pLeaf->num; i++)
+            if ((pLow && pLeaf->value(i) < *pLow) || (pHigh && !(pLeaf->value(i) < *pHigh)))
+               return false;
+         numValues += pLeaf->num;
+         return true;
+      }
+
+      auto pInner = static_cast<const typename Tree::Inner*>(pNode);
+      if (pInner->num > Tree::INNER_MAX || pInner->num < (isRoot ? 1 : Tree::INNER_MIN))
+         return false;
+      for (int i = 0; i <= pInner->num; i++)
+      {
+         const K* pChildLow = i == 0 ? pLow : &pInner->key(i - 1);
+         const K* pChildHigh = i == pInner->num ? pHigh : &pInner->key(i);
+         if (!isValidNode(t, pInner->children[i], level + 1, depthLeaves, numValues,
+                          pChildLow, pChildHigh))
+            return false;
+      }
+      return true;
+   }
+
+   /****************************************************************
+    * Verify Standard Fixture
+    *       +----+----+----+
+    *       | 11 | 26 | 31 |
+    *       +----+----+----+
+    ****************************************************************/
+   void assertStandardFixtureParameters(const custom::btree_set <int>& s, int line, const char* function)
+   {
+      assertIndirect(s.size() == 3);
+      assertIndirect(s.root != nullptr);
+      if (s.root == nullptr)
+         return;
+      assertIndirect(s.root->isLeaf);
+      assertIndirect(s.pFirst == s.root);
+      assertIndirect(s.pLast == s.root);
+      assertIndirect(s.pFirst->num == 3);
+      if (s.pFirst->num != 3)
+         return;
+      assertIndirect(s.pFirst->value(0) == 11);
+      assertIndirect(s.pFirst->value(1) == 26);
+      assertIndirect(s.pFirst->value(2) == 31);
+      assertIndirect(isValid(s));
+   }
+};
+
+#endif // DEBUG
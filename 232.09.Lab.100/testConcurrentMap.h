@@ -0,0 +1,179 @@
+/***********************************************************************
+ * Header:
+ *    TEST CONCURRENT MAP
+ * Summary:
+ *    Unit tests for concurrent_map
+ * Author
+ *    Gabe Lytle, M. Scott O'Connor
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "concurrentMap.h"
+#include "unitTest.h"
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+class TestConcurrentMap : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      test_construct_default();
+      test_insert_standard();
+      test_insertOrAssign_snapshotUnchanged();
+      test_erase_missingPublishesNothing();
+      test_reclaim_noReaders();
+      test_reclaim_waitsForReader();
+      test_find_alongsideWriter();
+
+      report("ConcurrentMap");
+   }
+
+   // an empty map finds nothing and has nothing to free
+   void test_construct_default()
+   {  // setup
+      int value = 0;
+      // exercise
+      custom::concurrent_map <int, int> m;
+      // verify
+      assertUnit(m.empty());
+      assertUnit(m.size() == 0);
+      assertUnit(!m.find(11, value));
+      assertUnit(m.retired.empty());
+      assertUnit(m.pLatest.load() != nullptr);
+   }  // teardown
+
+   // an insert is seen by the next lookup; a duplicate is refused
+   void test_insert_standard()
+   {  // setup
+      custom::concurrent_map <std::string, int> m;
+      std::string value;
+      int number = 0;
+      // exercise
+      bool isNew = m.insert(custom::pair <std::string, int>("eleven", 11));
+      bool isDuplicate = m.insert(custom::pair <std::string, int>("eleven", 111));
+      // verify
+      assertUnit(isNew);
+      assertUnit(!isDuplicate);
+      assertUnit(m.size() == 1);
+      assertUnit(m.find("eleven", number));
+      assertUnit(number == 11);
+      assertUnit(m.contains("eleven"));
+      assertUnit(!m.contains("twenty-six"));
+   }  // teardown
+
+   // a snapshot is a version of its own
+   void test_insertOrAssign_snapshotUnchanged()
+   {  // setup
+      custom::concurrent_map <int, int> m;
+      m.insert_or_assign(11, 110);
+      m.insert_or_assign(26, 260);
+      auto snapshot = m.snapshot();
+      int value = 0;
+      // exercise
+      bool isNew = m.insert_or_assign(11, 111);
+      m.erase(26);
+      // verify
+      assertUnit(!isNew);
+      assertUnit(m.find(11, value) && value == 111);
+      assertUnit(!m.contains(26));
+      assertUnit(snapshot.size() == 2);
+      assertUnit(snapshot.at(11) == 110);
+      assertUnit(snapshot.at(26) == 260);
+   }  // teardown
+
+   // a write that changes nothing leaves the current version in place
+   void test_erase_missingPublishesNothing()
+   {  // setup
+      custom::concurrent_map <int, int> m;
+      m.insert_or_assign(11, 110);
+      auto pVersion = m.pLatest.load();
+      uint64_t epoch = m.epoch.load();
+      // exercise
+      size_t num = m.erase(26);
+      bool isNew = m.insert(custom::pair <int, int>(11, 111));
+      // verify
+      assertUnit(num == 0);
+      assertUnit(!isNew);
+      assertUnit(m.pLatest.load() == pVersion);
+      assertUnit(m.epoch.load() == epoch);
+   }  // teardown
+
+   // with no reader about, an old version is freed right away
+   void test_reclaim_noReaders()
+   {  // setup
+      custom::concurrent_map <int, int> m;
+      // exercise
+      for (int i = 0; i < 10; i++)
+         m.insert_or_assign(i, i);
+      // verify
+      assertUnit(m.retired.empty());
+      assertUnit(m.epoch.load() == 11);
+      assertUnit(m.size() == 10);
+   }  // teardown
+
+   // a reader still in a lookup keeps the version it may be in
+   void test_reclaim_waitsForReader()
+   {  // setup
+      custom::concurrent_map <int, int> m;
+      m.insert_or_assign(11, 110);
+      m.slots[5].epoch = m.epoch.load();   // a reader arrives
+      // exercise
+      m.insert_or_assign(26, 260);
+      size_t numHeld = m.retired.size();
+      m.slots[5].epoch = 0;                // and leaves
+      m.insert_or_assign(31, 310);
+      // verify
+      assertUnit(numHeld == 1);
+      assertUnit(m.retired.empty());
+      assertUnit(m.size() == 3);
+   }  // teardown
+
+   // readers never see a key without its value, nor a torn version,
+   // while a writer adds keys 0, 1, 2, ... with the value twice the key
+   void test_find_alongsideWriter()
+   {  // setup
+      custom::concurrent_map <int, int> m;
+      std::atomic <bool> isDone(false);
+      std::atomic <int> numWrong(0);
+      auto read = [&]()
+      {
+         int k = 0;
+         while (!isDone.load())
+         {
+            int value = -1;
+            if (m.find(k, value) && value != k * 2)
+               numWrong++;
+            k = (k + 7) % 1000;
+            auto snapshot = m.snapshot();
+            int expect = 0;
+            for (auto it = snapshot.begin(); it != snapshot.end(); ++it, ++expect)
+               if ((*it).first != expect)
+                  break;
+            if ((size_t)expect != snapshot.size())
+               numWrong++;
+         }
+      };
+      // exercise
+      std::thread reader1(read);
+      std::thread reader2(read);
+      for (int i = 0; i < 1000; i++)
+         m.insert_or_assign(i, i * 2);
+      isDone = true;
+      reader1.join();
+      reader2.join();
+      // verify
+      assertUnit(numWrong == 0);
+      assertUnit(m.size() == 1000);
+   }  // teardown
+};
+
+#endif // DEBUG
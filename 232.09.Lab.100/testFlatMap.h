@@ -0,0 +1,315 @@
+/***********************************************************************
+ * Header:
+ *    TEST FLAT MAP
+ * Summary:
+ *    Unit tests for flat_map
+ * Author
+ *    Gabe Lytle, M. Scott O'Connor
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "flatMap.h"
+#include "unitTest.h"
+#include "spy.h"
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+class TestFlatMap : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_construct_unsorted();
+      test_construct_sorted();
+      test_constructCopy_standard();
+      test_constructCopy_emptyThenGrow();
+
+      // Access
+      test_find_standard();
+      test_find_cString();
+      test_lowerBound_everywhere();
+      test_square_addsMissing();
+      test_at_missingThrows();
+
+      // Insert
+      test_insert_middle();
+      test_insert_duplicate();
+      test_insert_duplicateNoCopy();
+      test_insert_hint();
+      test_insertRange_merge();
+
+      // Remove
+      test_erase_key();
+      test_erase_range();
+
+      report("FlatMap");
+   }
+
+   /***************************************
+    * CONSTRUCT
+    ***************************************/
+
+   // an empty map finds nothing
+   void test_construct_default()
+   {  // setup
+      // exercise
+      custom::flat_map <int, int> m;
+      // verify
+      assertUnit(m.empty());
+      assertUnit(m.size() == 0);
+      assertUnit(m.begin() == m.end());
+      assertUnit(m.find(11) == m.end());
+   }  // teardown
+
+   // pairs in any order are sorted; the first of a key wins
+   void test_construct_unsorted()
+   {  // setup
+      // exercise
+      custom::flat_map <int, int> m{ {31, 310}, {11, 110}, {26, 260}, {11, 111}, {31, 311} };
+      // verify
+      assertUnit(keys(m) == std::vector <int>({ 11, 26, 31 }));
+      assertUnit(m.at(11) == 110);
+      assertUnit(m.at(31) == 310);
+   }  // teardown
+
+   // sorted pairs are copied as they are, less any out of order
+   void test_construct_sorted()
+   {  // setup
+      std::vector <custom::pair <int, int>> v{ {11, 110}, {26, 260}, {26, 261}, {31, 310} };
+      // exercise
+      custom::flat_map <int, int> m(custom::sorted_range, v.begin(), v.end());
+      // verify
+      assertUnit(keys(m) == std::vector <int>({ 11, 26, 31 }));
+      assertUnit(m.at(26) == 260);
+   }  // teardown
+
+   // a copy is a map of its own
+   void test_constructCopy_standard()
+   {  // setup
+      custom::flat_map <int, int> m{ {11, 110}, {26, 260} };
+      // exercise
+      custom::flat_map <int, int> mCopy(m);
+      mCopy[31] = 310;
+      m.erase(11);
+      // verify
+      assertUnit(keys(m) == std::vector <int>({ 26 }));
+      assertUnit(keys(mCopy) == std::vector <int>({ 11, 26, 31 }));
+   }  // teardown
+
+   // a copy of an empty map grows like any other, with nothing lost
+   void test_constructCopy_emptyThenGrow()
+   {  // setup
+      custom::flat_map <int, int> mSrc;
+      // exercise
+      custom::flat_map <int, int> mDes(mSrc);
+      mDes[1] = 2;
+      // verify
+      assertUnit(mDes.size() == 1);
+      assertUnit(mDes.at(1) == 2);
+      assertUnit(mSrc.empty());
+   }  // teardown
+
+   /***************************************
+    * ACCESS
+    ***************************************/
+
+   // find returns the pair with the key, or end()
+   void test_find_standard()
+   {  // setup
+      custom::flat_map <int, int> m{ {11, 110}, {26, 260}, {31, 310} };
+      const custom::flat_map <int, int>& mConst = m;
+      // exercise
+      auto it = m.find(26);
+      auto itConst = mConst.find(31);
+      auto itMissing = m.find(20);
+      // verify
+      assertUnit(it != m.end() && it->second == 260);
+      assertUnit(itConst != mConst.end() && itConst->second == 310);
+      assertUnit(itMissing == m.end());
+   }  // teardown
+
+   // a string key is found by a C string without building a string
+   void test_find_cString()
+   {  // setup
+      custom::flat_map <std::string, int> m{ {"eleven", 11}, {"twenty-six", 26} };
+      // exercise
+      auto it = m.find("twenty-six");
+      // verify
+      assertUnit(it != m.end() && it->second == 26);
+      assertUnit(m.find("thirty-one") == m.end());
+   }  // teardown
+
+   // lower_bound and upper_bound before, on, between, and after the keys
+   void test_lowerBound_everywhere()
+   {  // setup
+      custom::flat_map <int, int> m{ {10, 0}, {20, 0}, {30, 0} };
+      // exercise and verify
+      assertUnit(m.lower_bound(5) == m.begin());
+      assertUnit(m.lower_bound(20) == m.begin() + 1);
+      assertUnit(m.upper_bound(20) == m.begin() + 2);
+      assertUnit(m.lower_bound(25) == m.begin() + 2);
+      assertUnit(m.lower_bound(35) == m.end());
+      assertUnit(m.count_range(15, 35) == 2);
+      assertUnit(m.count_range(35, 15) == 0);
+   }  // teardown
+
+   // the subscript adds a missing key in order with a default value
+   void test_square_addsMissing()
+   {  // setup
+      custom::flat_map <int, int> m{ {11, 110}, {31, 310} };
+      // exercise
+      m[26] += 260;
+      m[11] += 1;
+      // verify
+      assertUnit(keys(m) == std::vector <int>({ 11, 26, 31 }));
+      assertUnit(m.at(26) == 260);
+      assertUnit(m.at(11) == 111);
+   }  // teardown
+
+   // at() throws for a missing key, as map does
+   void test_at_missingThrows()
+   {  // setup
+      const custom::flat_map <int, int> m{ {11, 110} };
+      bool isThrown = false;
+      // exercise
+      try
+      {
+         m.at(26);
+      }
+      catch (const std::out_of_range&)
+      {
+         isThrown = true;
+      }
+      // verify
+      assertUnit(isThrown);
+      assertUnit(m[11] == 110);
+   }  // teardown
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   // an insert in the middle moves the later pairs back one
+   void test_insert_middle()
+   {  // setup
+      custom::flat_map <int, std::string> m;
+      // exercise
+      for (int k : { 50, 30, 70, 20, 40, 60, 80 })
+         m.insert(custom::pair <int, std::string>(k, std::to_string(k)));
+      // verify
+      assertUnit(keys(m) == std::vector <int>({ 20, 30, 40, 50, 60, 70, 80 }));
+      for (auto it = m.begin(); it != m.end(); ++it)
+         assertUnit(it->second == std::to_string(it->first));
+   }  // teardown
+
+   // a key already there is left alone
+   void test_insert_duplicate()
+   {  // setup
+      custom::flat_map <int, int> m{ {11, 110}, {26, 260} };
+      // exercise
+      auto result = m.insert(custom::pair <int, int>(26, 261));
+      // verify
+      assertUnit(result.second == false);
+      assertUnit(result.first == m.begin() + 1);
+      assertUnit(m.size() == 2);
+      assertUnit(m.at(26) == 260);
+   }  // teardown
+
+   // a pair whose key is already there is not copied at all
+   void test_insert_duplicateNoCopy()
+   {  // setup
+      custom::flat_map <int, Spy> m;
+      m[11] = Spy(110);
+      m[26] = Spy(260);
+      custom::pair <int, Spy> p(26, Spy(261));
+      Spy::reset();
+      // exercise
+      auto result = m.insert(p);
+      auto it = m.insert(m.begin(), p);
+      // verify
+      assertUnit(result.second == false);
+      assertUnit(it == m.begin() + 1);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(m.size() == 2);
+   }  // teardown
+
+   // end() takes keys in increasing order; a wrong hint still works
+   void test_insert_hint()
+   {  // setup
+      custom::flat_map <int, int> m;
+      // exercise
+      for (int k = 0; k < 10; k++)
+         m.insert(m.end(), custom::pair <int, int>(k, k));
+      auto it = m.insert(m.end(), custom::pair <int, int>(-1, -1));
+      // verify
+      assertUnit(m.size() == 11);
+      assertUnit(it == m.begin());
+      assertUnit(keys(m) == std::vector <int>({ -1, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 }));
+   }  // teardown
+
+   // a batch is merged in once: old keys win, then the first of the batch
+   void test_insertRange_merge()
+   {  // setup
+      custom::flat_map <int, int> m{ {10, 100}, {30, 300}, {50, 500} };
+      std::vector <custom::pair <int, int>> v{ {40, 400}, {30, 301}, {5, 50}, {40, 401}, {60, 600} };
+      // exercise
+      m.insert(v.begin(), v.end());
+      // verify
+      assertUnit(keys(m) == std::vector <int>({ 5, 10, 30, 40, 50, 60 }));
+      assertUnit(m.at(30) == 300);
+      assertUnit(m.at(40) == 400);
+      assertUnit(m.at(5) == 50);
+   }  // teardown
+
+   /***************************************
+    * REMOVE
+    ***************************************/
+
+   // erase by key moves the later pairs forward
+   void test_erase_key()
+   {  // setup
+      custom::flat_map <int, int> m{ {11, 110}, {26, 260}, {31, 310} };
+      // exercise
+      size_t numMissing = m.erase(20);
+      size_t numErased = m.erase(11);
+      // verify
+      assertUnit(numMissing == 0);
+      assertUnit(numErased == 1);
+      assertUnit(keys(m) == std::vector <int>({ 26, 31 }));
+      assertUnit(m.at(31) == 310);
+   }  // teardown
+
+   // erase a range and get the pair after it
+   void test_erase_range()
+   {  // setup
+      custom::flat_map <int, int> m{ {10, 0}, {20, 0}, {30, 0}, {40, 0}, {50, 0} };
+      // exercise
+      auto it = m.erase(m.lower_bound(20), m.lower_bound(40));
+      // verify
+      assertUnit(it != m.end() && it->first == 40);
+      assertUnit(keys(m) == std::vector <int>({ 10, 40, 50 }));
+   }  // teardown
+
+private:
+   // the keys in order
+   template <class V>
+   std::vector <int> keys(const custom::flat_map <int, V>& m)
+   {
+      std::vector <int> v;
+      for (auto it = m.begin(); it != m.end(); ++it)
+         v.push_back(it->first);
+      return v;
+   }
+};
+
+#endif // DEBUG
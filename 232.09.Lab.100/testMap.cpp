@@ -16,6 +16,14 @@
 #include "testPair.h"      // for the pair unit tests
 #include "testBST.h"       // for the BST unit tests
 #include "testMap.h"       // for the map unit tests
+#include "testSkipList.h"  // for the skip list unit tests
+#include "testSlabAllocator.h" // for the slab allocator unit tests
+#include "testBTree.h"     // for the B-tree unit tests
+#include "testStaticSet.h" // for the static set unit tests
+#include "testPersistent.h" // for the persistent set unit tests
+#include "testConcurrentMap.h" // for the concurrent map unit tests
+#include "testFlatMap.h"   // for the flat map unit tests
+#include "testMultiMap.h"  // for the multiset and multimap unit tests
 int Spy::counters[] = {};
 
 /**********************************************************************
@@ -30,6 +38,14 @@ int main()
    TestPair().run();
    TestBST().run();
    TestMap().run();
+   TestSkipList().run();
+   TestSlabAllocator().run();
+   TestBTree().run();
+   TestStaticSet().run();
+   TestPersistent().run();
+   TestConcurrentMap().run();
+   TestFlatMap().run();
+   TestMultiMap().run();
 #endif // DEBUG
    
    return 0;
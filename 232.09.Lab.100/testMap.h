@@ -12,10 +12,16 @@
 
 #include "map.h"        // class under test
 #include "unitTest.h"   // unit test baseclass
+#include "spy.h"        // for SPY to count the values a lookup makes
 
 
+#include <iterator>
 #include <map>
+#include <sstream>
 #include <vector>
+#if __cplusplus >= 201703L
+#include <string_view>
+#endif
 
 /***********************************************
  * TEST MAP
@@ -42,6 +48,9 @@ public:
       test_constructRange_empty();
       test_constructRange_one();
       test_constructRange_standard();
+      test_constructRange_sorted();
+      test_constructRange_sortedDuplicates();
+      test_constructRange_singlePass();
       test_destructor_empty();
       test_destructor_standard();
 
@@ -79,21 +88,33 @@ public:
       test_access_standardLeftWrite();
       test_access_standardRightWrite();
       test_access_emptyWrite();
+      test_lowerBound_standard();
+      test_upperBound_standard();
+      test_equalRange_standard();
+      test_countRange_standard();
+      test_visitRange_standardWrite();
+      test_forEach_standardWrite();
+      test_insertHint_endAscending();
+      test_find_keyMakesNoValue();
+      test_find_standardCString();
+#if __cplusplus >= 201703L
+      test_find_standardStringView();
+#endif
       //test_access_standardFrontInsert();
       //test_access_standardMiddleInsert();
-      //test_at_standardRootRead();
-      //test_at_standardLeftRead();
-      //test_at_standardRightRead();
-      //test_at_standardRootWrite();
-      //test_at_standardLeftWrite();
-      //test_at_standardRightWrite();
-      //test_at_emptyWrite();
-      //test_at_standardWrite();
-      //test_find_empty();
-      //test_find_standardRoot();
-      //test_find_standardLeft();
-      //test_find_standardRight();
-      //test_find_standardMissing();
+      test_at_standardRootRead();
+      test_at_standardLeftRead();
+      test_at_standardRightRead();
+      test_at_standardRootWrite();
+      test_at_standardLeftWrite();
+      test_at_standardRightWrite();
+      test_at_emptyWrite();
+      test_at_standardWrite();
+      test_find_empty();
+      test_find_standardRoot();
+      test_find_standardLeft();
+      test_find_standardRight();
+      test_find_standardMissing();
 
       // Insert
       test_insertCopy_empty();
@@ -101,6 +122,13 @@ public:
       test_insertCopy_standardMiddle();
       test_insertMove_empty();
       test_insertMove_standard();
+      test_tryEmplace_newBuildsInPlace();
+      test_tryEmplace_presentBuildsNothing();
+      test_tryEmplace_ascendingBalanced();
+      test_insertOrAssign_standard();
+      test_access_newBuildsOneValue();
+      test_extract_newKeyNoCopies();
+      test_merge_keepsDuplicates();
 
       //// Remove
       //test_clear_empty();
@@ -448,6 +476,71 @@ public:
       teardownStandardFixture(m);
    }
 
+   // a sorted range is built balanced in one pass
+   void test_constructRange_sorted()
+   {  // setup
+      std::vector<custom::pair<int, int>> v;
+      for (int i = 0; i < 1000; i++)
+         v.push_back(custom::pair<int, int>(i, i * 10));
+      // exercise
+      custom::map<int, int> m(v.begin(), v.end());
+      // verify
+      assertUnit(m.size() == 1000);
+      assertUnit(m.bst.isRedBlack());
+      assertUnit(m.bst.root != nullptr);
+      if (m.bst.root)
+         assertUnit(m.bst.root->data.first == 499);
+      int expect = 0;
+      for (auto it = m.begin(); it != m.end(); ++it, ++expect)
+         if ((*it).first != expect || (*it).second != expect * 10)
+            break;
+      assertUnit(expect == 1000);
+   }  // teardown
+
+   // only the first of equal keys in a sorted range is kept
+   void test_constructRange_sortedDuplicates()
+   {  // setup
+      std::vector<custom::pair<std::string, int>> v
+      {
+         custom::pair<std::string, int>(std::string("30"), 30),
+         custom::pair<std::string, int>(std::string("50"), 50),
+         custom::pair<std::string, int>(std::string("50"), 99),
+         custom::pair<std::string, int>(std::string("70"), 70),
+         custom::pair<std::string, int>(std::string("70"), 99)
+      };
+      // exercise
+      custom::map<std::string, int> m(v.begin(), v.end());
+      // verify
+      //    "30"     "50"     "70" 
+      //   +----+   +----+   +----+
+      //   | 30 | - | 50 | - | 70 |
+      //   +----+   +----+   +----+
+      assertStandardFixture(m);
+      // teardown
+      teardownStandardFixture(m);
+   }  // teardown
+
+   // a range that can only be read once is inserted as it is read
+   void test_constructRange_singlePass()
+   {  // setup
+      std::istringstream in("5 50 1 10 3 30");
+      std::istringstream inSorted("1 10 3 30 5 50");
+      std::istream_iterator<custom::pair<int, int>> itEnd;
+      // exercise
+      custom::map<int, int> m(std::istream_iterator<custom::pair<int, int>>(in), itEnd);
+      custom::map<int, int> mSorted(std::istream_iterator<custom::pair<int, int>>(inSorted), itEnd);
+      // verify
+      assertUnit(m.size() == 3);
+      assertUnit(mSorted.size() == 3);
+      assertUnit(m.bst.isRedBlack());
+      int expect = 1;
+      for (auto it = m.begin(); it != m.end(); ++it, expect += 2)
+         if ((*it).first != expect || (*it).second != expect * 10)
+            break;
+      assertUnit(expect == 7);
+      assertUnit(mSorted[5] == 50);
+   }  // teardown
+
    /***************************************
     * DESTRUCTOR
     ***************************************/
@@ -1556,6 +1649,164 @@ public:
       teardownStandardFixture(m);
    }
 
+   /***************************************
+    * TRY EMPLACE and INSERT OR ASSIGN
+    *     map::try_emplace(const K &, Args ...)
+    *     map::insert_or_assign(const K &, M)
+    ***************************************/
+
+   // a new key gets a value built in its node, not copied there
+   void test_tryEmplace_newBuildsInPlace()
+   {  // setup
+      custom::map<int, Spy> m;
+      for (int i : { 50, 30, 70 })
+         m.insert(custom::pair<int, Spy>(i, Spy(i)));
+      Spy::reset();
+      // exercise
+      auto pReturn = m.try_emplace(60, 60);
+      // verify
+      assertUnit(pReturn.second == true);
+      assertUnit((*pReturn.first).first == 60);
+      assertUnit((*pReturn.first).second == Spy(60));
+      assertUnit(Spy::numNondefault() == 2);   // one here, one in the verify
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(m.size() == 4);
+      assertUnit(m.bst.isRedBlack());
+   }  // teardown
+
+   // a key already there is left alone and nothing is built
+   void test_tryEmplace_presentBuildsNothing()
+   {  // setup
+      custom::map<int, Spy> m;
+      for (int i : { 50, 30, 70 })
+         m.insert(custom::pair<int, Spy>(i, Spy(i)));
+      Spy value(99);
+      Spy::reset();
+      // exercise
+      auto pReturn = m.try_emplace(30, std::move(value));
+      // verify
+      assertUnit(pReturn.second == false);
+      assertUnit((*pReturn.first).first == 30);
+      assertUnit(Spy::numNondefault() == 0);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(value.get() == 99);
+      assertUnit(m.size() == 3);
+   }  // teardown
+
+   // keys in increasing order append without a search and stay balanced
+   void test_tryEmplace_ascendingBalanced()
+   {  // setup
+      custom::map<int, int> m;
+      // exercise
+      for (int i = 0; i < 100; i++)
+         m.try_emplace(i, i * 10);
+      m.try_emplace(50, 0);
+      // verify
+      assertUnit(m.size() == 100);
+      assertUnit(m.bst.isRedBlack());
+      assertUnit(m.bst.pMax != nullptr && m.bst.pMax->data.first == 99);
+      assertUnit(m.at(50) == 500);
+   }  // teardown
+
+   // insert_or_assign adds a new key and overwrites an old one
+   void test_insertOrAssign_standard()
+   {  // setup
+      //    "30"     "50"     "70"   = m
+      //   +----+   +----+   +----+
+      //   | 30 | - | 50 | - | 70 |
+      //   +----+   +----+   +----+
+      custom::map<std::string, int> m;
+      setupStandardFixture(m);
+      // exercise
+      auto pAssign = m.insert_or_assign(std::string("50"), 55);
+      auto pInsert = m.insert_or_assign(std::string("60"), 60);
+      // verify
+      //    "30"     "50"     "60"     "70"   = m
+      //   +----+   +----+   +----+   +----+
+      //   | 30 | - | 55 | - | 60 | - | 70 |
+      //   +----+   +----+   +----+   +----+
+      assertUnit(pAssign.second == false);
+      assertUnit(pInsert.second == true);
+      assertUnit((*pAssign.first).second == 55);
+      assertUnit((*pInsert.first).second == 60);
+      assertUnit(m.size() == 4);
+      assertUnit(m.at(std::string("50")) == 55);
+      assertUnit(m.at(std::string("60")) == 60);
+   }  // teardown
+
+   // the subscript builds one default value for a new key and copies none
+   void test_access_newBuildsOneValue()
+   {  // setup
+      custom::map<int, Spy> m;
+      for (int i : { 50, 30, 70 })
+         m.insert(custom::pair<int, Spy>(i, Spy(i)));
+      Spy::reset();
+      // exercise
+      m[60];
+      m[50];
+      // verify
+      assertUnit(Spy::numDefault() == 1);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(m.size() == 4);
+   }  // teardown
+
+
+   /***************************************
+    * NODE HANDLES
+    *     map::extract(const K &)
+    *     map::insert(node_type &&)
+    *     map::merge(map &)
+    ***************************************/
+
+   // a node moves to another map, under a new key, without a copy
+   void test_extract_newKeyNoCopies()
+   {  // setup
+      custom::map<int, Spy> m;
+      custom::map<int, Spy> mOther;
+      for (int i : { 50, 30, 70 })
+         m.insert(custom::pair<int, Spy>(i, Spy(i)));
+      Spy::reset();
+      // exercise
+      auto nh = m.extract(30);
+      nh.key() = 35;
+      auto pReturn = mOther.insert(std::move(nh));
+      // verify
+      assertUnit(pReturn.second);
+      assertUnit((*pReturn.first).first == 35);
+      assertUnit((*pReturn.first).second.get() == 30);
+      assertUnit(nh.empty());
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(Spy::numDestructor() == 0);
+      assertUnit(m.size() == 2);
+      assertUnit(mOther.size() == 1);
+   }  // teardown
+
+   // keys both maps have stay behind in the one merged from
+   void test_merge_keepsDuplicates()
+   {  // setup
+      custom::map<std::string, int> m;
+      setupStandardFixture(m);
+      custom::map<std::string, int> mRhs;
+      mRhs[std::string("50")] = 55;
+      mRhs[std::string("60")] = 60;
+      // exercise
+      m.merge(mRhs);
+      // verify
+      assertUnit(m.size() == 4);
+      assertUnit(m.at(std::string("50")) == 50);
+      assertUnit(m.at(std::string("60")) == 60);
+      assertUnit(mRhs.size() == 1);
+      assertUnit(mRhs.at(std::string("50")) == 55);
+      assertUnit(m.bst.isRedBlack());
+   }  // teardown
+
 
    /***************************************
     * SQUARE BRACKET
@@ -2329,6 +2580,207 @@ public:
       // teardown
       teardownStandardFixture(m);
    }
+   /***************************************
+    * RANGE
+    *    map::lower_bound(const K &)
+    *    map::upper_bound(const K &)
+    *    map::equal_range(const K &)
+    *    map::count_range(const K &, const K &)
+    *    map::visit_range(const K &, const K &, Visit)
+    ***************************************/
+
+   // lower_bound finds the key or the next one up
+   void test_lowerBound_standard()
+   {  // setup
+      custom::map<std::string, int> m;
+      setupStandardFixture(m);
+      // exercise
+      auto itExact = m.lower_bound(std::string("50"));
+      auto itGap   = m.lower_bound(std::string("55"));
+      auto itAfter = m.lower_bound(std::string("99"));
+      // verify
+      assertUnit(itExact.it.pNode == m.bst.root);
+      assertUnit(itGap.it.pNode == m.bst.root->pRight);
+      assertUnit(itAfter == m.end());
+      assertStandardFixture(m);
+      // teardown
+      teardownStandardFixture(m);
+   }
+
+   // upper_bound skips past an equal key
+   void test_upperBound_standard()
+   {  // setup
+      custom::map<std::string, int> m;
+      setupStandardFixture(m);
+      // exercise
+      auto itExact = m.upper_bound(std::string("30"));
+      auto itLast  = m.upper_bound(std::string("70"));
+      // verify
+      assertUnit(itExact.it.pNode == m.bst.root);
+      assertUnit(itLast == m.end());
+      assertStandardFixture(m);
+      // teardown
+      teardownStandardFixture(m);
+   }
+
+   // equal_range of a key in the map holds just that key
+   void test_equalRange_standard()
+   {  // setup
+      custom::map<std::string, int> m;
+      setupStandardFixture(m);
+      // exercise
+      auto range = m.equal_range(std::string("70"));
+      // verify
+      assertUnit(range.first.it.pNode == m.bst.root->pRight);
+      assertUnit(range.second == m.end());
+      assertStandardFixture(m);
+      // teardown
+      teardownStandardFixture(m);
+   }
+
+   // count_range includes lo but not hi
+   void test_countRange_standard()
+   {  // setup
+      custom::map<int, int> m;
+      for (int i = 0; i < 100; i++)
+         m[i] = i;
+      // exercise
+      size_t numWindow = m.count_range(10, 20);
+      size_t numEmpty = m.count_range(50, 50);
+      size_t numTail = m.count_range(95, 1000);
+      // verify
+      assertUnit(numWindow == 10);
+      assertUnit(numEmpty == 0);
+      assertUnit(numTail == 5);
+   }  // teardown
+
+   // the visitor may change the values in the range
+   void test_visitRange_standardWrite()
+   {  // setup
+      custom::map<std::string, int> m;
+      setupStandardFixture(m);
+      std::vector<std::string> visited;
+      // exercise
+      m.visit_range(std::string("40"), std::string("70"),
+         [&visited](custom::pair<std::string, int>& p)
+         {
+            visited.push_back(p.first);
+            p.second = 55;
+         });
+      // verify
+      assertUnit(visited == std::vector<std::string>({ std::string("50") }));
+      assertUnit(m.bst.root->data.second == 55);
+      m.bst.root->data.second = 50;
+      assertStandardFixture(m);
+      // teardown
+      teardownStandardFixture(m);
+   }
+
+   // for_each sees every element in order and may change the values
+   void test_forEach_standardWrite()
+   {  // setup
+      custom::map<std::string, int> m;
+      setupStandardFixture(m);
+      std::vector<std::string> visited;
+      // exercise
+      m.for_each([&visited](custom::pair<std::string, int>& p)
+         {
+            visited.push_back(p.first);
+            p.second += 1;
+         });
+      // verify
+      assertUnit(visited == std::vector<std::string>(
+         { std::string("30"), std::string("50"), std::string("70") }));
+      assertUnit(m.bst.root->pLeft->data.second == 31);
+      assertUnit(m.bst.root->data.second == 51);
+      assertUnit(m.bst.root->pRight->data.second == 71);
+      m.for_each([](custom::pair<std::string, int>& p) { p.second -= 1; });
+      assertStandardFixture(m);
+      // teardown
+      teardownStandardFixture(m);
+   }
+
+   // keys that come in order are appended at the end
+   void test_insertHint_endAscending()
+   {  // setup
+      custom::map<int, int> m;
+      // exercise
+      for (int i = 0; i < 100; i++)
+         m.insert(m.end(), custom::pair<int, int>(i, i * 2));
+      auto itDuplicate = m.insert(m.end(), custom::pair<int, int>(50, 0));
+      // verify
+      assertUnit(m.size() == 100);
+      assertUnit((*itDuplicate).first == 50);
+      assertUnit((*itDuplicate).second == 100);
+      assertUnit(m.bst.pMax->data.first == 99);
+      int expect = 0;
+      for (auto it = m.begin(); it != m.end(); ++it, ++expect)
+         if ((*it).first != expect || (*it).second != expect * 2)
+            break;
+      assertUnit(expect == 100);
+   }  // teardown
+
+   // looking up a key never builds a pair, so no value is made
+   void test_find_keyMakesNoValue()
+   {  // setup
+      custom::map<int, Spy> m;
+      for (int i = 0; i < 10; i++)
+         m.insert(custom::pair<int, Spy>(i, Spy(i)));
+      Spy::reset();
+      // exercise
+      auto itFound = m.find(7);
+      auto itMissing = m.find(10);
+      auto itLower = m.lower_bound(3);
+      size_t num = m.count_range(2, 5);
+      // verify
+      assertUnit(Spy::numDefault() == 0);
+      assertUnit(Spy::numNondefault() == 0);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numDestructor() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit((*itFound).first == 7);
+      assertUnit(itMissing == m.end());
+      assertUnit((*itLower).first == 3);
+      assertUnit(num == 3);
+   }  // teardown
+
+   // a string key can be looked up with a C string
+   void test_find_standardCString()
+   {  // setup
+      custom::map<std::string, int> m;
+      setupStandardFixture(m);
+      // exercise
+      auto itFound = m.find("70");
+      auto itMissing = m.find("60");
+      auto itLower = m.lower_bound("40");
+      // verify
+      assertUnit(itFound.it.pNode == m.bst.root->pRight);
+      assertUnit(itMissing == m.end());
+      assertUnit(itLower.it.pNode == m.bst.root);
+      assertStandardFixture(m);
+      // teardown
+      teardownStandardFixture(m);
+   }
+
+#if __cplusplus >= 201703L
+   // a string key can be looked up with a string_view
+   void test_find_standardStringView()
+   {  // setup
+      custom::map<std::string, int> m;
+      setupStandardFixture(m);
+      std::string_view sv("30");
+      // exercise
+      auto itFound = m.find(sv);
+      size_t num = m.count_range(std::string_view("30"), std::string_view("70"));
+      // verify
+      assertUnit(itFound.it.pNode == m.bst.root->pLeft);
+      assertUnit(num == 2);
+      assertStandardFixture(m);
+      // teardown
+      teardownStandardFixture(m);
+   }
+#endif
+
    /****************************************************************
     * Setup Standard Fixture
     *    "30"     "50"     "70"
@@ -0,0 +1,240 @@
+/***********************************************************************
+ * Header:
+ *    TEST MULTI MAP
+ * Summary:
+ *    Unit tests for multiset and multimap
+ * Author
+ *    Gabe Lytle, M. Scott O'Connor
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "multiMap.h"
+#include "unitTest.h"
+
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+class TestMultiMap : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Set
+      test_set_construct_default();
+      test_set_construct_sortedKeepsDuplicates();
+      test_set_construct_singlePass();
+      test_set_insert_duplicates();
+      test_set_count_standard();
+      test_set_equalRange_missing();
+      test_set_erase_keyTakesAll();
+
+      // Map
+      test_map_insert_keepsOrder();
+      test_map_equalRange_write();
+      test_map_find_first();
+      test_map_erase_iterator();
+      test_map_extract_moveKey();
+
+      report("MultiMap");
+   }
+
+   /***************************************
+    * SET
+    ***************************************/
+
+   // an empty multiset finds nothing
+   void test_set_construct_default()
+   {  // setup
+      // exercise
+      custom::multiset <int> s;
+      // verify
+      assertUnit(s.empty());
+      assertUnit(s.size() == 0);
+      assertUnit(s.begin() == s.end());
+      assertUnit(s.count(11) == 0);
+   }  // teardown
+
+   // sorted input is built in one pass, duplicates and all
+   void test_set_construct_sortedKeepsDuplicates()
+   {  // setup
+      std::vector <int> v{ 11, 26, 26, 26, 31, 31 };
+      // exercise
+      custom::multiset <int> s(v.begin(), v.end());
+      // verify
+      assertUnit(contents(s) == v);
+      assertUnit(s.size() == 6);
+      assertUnit(s.bst.isRedBlack());
+   }  // teardown
+
+   // a range that can only be read once still gives every value
+   void test_set_construct_singlePass()
+   {  // setup
+      std::istringstream in("1 2 2 3 5");
+      std::istream_iterator <int> itEnd;
+      // exercise
+      custom::multiset <int> s(std::istream_iterator <int>(in), itEnd);
+      // verify
+      assertUnit(contents(s) == std::vector <int>({ 1, 2, 2, 3, 5 }));
+      assertUnit(s.size() == 5);
+      assertUnit(s.bst.isRedBlack());
+   }  // teardown
+
+   // every insert goes in, whether or not its value is there already
+   void test_set_insert_duplicates()
+   {  // setup
+      custom::multiset <int> s;
+      // exercise
+      for (int value : { 50, 30, 50, 70, 30, 50 })
+         s.insert(value);
+      // verify
+      assertUnit(contents(s) == std::vector <int>({ 30, 30, 50, 50, 50, 70 }));
+      assertUnit(s.bst.isRedBlack());
+   }  // teardown
+
+   // count walks the run of equal values and nothing else
+   void test_set_count_standard()
+   {  // setup
+      custom::multiset <int> s;
+      for (int i = 0; i < 100; i++)
+         s.insert(i % 10);
+      // exercise
+      size_t numSeven = s.count(7);
+      size_t numMissing = s.count(10);
+      // verify
+      assertUnit(numSeven == 10);
+      assertUnit(numMissing == 0);
+      assertUnit(s.size() == 100);
+      assertUnit(s.bst.isRedBlack());
+   }  // teardown
+
+   // a missing value gives an empty range where it would go
+   void test_set_equalRange_missing()
+   {  // setup
+      custom::multiset <int> s{ 11, 31, 31 };
+      // exercise
+      auto range = s.equal_range(26);
+      // verify
+      assertUnit(range.first == range.second);
+      assertUnit(range.first != s.end() && *range.first == 31);
+   }  // teardown
+
+   // erasing a value erases all of it
+   void test_set_erase_keyTakesAll()
+   {  // setup
+      custom::multiset <int> s{ 11, 26, 26, 26, 31 };
+      // exercise
+      size_t num = s.erase(26);
+      size_t numMissing = s.erase(26);
+      // verify
+      assertUnit(num == 3);
+      assertUnit(numMissing == 0);
+      assertUnit(contents(s) == std::vector <int>({ 11, 31 }));
+      assertUnit(s.bst.isRedBlack());
+   }  // teardown
+
+   /***************************************
+    * MAP
+    ***************************************/
+
+   // values under one key stay in the order they came in
+   void test_map_insert_keepsOrder()
+   {  // setup
+      custom::multimap <std::string, int> m;
+      // exercise
+      for (int i = 0; i < 20; i++)
+         m.insert(custom::pair <std::string, int>(i % 2 ? "odd" : "even", i));
+      // verify
+      std::vector <int> odd;
+      auto range = m.equal_range(std::string("odd"));
+      for (auto it = range.first; it != range.second; ++it)
+         odd.push_back((*it).second);
+      assertUnit(odd == std::vector <int>({ 1, 3, 5, 7, 9, 11, 13, 15, 17, 19 }));
+      assertUnit(m.count(std::string("even")) == 10);
+      assertUnit(m.size() == 20);
+      assertUnit(m.bst.isRedBlack());
+   }  // teardown
+
+   // the values in a range can be changed in place
+   void test_map_equalRange_write()
+   {  // setup
+      custom::multimap <int, int> m{ {11, 1}, {26, 2}, {26, 3}, {31, 4} };
+      // exercise
+      auto range = m.equal_range(26);
+      for (auto it = range.first; it != range.second; ++it)
+         (*it).second *= 10;
+      // verify
+      std::vector <int> values;
+      for (auto it = m.begin(); it != m.end(); ++it)
+         values.push_back((*it).second);
+      assertUnit(values == std::vector <int>({ 1, 20, 30, 4 }));
+   }  // teardown
+
+   // find gives the first of the equal keys, or end()
+   void test_map_find_first()
+   {  // setup
+      custom::multimap <int, int> m;
+      for (int i = 0; i < 5; i++)
+         m.insert(custom::pair <int, int>(26, i));
+      m.insert(custom::pair <int, int>(11, 0));
+      // exercise
+      auto it = m.find(26);
+      auto itMissing = m.find(31);
+      // verify
+      assertUnit(it != m.end() && (*it).second == 0);
+      assertUnit(it == m.lower_bound(26));
+      assertUnit(itMissing == m.end());
+   }  // teardown
+
+   // erasing by iterator takes just that one element
+   void test_map_erase_iterator()
+   {  // setup
+      custom::multimap <int, int> m{ {26, 1}, {26, 2}, {26, 3} };
+      auto it = m.find(26);
+      ++it;
+      // exercise
+      auto itNext = m.erase(it);
+      // verify
+      assertUnit(itNext != m.end() && (*itNext).second == 3);
+      assertUnit(m.count(26) == 2);
+      assertUnit((*m.begin()).second == 1);
+   }  // teardown
+
+   // a node moves under another key without being built again
+   void test_map_extract_moveKey()
+   {  // setup
+      custom::multimap <int, int> m{ {11, 1}, {26, 2}, {26, 3} };
+      // exercise
+      auto nh = m.extract(11);
+      nh.key() = 26;
+      auto it = m.insert(std::move(nh));
+      // verify
+      assertUnit(nh.empty());
+      assertUnit((*it).second == 1);
+      assertUnit(m.count(26) == 3);
+      assertUnit(m.count(11) == 0);
+      std::vector <int> values;
+      for (auto itValue = m.find(26); itValue != m.end(); ++itValue)
+         values.push_back((*itValue).second);
+      assertUnit(values == std::vector <int>({ 2, 3, 1 }));
+   }  // teardown
+
+private:
+   // the values in order
+   template <class T>
+   std::vector <T> contents(const custom::multiset <T>& s)
+   {
+      std::vector <T> v;
+      for (auto it = s.begin(); it != s.end(); ++it)
+         v.push_back(*it);
+      return v;
+   }
+};
+
+#endif // DEBUG
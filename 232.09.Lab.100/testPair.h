@@ -67,6 +67,10 @@ public:
       test_equivalence_same();
       test_equivalence_firstSmaller();
       test_equivalence_firstLarger();
+      test_equivalence_statefulCompare();
+
+      // Size
+      test_size_noComparator();
       
       // Swap
       test_swap_defaultToDefault();
@@ -631,6 +635,39 @@ public:
    }  // teardown
    
 
+   // a comparator with state is kept in the pair and used
+   void test_equivalence_statefulCompare()
+   {  // setup
+      struct Modulo
+      {
+         int base;
+         bool operator () (int lhs, int rhs) const { return lhs % base < rhs % base; }
+      };
+      custom::pair <int, int, Modulo> pLeft(19, 0, Modulo{ 10 });
+      custom::pair <int, int, Modulo> pRight(21, 0, Modulo{ 10 });
+      // exercise
+      bool lessthan    = (pLeft <  pRight);
+      bool greaterthan = (pLeft >  pRight);
+      // verify
+      assertUnit(lessthan    == false);
+      assertUnit(greaterthan == true);
+   }  // teardown
+
+   /***************************************
+    * SIZE
+    ***************************************/
+
+   // std::less takes no room, so a map entry is just its two values
+   void test_size_noComparator()
+   {  // setup
+      // exercise
+      size_t sizeInts = sizeof(custom::pair <int, int>);
+      size_t sizeLongs = sizeof(custom::pair <long, long>);
+      // verify
+      assertUnit(sizeInts == 2 * sizeof(int));
+      assertUnit(sizeLongs == 2 * sizeof(long));
+   }  // teardown
+
    /***************************************
     * SWAP
     * swap two elements
@@ -0,0 +1,438 @@
+/***********************************************************************
+ * Header:
+ *    TEST PERSISTENT
+ * Summary:
+ *    Unit tests for persistent_set, persistent_map, and published
+ * Author
+ *    Gabe Lytle, M. Scott O'Connor
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "persistent.h"
+#include "unitTest.h"
+#include "spy.h"
+
+#include <atomic>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+class TestPersistent : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Set
+      test_construct_default();
+      test_insert_standard();
+      test_insert_duplicate();
+      test_insert_many();
+      test_constructCopy_shares();
+      test_snapshot_unchangedByInsert();
+      test_insert_copiesPath();
+      test_erase_standard();
+      test_erase_missing();
+      test_erase_many();
+      test_lowerBound_standard();
+      test_release_everything();
+
+      // Map
+      test_map_insertOrAssign();
+      test_map_at();
+
+      // Published
+      test_published_readersSeeWholeVersions();
+
+      report("Persistent");
+   }
+
+   /***************************************
+    * SET
+    ***************************************/
+
+   // an empty set has no nodes at all
+   void test_construct_default()
+   {  // setup
+      // exercise
+      custom::persistent_set <int> s;
+      // verify
+      assertUnit(s.empty());
+      assertUnit(s.root == nullptr);
+      assertUnit(s.begin() == s.end());
+   }  // teardown
+
+   // the third insert rotates the new one to the top
+   //                 26
+   //           11          31
+   void test_insert_standard()
+   {  // setup
+      custom::persistent_set <int> s;
+      // exercise
+      s.insert(31);
+      s.insert(11);
+      s.insert(26);
+      // verify
+      assertUnit(s.size() == 3);
+      assertUnit(s.root != nullptr);
+      if (s.root == nullptr)
+         return;
+      assertUnit(s.root->data == 26);
+      assertUnit(s.root->height == 2);
+      assertUnit(s.root->pLeft && s.root->pLeft->data == 11);
+      assertUnit(s.root->pRight && s.root->pRight->data == 31);
+      assertUnit(isValid(s));
+   }  // teardown
+
+   // inserting a value already there builds nothing
+   void test_insert_duplicate()
+   {  // setup
+      custom::persistent_set <int> s{ 11, 26, 31 };
+      auto pRoot = s.root;
+      // exercise
+      bool isInserted = s.insert(26);
+      // verify
+      assertUnit(!isInserted);
+      assertUnit(s.size() == 3);
+      assertUnit(s.root == pRoot);
+   }  // teardown
+
+   // values in increasing order still make a shallow tree
+   void test_insert_many()
+   {  // setup
+      custom::persistent_set <int> s;
+      // exercise
+      for (int i = 0; i < 1000; i++)
+         s.insert(i);
+      // verify
+      assertUnit(s.size() == 1000);
+      assertUnit(isValid(s));
+      assertUnit(s.root->height <= 14);   // 1.44 log2(1000)
+      int expect = 0;
+      for (auto it = s.begin(); it != s.end(); ++it, ++expect)
+         if (*it != expect)
+            break;
+      assertUnit(expect == 1000);
+   }  // teardown
+
+   // a copy is the same tree, counted twice, with nothing copied
+   void test_constructCopy_shares()
+   {  // setup
+      custom::persistent_set <Spy> s{ Spy(11), Spy(26), Spy(31) };
+      Spy::reset();
+      // exercise
+      custom::persistent_set <Spy> sCopy(s);
+      // verify
+      assertUnit(sCopy.root == s.root);
+      assertUnit(s.root->numRefs == 2);
+      assertUnit(s.root->pLeft->numRefs == 1);
+      assertUnit(sCopy.size() == 3);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+   }  // teardown
+
+   // a snapshot keeps what it had while the original moves on
+   void test_snapshot_unchangedByInsert()
+   {  // setup
+      custom::persistent_set <int> s{ 11, 26, 31 };
+      // exercise
+      custom::persistent_set <int> sOld = s.snapshot();
+      s.insert(50);
+      s.erase(11);
+      // verify
+      assertUnit(sOld.size() == 3);
+      assertUnit(contents(sOld) == std::vector <int>({ 11, 26, 31 }));
+      assertUnit(s.size() == 3);
+      assertUnit(contents(s) == std::vector <int>({ 26, 31, 50 }));
+      assertUnit(isValid(sOld));
+      assertUnit(isValid(s));
+   }  // teardown
+
+   // an insert copies the path down to it and shares the rest
+   void test_insert_copiesPath()
+   {  // setup
+      custom::persistent_set <Spy> s;
+      for (int i = 0; i < 1000; i++)
+         s.insert(Spy((i * 7919) % 1000 * 2));
+      custom::persistent_set <Spy> sOld = s.snapshot();
+      int height = s.root->height;
+      Spy::reset();
+      // exercise
+      s.insert(Spy(501));
+      // verify
+      int numNew = 0;
+      std::set <const void*> old = nodes(sOld);
+      for (auto pNode : nodes(s))
+         numNew += (old.count(pNode) == 0);
+      assertUnit(numNew <= height + 3);
+      assertUnit(Spy::numCopy() <= height + 3);
+      assertUnit(s.size() == 1001);
+      assertUnit(sOld.size() == 1000);
+      assertUnit(isValid(s));
+      assertUnit(isValid(sOld));
+   }  // teardown
+
+   // erase a leaf, then a node with two children
+   void test_erase_standard()
+   {  // setup
+      custom::persistent_set <int> s{ 11, 26, 31, 50 };
+      custom::persistent_set <int> sOld(s);
+      // exercise
+      size_t num50 = s.erase(50);
+      size_t num26 = s.erase(26);
+      // verify
+      assertUnit(num50 == 1);
+      assertUnit(num26 == 1);
+      assertUnit(contents(s) == std::vector <int>({ 11, 31 }));
+      assertUnit(contents(sOld) == std::vector <int>({ 11, 26, 31, 50 }));
+      assertUnit(isValid(s));
+   }  // teardown
+
+   // erasing what is not there builds nothing
+   void test_erase_missing()
+   {  // setup
+      custom::persistent_set <int> s{ 11, 26, 31 };
+      auto pRoot = s.root;
+      // exercise
+      size_t num = s.erase(12);
+      // verify
+      assertUnit(num == 0);
+      assertUnit(s.size() == 3);
+      assertUnit(s.root == pRoot);
+   }  // teardown
+
+   // erase half of a big tree, keeping a snapshot of every step
+   void test_erase_many()
+   {  // setup
+      custom::persistent_set <int> s;
+      for (int i = 0; i < 2000; i++)
+         s.insert((i * 7919) % 2000);
+      std::vector <custom::persistent_set <int>> versions;
+      // exercise
+      for (int i = 0; i < 2000; i += 2)
+      {
+         versions.push_back(s.snapshot());
+         s.erase((i * 7919) % 2000);
+      }
+      // verify
+      assertUnit(s.size() == 1000);
+      assertUnit(isValid(s));
+      assertUnit(versions.front().size() == 2000);
+      assertUnit(versions.back().size() == 1001);
+      assertUnit(isValid(versions.front()));
+      assertUnit(isValid(versions[500]));
+   }  // teardown
+
+   // lower_bound and upper_bound start in the middle and go on in order
+   void test_lowerBound_standard()
+   {  // setup
+      custom::persistent_set <int> s;
+      for (int i = 0; i < 100; i += 10)
+         s.insert(i);
+      // exercise
+      auto itLower = s.lower_bound(30);
+      auto itUpper = s.upper_bound(30);
+      auto itBetween = s.lower_bound(35);
+      // verify
+      assertUnit(itLower != s.end() && *itLower == 30);
+      assertUnit(itUpper != s.end() && *itUpper == 40);
+      assertUnit(itBetween != s.end() && *itBetween == 40);
+      ++itBetween;
+      assertUnit(itBetween != s.end() && *itBetween == 50);
+      assertUnit(s.lower_bound(91) == s.end());
+      assertUnit(s.find(30) == itLower);
+      assertUnit(s.find(35) == s.end());
+      assertUnit(s.search(30) != nullptr && *s.search(30) == 30);
+      assertUnit(s.search(35) == nullptr);
+   }  // teardown
+
+   // every node of every version is freed once the last one goes
+   void test_release_everything()
+   {  // setup
+      Spy::reset();
+      {
+         custom::persistent_set <Spy> s;
+         std::vector <custom::persistent_set <Spy>> versions;
+         // exercise
+         for (int i = 0; i < 200; i++)
+         {
+            s.insert(Spy((i * 37) % 200));
+            if (i % 3 == 0)
+               versions.push_back(s.snapshot());
+         }
+         for (int i = 0; i < 200; i += 3)
+            s.erase(Spy(i));
+      }
+      // verify
+      assertUnit(Spy::numAlloc() > 0);
+      assertUnit(Spy::numAlloc() == Spy::numDelete());
+   }  // teardown
+
+   /***************************************
+    * MAP
+    ***************************************/
+
+   // insert_or_assign changes the value in the new version only
+   void test_map_insertOrAssign()
+   {  // setup
+      custom::persistent_map <std::string, int> m;
+      m.insert_or_assign("eleven", 11);
+      m.insert_or_assign("twenty-six", 26);
+      custom::persistent_map <std::string, int> mOld = m.snapshot();
+      // exercise
+      bool isNew = m.insert_or_assign("eleven", 111);
+      // verify
+      assertUnit(!isNew);
+      assertUnit(m.size() == 2);
+      assertUnit(m.at("eleven") == 111);
+      assertUnit(mOld.at("eleven") == 11);
+      assertUnit(m.at("twenty-six") == 26);
+      assertUnit(m.root->pRight == mOld.root->pRight ||
+                 m.root->pLeft == mOld.root->pLeft);
+   }  // teardown
+
+   // at() throws for a missing key
+   void test_map_at()
+   {  // setup
+      custom::persistent_map <int, int> m{ custom::pair <int, int>(11, 110) };
+      bool thrown = false;
+      // exercise
+      int value = m.at(11);
+      try
+      {
+         m.at(26);
+      }
+      catch (const std::out_of_range& error)
+      {
+         thrown = true;
+      }
+      // verify
+      assertUnit(value == 110);
+      assertUnit(thrown);
+   }  // teardown
+
+   /***************************************
+    * PUBLISHED
+    ***************************************/
+
+   // readers only ever see a version the writer stored: while the
+   // writer adds 0, 1, 2, ... each version holds 0 through size - 1
+   void test_published_readersSeeWholeVersions()
+   {  // setup
+      typedef custom::persistent_set <int> Set;
+      custom::published <Set> latest;
+      std::atomic <bool> isDone(false);
+      std::atomic <int> numTorn(0);
+      auto read = [&]()
+      {
+         while (!isDone.load())
+         {
+            Set s = latest.load();
+            long long sum = 0;
+            for (auto it = s.begin(); it != s.end(); ++it)
+               sum += *it;
+            long long num = (long long)s.size();
+            if (sum != num * (num - 1) / 2)
+               numTorn++;
+         }
+      };
+      // exercise
+      std::thread reader1(read);
+      std::thread reader2(read);
+      Set s;
+      for (int i = 0; i < 2000; i++)
+      {
+         s.insert(i);
+         latest.store(s);
+      }
+      isDone = true;
+      reader1.join();
+      reader2.join();
+      // verify
+      assertUnit(numTorn == 0);
+      assertUnit(latest.load().size() == 2000);
+      assertUnit(latest.latest.root == s.root);
+   }  // teardown
+
+   /*************************************************************
+    * CONTENTS
+    * The values of a tree in order
+    *************************************************************/
+   template <class Tree>
+   std::vector <int> contents(const Tree& tree)
+   {
+      std::vector <int> v;
+      for (auto it = tree.begin(); it != tree.end(); ++it)
+         v.push_back(*it);
+      return v;
+   }
+
+   /*************************************************************
+    * NODES
+    * The address of every node in a tree
+    *************************************************************/
+   template <class Tree>
+   std::set <const void*> nodes(const Tree& tree)
+   {
+      std::set <const void*> found;
+      std::vector <decltype(tree.root)> pending;
+      if (tree.root)
+         pending.push_back(tree.root);
+      while (!pending.empty())
+      {
+         auto pNode = pending.back();
+         pending.pop_back();
+         found.insert(pNode);
+         if (pNode->pLeft)
+            pending.push_back(pNode->pLeft);
+         if (pNode->pRight)
+            pending.push_back(pNode->pRight);
+      }
+      return found;
+   }
+
+   /*************************************************************
+    * IS VALID
+    * Every height is right, no two siblings differ by more than
+    * one level, the values are in order, and the size matches
+    *************************************************************/
+   template <class Tree>
+   bool isValid(const Tree& tree)
+   {
+      size_t num = 0;
+      return checkNode(tree.root, num) >= 0 && num == tree.size() && isSorted(tree);
+   }
+   template <class Node>
+   int checkNode(const Node* pNode, size_t& num)
+   {
+      if (pNode == nullptr)
+         return 0;
+      num++;
+      int heightLeft = checkNode(pNode->pLeft, num);
+      int heightRight = checkNode(pNode->pRight, num);
+      if (heightLeft < 0 || heightRight < 0 ||
+          heightLeft > heightRight + 1 || heightRight > heightLeft + 1)
+         return -1;
+      int height = 1 + (heightLeft > heightRight ? heightLeft : heightRight);
+      return height == pNode->height && pNode->numRefs > 0 ? height : -1;
+   }
+   template <class Tree>
+   bool isSorted(const Tree& tree)
+   {
+      auto it = tree.begin();
+      if (it == tree.end())
+         return true;
+      for (auto itPrev = it++; it != tree.end(); itPrev = it++)
+         if (!(*itPrev < *it))
+            return false;
+      return true;
+   }
+};
+
+#endif // DEBUG
@@ -0,0 +1,380 @@
+/***********************************************************************
+ * Header:
+ *    TEST SKIP LIST
+ * Summary:
+ *    Unit tests for skiplist_set, skiplist_map, and
+ *    concurrent_skiplist_set
+ * Author
+ *    Gabe Lytle, M. Scott O'Connor
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "skipList.h"
+#include "unitTest.h"
+#include "spy.h"
+
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+class TestSkipList : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Set
+      test_construct_default();
+      test_insert_sorted();
+      test_insert_duplicate();
+      test_insert_many();
+      test_find_standard();
+      test_lowerBound_standard();
+      test_upperBound_standard();
+      test_erase_standard();
+      test_eraseIterator_standard();
+      test_constructCopy_standard();
+      test_clear_standard();
+
+      // Map
+      test_map_squareBracket();
+      test_map_at();
+      test_map_squareBracketSpy();
+
+      // Concurrent
+      test_concurrent_readersAndWriter();
+
+      report("SkipList");
+   }
+
+   /***************************************
+    * SET
+    ***************************************/
+
+   // an empty set has nothing on any level
+   void test_construct_default()
+   {  // setup
+      // exercise
+      custom::skiplist_set <int> s;
+      // verify
+      assertUnit(s.empty());
+      assertUnit(s.numLevels == 1);
+      assertUnit(s.head[0].load() == nullptr);
+      assertUnit(s.begin() == s.end());
+   }  // teardown
+
+   // values come out in order no matter how they went in
+   void test_insert_sorted()
+   {  // setup
+      custom::skiplist_set <int> s;
+      // exercise
+      s.insert(31);
+      s.insert(11);
+      s.insert(26);
+      // verify
+      assertStandardFixture(s);
+   }  // teardown
+
+   // inserting a value already there changes nothing
+   void test_insert_duplicate()
+   {  // setup
+      custom::skiplist_set <int> s{ 11, 26, 31 };
+      // exercise
+      auto result = s.insert(26);
+      // verify
+      assertUnit(result.second == false);
+      assertUnit(*result.first == 26);
+      assertStandardFixture(s);
+   }  // teardown
+
+   // every level stays sorted and is a subset of the level below
+   void test_insert_many()
+   {  // setup
+      custom::skiplist_set <int> s;
+      // exercise
+      for (int i = 0; i < 2000; i++)
+         s.insert((i * 7919) % 2000);
+      // verify
+      assertUnit(s.size() == 2000);
+      assertUnit(s.numLevels > 1);
+      assertUnit(isConsistent(s));
+      int expect = 0;
+      for (auto it = s.begin(); it != s.end(); ++it, ++expect)
+         if (*it != expect)
+            break;
+      assertUnit(expect == 2000);
+   }  // teardown
+
+   // find what is there and only what is there
+   void test_find_standard()
+   {  // setup
+      custom::skiplist_set <int> s{ 11, 26, 31 };
+      // exercise
+      auto it26 = s.find(26);
+      auto it27 = s.find(27);
+      // verify
+      assertUnit(it26 != s.end() && *it26 == 26);
+      assertUnit(it27 == s.end());
+      assertUnit(s.contains(11));
+      assertUnit(!s.contains(99));
+   }  // teardown
+
+   // lower_bound is the first value not less than the key
+   void test_lowerBound_standard()
+   {  // setup
+      custom::skiplist_set <int> s{ 11, 26, 31 };
+      // exercise
+      auto itBefore = s.lower_bound(5);
+      auto itExact  = s.lower_bound(26);
+      auto itGap    = s.lower_bound(27);
+      auto itAfter  = s.lower_bound(32);
+      // verify
+      assertUnit(*itBefore == 11);
+      assertUnit(*itExact == 26);
+      assertUnit(*itGap == 31);
+      assertUnit(itAfter == s.end());
+   }  // teardown
+
+   // upper_bound is the first value greater than the key
+   void test_upperBound_standard()
+   {  // setup
+      custom::skiplist_set <int> s{ 11, 26, 31 };
+      // exercise
+      auto itBefore = s.upper_bound(5);
+      auto itExact  = s.upper_bound(26);
+      auto itLast   = s.upper_bound(31);
+      // verify
+      assertUnit(*itBefore == 11);
+      assertUnit(*itExact == 31);
+      assertUnit(itLast == s.end());
+   }  // teardown
+
+   // erase by key
+   void test_erase_standard()
+   {  // setup
+      custom::skiplist_set <int> s{ 11, 26, 99, 31 };
+      // exercise
+      size_t numErased = s.erase(99);
+      size_t numMissing = s.erase(42);
+      // verify
+      assertUnit(numErased == 1);
+      assertUnit(numMissing == 0);
+      assertStandardFixture(s);
+   }  // teardown
+
+   // erase by iterator returns the next one
+   void test_eraseIterator_standard()
+   {  // setup
+      custom::skiplist_set <int> s{ 11, 26, 28, 31 };
+      auto it = s.find(28);
+      // exercise
+      auto itNext = s.erase(it);
+      // verify
+      assertUnit(*itNext == 31);
+      assertStandardFixture(s);
+   }  // teardown
+
+   // a copy keeps the same tower heights and is independent
+   void test_constructCopy_standard()
+   {  // setup
+      custom::skiplist_set <int> sSrc;
+      for (int i = 0; i < 500; i++)
+         sSrc.insert(i);
+      // exercise
+      custom::skiplist_set <int> sDes(sSrc);
+      // verify
+      assertUnit(sDes.size() == 500);
+      assertUnit(sDes.numLevels == sSrc.numLevels);
+      assertUnit(isConsistent(sDes));
+      bool same = true;
+      auto itSrc = sSrc.begin();
+      for (auto itDes = sDes.begin(); itDes != sDes.end(); ++itDes, ++itSrc)
+         same = same && *itDes == *itSrc && itDes.pNode != itSrc.pNode
+                     && itDes.pNode->height == itSrc.pNode->height;
+      assertUnit(same);
+   }  // teardown
+
+   // clear frees every node
+   void test_clear_standard()
+   {  // setup
+      custom::skiplist_set <Spy> s;
+      s.insert(Spy(11));
+      s.insert(Spy(26));
+      s.insert(Spy(31));
+      Spy::reset();
+      // exercise
+      s.clear();
+      // verify
+      assertUnit(Spy::numDestructor() == 3);
+      assertUnit(s.empty());
+      assertUnit(s.head[0].load() == nullptr);
+      assertUnit(s.numLevels == 1);
+   }  // teardown
+
+   /***************************************
+    * MAP
+    ***************************************/
+
+   // operator [] adds missing keys and finds existing ones
+   void test_map_squareBracket()
+   {  // setup
+      custom::skiplist_map <std::string, int> m;
+      // exercise
+      m["twenty-six"] = 26;
+      m["eleven"] = 11;
+      m["twenty-six"] += 1;
+      // verify
+      assertUnit(m.size() == 2);
+      assertUnit(m["eleven"] == 11);
+      assertUnit(m["twenty-six"] == 27);
+      assertUnit(m.begin()->first == std::string("eleven"));
+      assertUnit(m.lower_bound("f")->first == std::string("twenty-six"));
+   }  // teardown
+
+   // at() throws for a missing key
+   void test_map_at()
+   {  // setup
+      custom::skiplist_map <int, int> m{ custom::pair <int, int>(11, 110) };
+      bool thrown = false;
+      // exercise
+      int value = m.at(11);
+      try
+      {
+         m.at(26);
+      }
+      catch (const std::out_of_range&)
+      {
+         thrown = true;
+      }
+      // verify
+      assertUnit(value == 110);
+      assertUnit(thrown);
+   }  // teardown
+
+   // looking up an existing key builds nothing
+   void test_map_squareBracketSpy()
+   {  // setup
+      custom::skiplist_map <int, Spy> m;
+      m[11] = Spy(110);
+      Spy::reset();
+      // exercise
+      Spy& s = m[11];
+      // verify
+      assertUnit(s == Spy(110));
+      assertUnit(Spy::numDefault() == 0);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+   }  // teardown
+
+   /***************************************
+    * CONCURRENT
+    ***************************************/
+
+   // readers never lock and always see a sorted list while a writer
+   // inserts and erases
+   void test_concurrent_readersAndWriter()
+   {  // setup
+      custom::concurrent_skiplist_set <int> s;
+      for (int i = 0; i < 1000; i += 2)
+         s.insert(i);           // the evens are always there
+      std::atomic <bool> done(false);
+      std::atomic <bool> allFound(true);
+      std::atomic <bool> allSorted(true);
+      std::vector <std::thread> readers;
+      // exercise
+      for (int r = 0; r < 3; r++)
+         readers.emplace_back([&]()
+         {
+            while (!done)
+            {
+               for (int i = 0; i < 1000; i += 2)
+                  if (!s.contains(i) || *s.lower_bound(i) != i)
+                     allFound = false;
+               int prev = -1;
+               for (auto it = s.begin(); it != s.end(); ++it)
+               {
+                  if (*it <= prev)
+                     allSorted = false;
+                  prev = *it;
+               }
+            }
+         });
+      for (int round = 0; round < 20; round++)
+      {
+         for (int i = 1; i < 1000; i += 2)
+            s.insert(i);
+         for (int i = 1; i < 1000; i += 2)
+            s.erase(i);
+      }
+      done = true;
+      for (auto & t : readers)
+         t.join();
+      s.reclaim();
+      // verify
+      assertUnit(allFound);
+      assertUnit(allSorted);
+      assertUnit(s.size() == 500);
+      assertUnit(s.retired.empty());
+   }  // teardown
+
+   /****************************************************************
+    * IS CONSISTENT
+    * Every level is sorted and every node on it is also on the
+    * level below
+    ****************************************************************/
+   template <class Set>
+   bool isConsistent(const Set& s)
+   {
+      for (int level = 1; level < s.numLevels; level++)
+      {
+         auto pBelow = s.head[level - 1].load();
+         for (auto p = s.head[level].load(); p; p = p->links()[level].load())
+         {
+            while (pBelow && pBelow != p)
+               pBelow = pBelow->links()[level - 1].load();
+            if (pBelow == nullptr || p->height <= level)
+               return false;
+            auto pNext = p->links()[level].load();
+            if (pNext && !(p->data < pNext->data))
+               return false;
+         }
+      }
+      return true;
+   }
+
+   /****************************************************************
+    * Verify Standard Fixture
+    *       +----+   +----+   +----+
+    *       | 11 | - | 26 | - | 31 |
+    *       +----+   +----+   +----+
+    ****************************************************************/
+   void assertStandardFixtureParameters(const custom::skiplist_set <int>& s, int line, const char* function)
+   {
+      assertIndirect(s.size() == 3);
+      auto p11 = s.head[0].load();
+      assertIndirect(p11 != nullptr);
+      if (p11 == nullptr)
+         return;
+      auto p26 = p11->links()[0].load();
+      assertIndirect(p11->data == 11);
+      assertIndirect(p26 != nullptr);
+      if (p26 == nullptr)
+         return;
+      auto p31 = p26->links()[0].load();
+      assertIndirect(p26->data == 26);
+      assertIndirect(p31 != nullptr);
+      if (p31 == nullptr)
+         return;
+      assertIndirect(p31->data == 31);
+      assertIndirect(p31->links()[0].load() == nullptr);
+      assertIndirect(isConsistent(s));
+   }
+};
+
+#endif // DEBUG
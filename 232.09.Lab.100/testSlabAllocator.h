@@ -0,0 +1,363 @@
+/***********************************************************************
+ * Header:
+ *    TEST SLAB ALLOCATOR
+ * Summary:
+ *    Unit tests for slab_allocator and for BST and map using it
+ * Author
+ *    Gabe Lytle, M. Scott O'Connor
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "slabAllocator.h"
+#include "bst.h"
+#include "map.h"
+#include "unitTest.h"
+#include "spy.h"
+
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+class TestSlabAllocator : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Allocator
+      test_allocate_contiguous();
+      test_deallocate_reuse();
+      test_allocate_grow();
+      test_release_shared();
+      test_rebind_sharesPool();
+
+      // BST
+      test_bst_insertClear();
+      test_bst_clearSpy();
+      test_bst_sortedContiguous();
+      test_bst_copyOwnPool();
+      test_bst_swap();
+      test_bst_extractKeepsPool();
+      test_bst_mergeOtherPool();
+      test_bst_moveAssignStays();
+
+      // Map
+      test_map_squareBracket();
+      test_map_mergeSamePool();
+
+      report("SlabAllocator");
+   }
+
+   /***************************************
+    * ALLOCATOR
+    ***************************************/
+
+   // one allocation after another comes from the same slab, side by side
+   void test_allocate_contiguous()
+   {  // setup
+      custom::slab_allocator<double> alloc;
+      // exercise
+      double* p1 = alloc.allocate(1);
+      double* p2 = alloc.allocate(1);
+      double* p3 = alloc.allocate(1);
+      // verify
+      assertUnit(p2 == p1 + 1);
+      assertUnit(p3 == p2 + 1);
+      assertUnit(alloc.capacity() == 32);
+      assertUnit(alloc.pSlabs->slabs.size() == 1);
+      // teardown
+      alloc.deallocate(p1, 1);
+      alloc.deallocate(p2, 1);
+      alloc.deallocate(p3, 1);
+   }
+
+   // a freed slot is the next one handed out
+   void test_deallocate_reuse()
+   {  // setup
+      custom::slab_allocator<double> alloc;
+      double* p1 = alloc.allocate(1);
+      double* p2 = alloc.allocate(1);
+      // exercise
+      alloc.deallocate(p1, 1);
+      double* p3 = alloc.allocate(1);
+      // verify
+      assertUnit(p3 == p1);
+      assertUnit(alloc.capacity() == 32);
+      // teardown
+      alloc.deallocate(p2, 1);
+      alloc.deallocate(p3, 1);
+   }
+
+   // running out of a slab adds one twice the size of what we have
+   void test_allocate_grow()
+   {  // setup
+      custom::slab_allocator<int> alloc;
+      std::vector<int*> v;
+      // exercise
+      for (int i = 0; i < 33; i++)
+         v.push_back(alloc.allocate(1));
+      // verify
+      assertUnit(alloc.capacity() == 64);
+      assertUnit(alloc.pSlabs->slabs.size() == 2);
+      // teardown
+      for (auto p : v)
+         alloc.deallocate(p, 1);
+   }
+
+   // slabs are not released while another allocator shares the pool
+   void test_release_shared()
+   {  // setup
+      custom::slab_allocator<int> alloc;
+      alloc.deallocate(alloc.allocate(1), 1);
+      bool releasedShared;
+      // exercise
+      {
+         custom::slab_allocator<int> allocCopy(alloc);
+         releasedShared = alloc.release();
+      }
+      bool releasedAlone = alloc.release();
+      // verify
+      assertUnit(releasedShared == false);
+      assertUnit(releasedAlone == true);
+      assertUnit(alloc.capacity() == 0);
+      assertUnit(alloc.pSlabs->slabs.empty());
+   }  // teardown
+
+   // an allocator rebound to another type and back is the same allocator
+   void test_rebind_sharesPool()
+   {  // setup
+      custom::slab_allocator<int> alloc;
+      // exercise
+      custom::slab_allocator<std::string> allocString(alloc);
+      custom::slab_allocator<int> allocBack(allocString);
+      std::string* p = allocString.allocate(1);
+      // verify
+      assertUnit(allocString == alloc);
+      assertUnit(allocBack == alloc);
+      assertUnit(allocString.pPool == alloc.pPool);
+      assertUnit(allocBack.pSlabs == alloc.pSlabs);
+      assertUnit(allocString.pSlabs != alloc.pSlabs);   // a string slot is not an int slot
+      assertUnit(allocString.capacity() == 32);
+      assertUnit(alloc.capacity() == 0);
+      assertUnit(alloc.release() == false);            // still shared
+      // teardown
+      allocString.deallocate(p, 1);
+   }
+
+   /***************************************
+    * BST
+    ***************************************/
+
+   // clear() gives every slab back at once
+   void test_bst_insertClear()
+   {  // setup
+      custom::BST<int, custom::slab_allocator<int>> bst;
+      for (int i = 0; i < 1000; i++)
+         bst.insert((i * 7) % 1000);
+      assertUnit(bst.alloc.capacity() >= 1000);
+      // exercise
+      bst.clear();
+      // verify
+      assertUnit(bst.root == nullptr);
+      assertUnit(bst.numElements == 0);
+      assertUnit(bst.alloc.capacity() == 0);
+      bst.insert(99);
+      assertUnit(bst.size() == 1);
+   }  // teardown
+
+   // clear() still runs every destructor before releasing
+   void test_bst_clearSpy()
+   {  // setup
+      custom::BST<Spy, custom::slab_allocator<Spy>> bst;
+      bst.insert(Spy(50));
+      bst.insert(Spy(30));
+      bst.insert(Spy(70));
+      Spy::reset();
+      // exercise
+      bst.clear();
+      // verify
+      assertUnit(Spy::numDestructor() == 3);
+      assertUnit(Spy::numDelete() == 3);
+      assertUnit(bst.alloc.capacity() == 0);
+   }  // teardown
+
+   // nodes built from a sorted range sit in order in one slab
+   void test_bst_sortedContiguous()
+   {  // setup
+      std::vector<int> v{ 10, 20, 30, 40, 50, 60, 70 };
+      // exercise
+      custom::BST<int, custom::slab_allocator<int>> bst(custom::sorted_range, v.begin(), v.end());
+      // verify
+      assertUnit(bst.isRedBlack());
+      bool inOrder = true;
+      auto itPrev = bst.begin();
+      for (auto it = ++bst.begin(); it != bst.end(); itPrev = it++)
+         inOrder = inOrder && it.pNode == itPrev.pNode + 1;
+      assertUnit(inOrder);
+   }  // teardown
+
+   // a copy gets its own pool so either can release without the other
+   void test_bst_copyOwnPool()
+   {  // setup
+      custom::BST<int, custom::slab_allocator<int>> bstSrc;
+      for (int i = 0; i < 10; i++)
+         bstSrc.insert(i);
+      // exercise
+      custom::BST<int, custom::slab_allocator<int>> bstDes(bstSrc);
+      bstSrc.clear();
+      // verify
+      assertUnit(bstDes.alloc != bstSrc.alloc);
+      assertUnit(bstDes.size() == 10);
+      assertUnit(bstDes.isRedBlack());
+      int expect = 0;
+      for (auto it = bstDes.begin(); it != bstDes.end(); ++it, ++expect)
+         if (*it != expect)
+            break;
+      assertUnit(expect == 10);
+   }  // teardown
+
+   // swapping trees swaps the pools with them
+   void test_bst_swap()
+   {  // setup
+      custom::BST<int, custom::slab_allocator<int>> bst1;
+      custom::BST<int, custom::slab_allocator<int>> bst2;
+      bst1.insert(1);
+      auto alloc1 = bst1.alloc;
+      auto alloc2 = bst2.alloc;
+      // exercise
+      bst1.swap(bst2);
+      // verify
+      assertUnit(bst2.alloc == alloc1);
+      assertUnit(bst1.alloc == alloc2);
+      assertUnit(bst2.size() == 1);
+      assertUnit(bst1.empty());
+   }  // teardown
+
+   // a node handle keeps the slabs its node lives in
+   void test_bst_extractKeepsPool()
+   {  // setup
+      custom::BST<int, custom::slab_allocator<int>> bst;
+      for (int i = 0; i < 10; i++)
+         bst.insert(i);
+      // exercise
+      auto nh = bst.extract(bst.find(5));
+      bst.clear();
+      // verify
+      assertUnit(bst.alloc.capacity() > 0);
+      assertUnit(nh.value() == 5);
+   }  // teardown
+
+   // nodes from another pool are copied, and the originals go back
+   void test_bst_mergeOtherPool()
+   {  // setup
+      custom::BST<int, custom::slab_allocator<int>> bst;
+      custom::BST<int, custom::slab_allocator<int>> bstRhs;
+      for (int i = 0; i < 10; i += 2)
+         bst.insert(i);
+      for (int i = 0; i < 10; i++)
+         bstRhs.insert(i);
+      // exercise
+      bst.merge(bstRhs);
+      // verify
+      assertUnit(bst.alloc != bstRhs.alloc);
+      assertUnit(bst.size() == 10);
+      assertUnit(bstRhs.size() == 5);
+      assertUnit(bst.isRedBlack());
+      assertUnit(bstRhs.isRedBlack());
+      int expect = 0;
+      for (auto it = bstRhs.begin(); it != bstRhs.end(); ++it, expect += 2)
+         if (*it != expect)
+            break;
+      assertUnit(expect == 10);
+   }  // teardown
+
+   // an allocator that does not follow a move keeps its own nodes: the
+   // values move into them and the source's nodes go back to its pool
+   void test_bst_moveAssignStays()
+   {  // setup
+      custom::BST<Spy, stay_allocator<Spy>> bstSrc;
+      custom::BST<Spy, stay_allocator<Spy>> bstDes;
+      bstSrc.insert(Spy(50));
+      bstSrc.insert(Spy(30));
+      bstSrc.insert(Spy(70));
+      auto allocDes = bstDes.alloc;
+      Spy::reset();
+      // exercise
+      bstDes = std::move(bstSrc);
+      // verify
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 3);
+      assertUnit(bstDes.alloc == allocDes);
+      assertUnit(bstDes.alloc != bstSrc.alloc);
+      assertUnit(bstDes.size() == 3);
+      assertUnit(bstDes.isRedBlack());
+      assertUnit(bstSrc.empty());
+      assertUnit(bstDes.alloc.capacity() >= 3);
+   }  // teardown
+
+   /***************************************
+    * MAP
+    ***************************************/
+
+   // a map can keep its nodes in a slab too
+   void test_map_squareBracket()
+   {  // setup
+      custom::map<int, int, custom::slab_allocator<custom::pair<int, int>>> m;
+      // exercise
+      for (int i = 0; i < 100; i++)
+         m[i] = i * 10;
+      // verify
+      assertUnit(m.size() == 100);
+      assertUnit(m[42] == 420);
+      assertUnit(m.bst.alloc.capacity() >= 100);
+      m.clear();
+      assertUnit(m.bst.alloc.capacity() == 0);
+   }  // teardown
+
+   // maps built from one allocator share its pool, so merge hands the
+   // nodes over rather than copying what is in them
+   void test_map_mergeSamePool()
+   {  // setup
+      custom::slab_allocator<custom::pair<int, Spy>> alloc;
+      custom::map<int, Spy, custom::slab_allocator<custom::pair<int, Spy>>> m(alloc);
+      custom::map<int, Spy, custom::slab_allocator<custom::pair<int, Spy>>> mRhs(alloc);
+      for (int i = 0; i < 10; i += 2)
+         m[i] = Spy(i);
+      for (int i = 1; i < 10; i += 2)
+         mRhs[i] = Spy(i);
+      auto p5 = &*mRhs.find(5);
+      Spy::reset();
+      // exercise
+      m.merge(mRhs);
+      // verify
+      assertUnit(m.bst.alloc == mRhs.bst.alloc);
+      assertUnit(m.bst.alloc == alloc);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(&*m.find(5) == p5);              // the same node
+      assertUnit(m.size() == 10);
+      assertUnit(mRhs.empty());
+      assertUnit(m.bst.isRedBlack());
+   }  // teardown
+
+private:
+   // a slab allocator that stays with its container on move assignment
+   template <class T>
+   struct stay_allocator : public custom::slab_allocator<T>
+   {
+      typedef std::false_type propagate_on_container_move_assignment;
+
+      stay_allocator() {}
+      template <class U>
+      stay_allocator(const stay_allocator<U>& rhs) : custom::slab_allocator<T>(rhs) {}
+      stay_allocator select_on_container_copy_construction() const { return stay_allocator(); }
+   };
+};
+
+#endif // DEBUG
@@ -0,0 +1,306 @@
+/***********************************************************************
+ * Header:
+ *    TEST STATIC SET
+ * Summary:
+ *    Unit tests for static_set, static_map, and freeze()
+ * Author
+ *    Gabe Lytle, M. Scott O'Connor
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "staticSet.h"
+#include "unitTest.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+class TestStaticSet : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Set
+      test_construct_default();
+      test_construct_sorted();
+      test_construct_unsorted();
+      test_iterate_forward();
+      test_iterate_backward();
+      test_find_standard();
+      test_find_empty();
+      test_lowerBound_everywhere();
+      test_upperBound_everywhere();
+
+      // Freeze
+      test_freeze_bst();
+      test_freeze_vector();
+      test_freeze_map();
+
+      // Map
+      test_map_at();
+      test_map_findCString();
+
+      report("StaticSet");
+   }
+
+   /***************************************
+    * SET
+    ***************************************/
+
+   // an empty set finds nothing
+   void test_construct_default()
+   {  // setup
+      // exercise
+      custom::static_set <int> s;
+      // verify
+      assertUnit(s.empty());
+      assertUnit(s.size() == 0);
+      assertUnit(s.begin() == s.end());
+      assertUnit(s.find(11) == s.end());
+      assertUnit(s.lower_bound(11) == s.end());
+   }  // teardown
+
+   // a full tree of seven is stored root first, a level at a time
+   //                 4
+   //           2           6
+   //        1     3     5     7
+   void test_construct_sorted()
+   {  // setup
+      std::vector <int> v{ 1, 2, 3, 4, 5, 6, 7 };
+      // exercise
+      custom::static_set <int> s(custom::sorted_range, v.begin(), v.end());
+      // verify
+      assertUnit(s.size() == 7);
+      assertUnit(s.values == std::vector <int>({ 4, 2, 6, 1, 3, 5, 7 }));
+   }  // teardown
+
+   // values in any order are sorted and duplicates dropped
+   //                 26
+   //           11          31
+   void test_construct_unsorted()
+   {  // setup
+      // exercise
+      custom::static_set <int> s{ 31, 11, 26, 11, 31 };
+      // verify
+      assertUnit(s.size() == 3);
+      assertUnit(s.values == std::vector <int>({ 26, 11, 31 }));
+   }  // teardown
+
+   // in order through a tree whose last level is not full
+   void test_iterate_forward()
+   {  // setup
+      std::vector <int> v;
+      for (int i = 0; i < 10; i++)
+         v.push_back(i * 10);
+      custom::static_set <int> s(custom::sorted_range, v.begin(), v.end());
+      std::vector <int> seen;
+      // exercise
+      for (auto it = s.begin(); it != s.end(); ++it)
+         seen.push_back(*it);
+      // verify
+      assertUnit(seen == v);
+   }  // teardown
+
+   // backward from end() visits everything in reverse
+   void test_iterate_backward()
+   {  // setup
+      std::vector <int> v;
+      for (int i = 0; i < 10; i++)
+         v.push_back(i * 10);
+      custom::static_set <int> s(custom::sorted_range, v.begin(), v.end());
+      std::vector <int> seen;
+      // exercise
+      auto it = s.end();
+      while (it != s.begin())
+         seen.push_back(*--it);
+      // verify
+      std::reverse(seen.begin(), seen.end());
+      assertUnit(seen == v);
+   }  // teardown
+
+   // find what is there and only what is there
+   void test_find_standard()
+   {  // setup
+      std::vector <int> v;
+      for (int i = 0; i < 1000; i += 2)
+         v.push_back(i);
+      custom::static_set <int> s(custom::sorted_range, v.begin(), v.end());
+      // exercise
+      auto it500 = s.find(500);
+      auto it501 = s.find(501);
+      // verify
+      assertUnit(it500 != s.end() && *it500 == 500);
+      assertUnit(it501 == s.end());
+      assertUnit(s.find(-1) == s.end());
+      assertUnit(s.find(1000) == s.end());
+      assertUnit(s.count(0) == 1);
+      assertUnit(s.count(998) == 1);
+      assertUnit(s.count(999) == 0);
+   }  // teardown
+
+   // a set of one has nothing to search either side
+   void test_find_empty()
+   {  // setup
+      custom::static_set <int> s{ 26 };
+      // exercise
+      auto itFound = s.find(26);
+      // verify
+      assertUnit(itFound == s.begin());
+      assertUnit(*itFound == 26);
+      assertUnit(s.find(11) == s.end());
+      assertUnit(s.find(31) == s.end());
+      assertUnit(s.lower_bound(11) == s.begin());
+      assertUnit(s.lower_bound(31) == s.end());
+   }  // teardown
+
+   // lower_bound agrees with std::lower_bound for every size up to
+   // a few levels and every key in and around the values
+   void test_lowerBound_everywhere()
+   {  // setup
+      bool agree = true;
+      for (int num = 0; num <= 40; num++)
+      {
+         std::vector <int> v;
+         for (int i = 0; i < num; i++)
+            v.push_back(i * 2 + 1);
+         custom::static_set <int> s(custom::sorted_range, v.begin(), v.end());
+         // exercise
+         for (int k = -1; k <= num * 2 + 1; k++)
+         {
+            auto itExpect = std::lower_bound(v.begin(), v.end(), k);
+            auto it = s.lower_bound(k);
+            // verify
+            if (itExpect == v.end() ? it != s.end() : it == s.end() || *it != *itExpect)
+               agree = false;
+         }
+      }
+      assertUnit(agree);
+   }  // teardown
+
+   // upper_bound agrees with std::upper_bound the same way
+   void test_upperBound_everywhere()
+   {  // setup
+      bool agree = true;
+      for (int num = 0; num <= 40; num++)
+      {
+         std::vector <int> v;
+         for (int i = 0; i < num; i++)
+            v.push_back(i * 2 + 1);
+         custom::static_set <int> s(custom::sorted_range, v.begin(), v.end());
+         // exercise
+         for (int k = -1; k <= num * 2 + 1; k++)
+         {
+            auto itExpect = std::upper_bound(v.begin(), v.end(), k);
+            auto it = s.upper_bound(k);
+            // verify
+            if (itExpect == v.end() ? it != s.end() : it == s.end() || *it != *itExpect)
+               agree = false;
+         }
+      }
+      assertUnit(agree);
+   }  // teardown
+
+   /***************************************
+    * FREEZE
+    ***************************************/
+
+   // a BST with duplicates freezes into a set of each value once
+   void test_freeze_bst()
+   {  // setup
+      custom::BST <int> bst;
+      for (int i = 0; i < 100; i++)
+         bst.insert((i * 37) % 50);
+      // exercise
+      custom::static_set <int> s = custom::freeze(bst);
+      // verify
+      assertUnit(s.size() == 50);
+      assertUnit(bst.size() == 100);
+      int expect = 0;
+      for (auto it = s.begin(); it != s.end(); ++it, ++expect)
+         if (*it != expect)
+            break;
+      assertUnit(expect == 50);
+   }  // teardown
+
+   // a sorted vector freezes without sorting again
+   void test_freeze_vector()
+   {  // setup
+      std::vector <int> v{ 11, 26, 31 };
+      // exercise
+      custom::static_set <int> s = custom::freeze(custom::sorted_range, v);
+      // verify
+      assertUnit(s.values == std::vector <int>({ 26, 11, 31 }));
+      assertUnit(v == std::vector <int>({ 11, 26, 31 }));
+   }  // teardown
+
+   // a map freezes into a map of the same pairs
+   void test_freeze_map()
+   {  // setup
+      custom::map <int, std::string> m;
+      m[31] = "thirty-one";
+      m[11] = "eleven";
+      m[26] = "twenty-six";
+      // exercise
+      custom::static_map <int, std::string> sm = custom::freeze(m);
+      // verify
+      assertUnit(sm.size() == 3);
+      assertUnit(sm.values[0].first == 26);
+      assertUnit(sm.values[1].first == 11);
+      assertUnit(sm.values[2].first == 31);
+      assertUnit(sm.find(11)->second == std::string("eleven"));
+      assertUnit(sm.find(12) == sm.end());
+      assertUnit(m.size() == 3);
+   }  // teardown
+
+   /***************************************
+    * MAP
+    ***************************************/
+
+   // at() finds a key or throws, keeping the first of equal keys
+   void test_map_at()
+   {  // setup
+      custom::static_map <int, int> sm{ custom::pair <int, int>(26, 260),
+                                        custom::pair <int, int>(11, 110),
+                                        custom::pair <int, int>(26, 999) };
+      bool thrown = false;
+      // exercise
+      int value11 = sm.at(11);
+      int value26 = sm.at(26);
+      try
+      {
+         sm.at(31);
+      }
+      catch (const std::out_of_range& error)
+      {
+         thrown = true;
+      }
+      // verify
+      assertUnit(sm.size() == 2);
+      assertUnit(value11 == 110);
+      assertUnit(value26 == 260);
+      assertUnit(thrown);
+   }  // teardown
+
+   // a string key is found from a C string without building a string
+   void test_map_findCString()
+   {  // setup
+      custom::static_map <std::string, int> sm{
+         custom::pair <std::string, int>("eleven", 11),
+         custom::pair <std::string, int>("twenty-six", 26) };
+      // exercise
+      auto it = sm.find("twenty-six");
+      // verify
+      assertUnit(it != sm.end());
+      assertUnit(it->second == 26);
+      assertUnit(sm.find("thirty-one") == sm.end());
+      assertUnit(sm.lower_bound("f")->first == std::string("twenty-six"));
+   }  // teardown
+};
+
+#endif // DEBUG